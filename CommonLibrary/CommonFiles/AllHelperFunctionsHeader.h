@@ -1,4 +1,10 @@
 #pragma once
+#include "SimdMath.h"
+#include "BatchTransforms.h"
+#include "ObjParser.h"
+#include "VertexFormats.h"
+#include "BoundingVolumeHierarchy.h"
+#include "TextureContainers.h"
 #include "../VulkanHelperFunctions/InstanceAndDevice.h"
 #include "../VulkanHelperFunctions/ImagePresentFunctions.h"
 #include "../VulkanHelperFunctions/CommandBufferAndSyncFunctions.h"
@@ -7,4 +13,19 @@
 #include "../VulkanHelperFunctions/RenderPassAndFramebufferFunctions.h"
 #include "../VulkanHelperFunctions/GraphicsAndComputePipeFunctions.h"
 #include "../VulkanHelperFunctions/CommandRecordingAndDrawing.h"
+#include "../VulkanHelperFunctions/CommandBufferCache.h"
+#include "../VulkanHelperFunctions/IndirectDrawBatcher.h"
+#include "../VulkanHelperFunctions/InstancedDrawBatcher.h"
+#include "../VulkanHelperFunctions/GpuFrustumCulling.h"
+#include "../VulkanHelperFunctions/MipmapGenerator.h"
+#include "../VulkanHelperFunctions/TextureStreamer.h"
+#include "../VulkanHelperFunctions/MemoryBudget.h"
+#include "../VulkanHelperFunctions/DeviceRegistry.h"
+#include "../VulkanHelperFunctions/TransientAttachmentPool.h"
+#include "../VulkanHelperFunctions/RenderGraph.h"
+#include "../VulkanHelperFunctions/BarrierBatcher.h"
+#include "../VulkanHelperFunctions/ResourceStateTracker.h"
+#include "../VulkanHelperFunctions/QueueTimeline.h"
+#include "../VulkanHelperFunctions/SyncObjectPools.h"
+#include "../VulkanHelperFunctions/DeferredDestructionQueue.h"
 
@@ -0,0 +1,177 @@
+#include "BatchTransforms.h"
+
+#if defined(SIMD_MATH_AVX2)
+#include <immintrin.h>
+#elif defined(SIMD_MATH_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		size_t const MinimalVectorsPerThread = 16384;
+		size_t const MinimalMatricesPerThread = 4096;
+
+		// Splits range into chunks aligned to the widest SIMD width, so only the last chunk processes a scalar remainder
+		void ProcessInParallel(size_t count, size_t minimalElementsPerThread, std::function<void(size_t, size_t)> const &function)
+		{
+			size_t threadsCount = std::thread::hardware_concurrency();
+			size_t maxUsefulThreadsCount = count / minimalElementsPerThread;
+			threadsCount = threadsCount > maxUsefulThreadsCount ? maxUsefulThreadsCount : threadsCount;
+			if (threadsCount <= 1)
+			{
+				function(0, count);
+				return;
+			}
+
+			size_t chunkSize = ((count + threadsCount - 1) / threadsCount + 7) & ~static_cast<size_t>(7);
+			std::vector<std::thread> threads;
+			for (size_t begin = chunkSize; begin < count; begin += chunkSize)
+			{
+				size_t end = begin + chunkSize;
+				threads.emplace_back(function, begin, end > count ? count : end);
+			}
+			function(0, chunkSize > count ? count : chunkSize);
+
+			for (auto & thread : threads)
+			{
+				thread.join();
+			}
+		}
+
+		template<bool Translate>
+		void TransformStreams(Matrix4x4 const &matrix, ConstVector3Streams const &vectors, Vector3Streams const &results, size_t begin, size_t end, bool normalize)
+		{
+			float const *m = matrix.data();
+			float const tx = Translate ? m[12] : 0.0f;
+			float const ty = Translate ? m[13] : 0.0f;
+			float const tz = Translate ? m[14] : 0.0f;
+
+			size_t i = begin;
+#if defined(SIMD_MATH_AVX2)
+			__m256 const m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]), m2 = _mm256_set1_ps(m[2]);
+			__m256 const m4 = _mm256_set1_ps(m[4]), m5 = _mm256_set1_ps(m[5]), m6 = _mm256_set1_ps(m[6]);
+			__m256 const m8 = _mm256_set1_ps(m[8]), m9 = _mm256_set1_ps(m[9]), m10 = _mm256_set1_ps(m[10]);
+			__m256 const t0 = _mm256_set1_ps(tx), t1 = _mm256_set1_ps(ty), t2 = _mm256_set1_ps(tz);
+			for (; i + 8 <= end; i += 8)
+			{
+				__m256 x = _mm256_loadu_ps(vectors.m_X + i);
+				__m256 y = _mm256_loadu_ps(vectors.m_Y + i);
+				__m256 z = _mm256_loadu_ps(vectors.m_Z + i);
+				__m256 rx = _mm256_fmadd_ps(m0, x, _mm256_fmadd_ps(m4, y, _mm256_fmadd_ps(m8, z, t0)));
+				__m256 ry = _mm256_fmadd_ps(m1, x, _mm256_fmadd_ps(m5, y, _mm256_fmadd_ps(m9, z, t1)));
+				__m256 rz = _mm256_fmadd_ps(m2, x, _mm256_fmadd_ps(m6, y, _mm256_fmadd_ps(m10, z, t2)));
+				if (normalize)
+				{
+					__m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(rx, rx, _mm256_fmadd_ps(ry, ry, _mm256_mul_ps(rz, rz))));
+					rx = _mm256_div_ps(rx, length);
+					ry = _mm256_div_ps(ry, length);
+					rz = _mm256_div_ps(rz, length);
+				}
+				_mm256_storeu_ps(results.m_X + i, rx);
+				_mm256_storeu_ps(results.m_Y + i, ry);
+				_mm256_storeu_ps(results.m_Z + i, rz);
+			}
+#elif defined(SIMD_MATH_SSE2)
+			__m128 const m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]), m2 = _mm_set1_ps(m[2]);
+			__m128 const m4 = _mm_set1_ps(m[4]), m5 = _mm_set1_ps(m[5]), m6 = _mm_set1_ps(m[6]);
+			__m128 const m8 = _mm_set1_ps(m[8]), m9 = _mm_set1_ps(m[9]), m10 = _mm_set1_ps(m[10]);
+			__m128 const t0 = _mm_set1_ps(tx), t1 = _mm_set1_ps(ty), t2 = _mm_set1_ps(tz);
+			for (; i + 4 <= end; i += 4)
+			{
+				__m128 x = _mm_loadu_ps(vectors.m_X + i);
+				__m128 y = _mm_loadu_ps(vectors.m_Y + i);
+				__m128 z = _mm_loadu_ps(vectors.m_Z + i);
+				__m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)), _mm_add_ps(_mm_mul_ps(m8, z), t0));
+				__m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)), _mm_add_ps(_mm_mul_ps(m9, z), t1));
+				__m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m6, y)), _mm_add_ps(_mm_mul_ps(m10, z), t2));
+				if (normalize)
+				{
+					__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_mul_ps(rz, rz)));
+					rx = _mm_div_ps(rx, length);
+					ry = _mm_div_ps(ry, length);
+					rz = _mm_div_ps(rz, length);
+				}
+				_mm_storeu_ps(results.m_X + i, rx);
+				_mm_storeu_ps(results.m_Y + i, ry);
+				_mm_storeu_ps(results.m_Z + i, rz);
+			}
+#endif
+			for (; i < end; ++i)
+			{
+				float const x = vectors.m_X[i];
+				float const y = vectors.m_Y[i];
+				float const z = vectors.m_Z[i];
+				float rx = m[0] * x + m[4] * y + m[8] * z + tx;
+				float ry = m[1] * x + m[5] * y + m[9] * z + ty;
+				float rz = m[2] * x + m[6] * y + m[10] * z + tz;
+				if (normalize)
+				{
+					float length = std::sqrt(rx * rx + ry * ry + rz * rz);
+					rx /= length;
+					ry /= length;
+					rz /= length;
+				}
+				results.m_X[i] = rx;
+				results.m_Y[i] = ry;
+				results.m_Z[i] = rz;
+			}
+		}
+	}
+
+	void TransformPointStreams(Matrix4x4 const &matrix, ConstVector3Streams const &points, Vector3Streams const &results, size_t count)
+	{
+		ProcessInParallel(count, MinimalVectorsPerThread, [&](size_t begin, size_t end)
+		{
+			TransformStreams<true>(matrix, points, results, begin, end, false);
+		});
+	}
+
+	void TransformNormalStreams(Matrix4x4 const &normalMatrix, ConstVector3Streams const &normals, Vector3Streams const &results, size_t count, bool normalize)
+	{
+		ProcessInParallel(count, MinimalVectorsPerThread, [&](size_t begin, size_t end)
+		{
+			TransformStreams<false>(normalMatrix, normals, results, begin, end, normalize);
+		});
+	}
+
+	void MultiplyMatrixArrays(AlignedMatrix4x4 const *left, AlignedMatrix4x4 const *right, AlignedMatrix4x4 *results, size_t count)
+	{
+		ProcessInParallel(count, MinimalMatricesPerThread, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				MultiplyMatrices(left[i], right[i], results[i]);
+			}
+		});
+	}
+
+	void PrepareWorldViewProjectionMatrices(AlignedMatrix4x4 const &viewProjectionMatrix, AlignedMatrix4x4 const *worldMatrices,
+		AlignedMatrix4x4 *results, size_t count)
+	{
+		ProcessInParallel(count, MinimalMatricesPerThread, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				MultiplyMatrices(viewProjectionMatrix, worldMatrices[i], results[i]);
+			}
+		});
+	}
+
+	void ConcatenateHierarchyTransforms(AlignedMatrix4x4 const *localMatrices, int32_t const *parentIndices, AlignedMatrix4x4 *worldMatrices, size_t count)
+	{
+		// Every node depends on the already computed world matrix of its parent, so nodes are processed in order on the calling thread
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (parentIndices[i] < 0)
+			{
+				worldMatrices[i] = localMatrices[i];
+			}
+			else
+			{
+				MultiplyMatrices(worldMatrices[parentIndices[i]], localMatrices[i], worldMatrices[i]);
+			}
+		}
+	}
+}
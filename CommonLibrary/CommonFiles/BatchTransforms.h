@@ -0,0 +1,35 @@
+#pragma once
+#include "SimdMath.h"
+
+namespace VulkanSampleFramework
+{
+	// Structure of arrays stream of vectors, each component is stored in a separate array
+	struct Vector3Streams
+	{
+		float *m_X;
+		float *m_Y;
+		float *m_Z;
+	};
+
+	struct ConstVector3Streams
+	{
+		float const *m_X;
+		float const *m_Y;
+		float const *m_Z;
+	};
+
+	// Kernels process 8 (AVX2) or 4 (SSE) elements at once. Arrays larger than a few thousand elements are split between threads,
+	// the calling thread processes one of the chunks. Results may alias inputs.
+
+	void TransformPointStreams(Matrix4x4 const &matrix, ConstVector3Streams const &points, Vector3Streams const &results, size_t count);
+	// Only the upper 3x3 part of the matrix is used, pass the inverse transpose of a transformation containing non-uniform scale
+	void TransformNormalStreams(Matrix4x4 const &normalMatrix, ConstVector3Streams const &normals, Vector3Streams const &results, size_t count, bool normalize);
+
+	// results[i] = left[i] * right[i], e.g. parent transformation concatenated with local transformations
+	void MultiplyMatrixArrays(AlignedMatrix4x4 const *left, AlignedMatrix4x4 const *right, AlignedMatrix4x4 *results, size_t count);
+	// results[i] = viewProjection * world[i]
+	void PrepareWorldViewProjectionMatrices(AlignedMatrix4x4 const &viewProjectionMatrix, AlignedMatrix4x4 const *worldMatrices,
+		AlignedMatrix4x4 *results, size_t count);
+	// Parents have to precede their children, roots use a negative parent index
+	void ConcatenateHierarchyTransforms(AlignedMatrix4x4 const *localMatrices, int32_t const *parentIndices, AlignedMatrix4x4 *worldMatrices, size_t count);
+}
@@ -0,0 +1,422 @@
+#include <algorithm>
+#include <cfloat>
+#include "BoundingVolumeHierarchy.h"
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		uint32_t const BinsCount = 16;
+		uint32_t const MaxLeafObjectsCount = 4;
+		uint32_t const MinimalObjectsPerThread = 4096;
+
+		BoundingBox const EmptyBoundingBox = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+
+		void ExtendBoundingBox(BoundingBox &box, BoundingBox const &other)
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				box.m_Min[i] = other.m_Min[i] < box.m_Min[i] ? other.m_Min[i] : box.m_Min[i];
+				box.m_Max[i] = other.m_Max[i] > box.m_Max[i] ? other.m_Max[i] : box.m_Max[i];
+			}
+		}
+
+		void ExtendBoundingBox(BoundingBox &box, Vector3 const &point)
+		{
+			ExtendBoundingBox(box, { point, point });
+		}
+
+		float GetSurfaceArea(BoundingBox const &box)
+		{
+			Vector3 size = box.m_Max - box.m_Min;
+			if ((size[0] < 0.0f) || (size[1] < 0.0f) || (size[2] < 0.0f))
+			{
+				return 0.0f;
+			}
+			return 2.0f * (size[0] * size[1] + size[1] * size[2] + size[2] * size[0]);
+		}
+
+		enum class FrustumTestResult
+		{
+			Outside,
+			Intersecting,
+			Inside
+		};
+
+		FrustumTestResult TestBoundingBoxAgainstFrustum(BoundingBox const &box, std::array<Vector4, 6> const &planes)
+		{
+			FrustumTestResult result = FrustumTestResult::Inside;
+			for (auto & plane : planes)
+			{
+				// Corners farthest along and against the plane normal
+				Vector3 positive;
+				Vector3 negative;
+				for (int i = 0; i < 3; ++i)
+				{
+					positive[i] = plane[i] >= 0.0f ? box.m_Max[i] : box.m_Min[i];
+					negative[i] = plane[i] >= 0.0f ? box.m_Min[i] : box.m_Max[i];
+				}
+				if (plane[0] * positive[0] + plane[1] * positive[1] + plane[2] * positive[2] + plane[3] < 0.0f)
+				{
+					return FrustumTestResult::Outside;
+				}
+				if (plane[0] * negative[0] + plane[1] * negative[1] + plane[2] * negative[2] + plane[3] < 0.0f)
+				{
+					result = FrustumTestResult::Intersecting;
+				}
+			}
+			return result;
+		}
+	}
+
+	BoundingBox TransformBoundingBox(BoundingBox const &box, Matrix4x4 const &matrix)
+	{
+		BoundingBox result = { { matrix[12], matrix[13], matrix[14] }, { matrix[12], matrix[13], matrix[14] } };
+		for (int row = 0; row < 3; ++row)
+		{
+			for (int column = 0; column < 3; ++column)
+			{
+				float a = matrix[4 * column + row] * box.m_Min[column];
+				float b = matrix[4 * column + row] * box.m_Max[column];
+				result.m_Min[row] += a < b ? a : b;
+				result.m_Max[row] += a < b ? b : a;
+			}
+		}
+		return result;
+	}
+
+	bool IntersectRayWithBoundingBox(Ray const &ray, BoundingBox const &box, float maxDistance, float &distance)
+	{
+		float entry = 0.0f;
+		float exit = maxDistance;
+		for (int i = 0; i < 3; ++i)
+		{
+			float inverseDirection = 1.0f / ray.m_Direction[i];
+			float first = (box.m_Min[i] - ray.m_Origin[i]) * inverseDirection;
+			float second = (box.m_Max[i] - ray.m_Origin[i]) * inverseDirection;
+			if (first > second)
+			{
+				std::swap(first, second);
+			}
+			entry = first > entry ? first : entry;
+			exit = second < exit ? second : exit;
+			if (entry > exit)
+			{
+				return false;
+			}
+		}
+		distance = entry;
+		return true;
+	}
+
+	void BoundingVolumeHierarchy::Build(std::vector<BoundingBox> const &objectBounds)
+	{
+		uint32_t objectsCount = static_cast<uint32_t>(objectBounds.size());
+		m_ObjectBounds = objectBounds;
+		m_Objects.resize(objectsCount);
+		for (uint32_t i = 0; i < objectsCount; ++i)
+		{
+			m_Objects[i] = i;
+		}
+		m_Nodes.clear();
+		if (0 == objectsCount)
+		{
+			return;
+		}
+
+		std::vector<Vector3> centroids(objectsCount);
+		for (uint32_t i = 0; i < objectsCount; ++i)
+		{
+			centroids[i] = 0.5f * (objectBounds[i].m_Min + objectBounds[i].m_Max);
+		}
+
+		// Binary tree never has more than 2N - 1 nodes, so nodes can be allocated from multiple threads without reallocations
+		m_Nodes.resize(2 * objectsCount - 1);
+		m_UsedNodesCount = 1;
+		uint32_t parallelDepth = 0;
+		for (uint32_t threadsCount = std::thread::hardware_concurrency(); threadsCount > 1; threadsCount = (threadsCount + 1) / 2)
+		{
+			++parallelDepth;
+		}
+		BuildNode(0, 0, objectsCount, objectBounds, centroids, parallelDepth);
+		m_Nodes.resize(m_UsedNodesCount);
+	}
+
+	void BoundingVolumeHierarchy::Refit(std::vector<BoundingBox> const &objectBounds)
+	{
+		m_ObjectBounds = objectBounds;
+
+		// Children are always allocated after their parents, so iterating backwards visits children first
+		for (size_t i = m_Nodes.size(); i > 0; --i)
+		{
+			Node &node = m_Nodes[i - 1];
+			node.m_Bounds = EmptyBoundingBox;
+			if (0 == node.m_ObjectsCount)
+			{
+				ExtendBoundingBox(node.m_Bounds, m_Nodes[node.m_FirstChildOrObject].m_Bounds);
+				ExtendBoundingBox(node.m_Bounds, m_Nodes[node.m_FirstChildOrObject + 1].m_Bounds);
+			}
+			else
+			{
+				for (uint32_t object = node.m_FirstChildOrObject; object < node.m_FirstChildOrObject + node.m_ObjectsCount; ++object)
+				{
+					ExtendBoundingBox(node.m_Bounds, objectBounds[m_Objects[object]]);
+				}
+			}
+		}
+	}
+
+	void BoundingVolumeHierarchy::QueryFrustum(std::array<Vector4, 6> const &planes, std::vector<uint32_t> &visibleObjects) const
+	{
+		visibleObjects.clear();
+		if (m_Nodes.empty())
+		{
+			return;
+		}
+
+		std::vector<uint32_t> stack = { 0 };
+		while (!stack.empty())
+		{
+			uint32_t nodeIndex = stack.back();
+			stack.pop_back();
+			Node const &node = m_Nodes[nodeIndex];
+
+			FrustumTestResult result = TestBoundingBoxAgainstFrustum(node.m_Bounds, planes);
+			if (FrustumTestResult::Outside == result)
+			{
+				continue;
+			}
+			// Subtrees completely inside the frustum don't have to be tested any further
+			if (FrustumTestResult::Inside == result)
+			{
+				CollectObjects(nodeIndex, visibleObjects);
+				continue;
+			}
+			// Objects of leaves crossing the frustum are tested separately, they may be outside even when the leaf isn't
+			if (0 < node.m_ObjectsCount)
+			{
+				for (uint32_t object = node.m_FirstChildOrObject; object < node.m_FirstChildOrObject + node.m_ObjectsCount; ++object)
+				{
+					if (FrustumTestResult::Outside != TestBoundingBoxAgainstFrustum(m_ObjectBounds[m_Objects[object]], planes))
+					{
+						visibleObjects.push_back(m_Objects[object]);
+					}
+				}
+				continue;
+			}
+			stack.push_back(node.m_FirstChildOrObject);
+			stack.push_back(node.m_FirstChildOrObject + 1);
+		}
+	}
+
+	bool BoundingVolumeHierarchy::QueryClosestRayHit(Ray const &ray, float maxDistance, uint32_t &object, float &distance,
+		std::function<bool(uint32_t object, Ray const &ray, float &distance)> const &intersectObject/* = nullptr*/) const
+	{
+		float nodeDistance;
+		if (m_Nodes.empty() || !IntersectRayWithBoundingBox(ray, m_Nodes[0].m_Bounds, maxDistance, nodeDistance))
+		{
+			return false;
+		}
+
+		bool hit = false;
+		float closestDistance = maxDistance;
+		std::vector<std::pair<uint32_t, float>> stack = { { 0, nodeDistance } };
+		while (!stack.empty())
+		{
+			auto entry = stack.back();
+			stack.pop_back();
+			if (entry.second > closestDistance)
+			{
+				continue;
+			}
+
+			Node const &node = m_Nodes[entry.first];
+			if (0 < node.m_ObjectsCount)
+			{
+				for (uint32_t i = node.m_FirstChildOrObject; i < node.m_FirstChildOrObject + node.m_ObjectsCount; ++i)
+				{
+					float objectDistance;
+					bool objectHit = intersectObject ? intersectObject(m_Objects[i], ray, objectDistance) :
+						IntersectRayWithBoundingBox(ray, m_ObjectBounds[m_Objects[i]], closestDistance, objectDistance);
+					if (objectHit && (objectDistance <= closestDistance))
+					{
+						hit = true;
+						closestDistance = objectDistance;
+						object = m_Objects[i];
+					}
+				}
+				continue;
+			}
+
+			// Nearer child is visited first, so farther subtrees are usually skipped
+			float distances[2];
+			bool hits[2];
+			for (uint32_t child = 0; child < 2; ++child)
+			{
+				hits[child] = IntersectRayWithBoundingBox(ray, m_Nodes[node.m_FirstChildOrObject + child].m_Bounds, closestDistance, distances[child]);
+			}
+			uint32_t nearer = (hits[0] && hits[1] && (distances[1] < distances[0])) || !hits[0] ? 1 : 0;
+			uint32_t farther = 1 - nearer;
+			if (hits[farther])
+			{
+				stack.push_back({ node.m_FirstChildOrObject + farther, distances[farther] });
+			}
+			if (hits[nearer])
+			{
+				stack.push_back({ node.m_FirstChildOrObject + nearer, distances[nearer] });
+			}
+		}
+
+		if (hit)
+		{
+			distance = closestDistance;
+		}
+		return hit;
+	}
+
+	uint32_t BoundingVolumeHierarchy::GetNodesCount() const
+	{
+		return static_cast<uint32_t>(m_Nodes.size());
+	}
+
+	BoundingBox BoundingVolumeHierarchy::GetBounds() const
+	{
+		return m_Nodes.empty() ? BoundingBox{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } } : m_Nodes[0].m_Bounds;
+	}
+
+	BoundingVolumeHierarchy::BoundingVolumeHierarchy() :
+		m_UsedNodesCount(0)
+	{
+	}
+
+	void BoundingVolumeHierarchy::BuildNode(uint32_t nodeIndex, uint32_t firstObject, uint32_t objectsCount, std::vector<BoundingBox> const &objectBounds,
+		std::vector<Vector3> const &centroids, uint32_t parallelDepth)
+	{
+		Node &node = m_Nodes[nodeIndex];
+		node.m_Bounds = EmptyBoundingBox;
+		BoundingBox centroidBounds = EmptyBoundingBox;
+		for (uint32_t i = firstObject; i < firstObject + objectsCount; ++i)
+		{
+			ExtendBoundingBox(node.m_Bounds, objectBounds[m_Objects[i]]);
+			ExtendBoundingBox(centroidBounds, centroids[m_Objects[i]]);
+		}
+		node.m_FirstChildOrObject = firstObject;
+		node.m_ObjectsCount = objectsCount;
+		if (1 == objectsCount)
+		{
+			return;
+		}
+
+		// Bins along each axis are swept from both sides to find the split with the lowest surface area heuristic cost
+		float bestCost = FLT_MAX;
+		int bestAxis = -1;
+		uint32_t bestSplit = 0;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float extent = centroidBounds.m_Max[axis] - centroidBounds.m_Min[axis];
+			if (extent <= 0.0f)
+			{
+				continue;
+			}
+			float binScale = BinsCount / extent;
+
+			std::array<BoundingBox, BinsCount> binBounds;
+			std::array<uint32_t, BinsCount> binCounts;
+			binBounds.fill(EmptyBoundingBox);
+			binCounts.fill(0);
+			for (uint32_t i = firstObject; i < firstObject + objectsCount; ++i)
+			{
+				uint32_t bin = static_cast<uint32_t>((centroids[m_Objects[i]][axis] - centroidBounds.m_Min[axis]) * binScale);
+				bin = bin < BinsCount ? bin : BinsCount - 1;
+				++binCounts[bin];
+				ExtendBoundingBox(binBounds[bin], objectBounds[m_Objects[i]]);
+			}
+
+			std::array<float, BinsCount> rightCosts;
+			BoundingBox rightBounds = EmptyBoundingBox;
+			uint32_t rightCount = 0;
+			for (uint32_t bin = BinsCount - 1; bin > 0; --bin)
+			{
+				ExtendBoundingBox(rightBounds, binBounds[bin]);
+				rightCount += binCounts[bin];
+				rightCosts[bin] = rightCount * GetSurfaceArea(rightBounds);
+			}
+
+			BoundingBox leftBounds = EmptyBoundingBox;
+			uint32_t leftCount = 0;
+			for (uint32_t split = 1; split < BinsCount; ++split)
+			{
+				ExtendBoundingBox(leftBounds, binBounds[split - 1]);
+				leftCount += binCounts[split - 1];
+				float cost = leftCount * GetSurfaceArea(leftBounds) + rightCosts[split];
+				if ((0 < leftCount) && (leftCount < objectsCount) && (cost < bestCost))
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = split;
+				}
+			}
+		}
+
+		// Small nodes become leaves when splitting doesn't pay off
+		float leafCost = objectsCount * GetSurfaceArea(node.m_Bounds);
+		if ((objectsCount <= MaxLeafObjectsCount) && ((-1 == bestAxis) || (bestCost >= leafCost)))
+		{
+			return;
+		}
+
+		uint32_t *first = m_Objects.data() + firstObject;
+		uint32_t *last = first + objectsCount;
+		uint32_t *middle;
+		if (-1 != bestAxis)
+		{
+			float binScale = BinsCount / (centroidBounds.m_Max[bestAxis] - centroidBounds.m_Min[bestAxis]);
+			float minimum = centroidBounds.m_Min[bestAxis];
+			middle = std::partition(first, last, [&](uint32_t object)
+			{
+				uint32_t bin = static_cast<uint32_t>((centroids[object][bestAxis] - minimum) * binScale);
+				return (bin < BinsCount ? bin : BinsCount - 1) < bestSplit;
+			});
+		}
+		else
+		{
+			// All centroids are at the same point, so objects are split in half
+			middle = first + objectsCount / 2;
+		}
+		uint32_t leftCount = static_cast<uint32_t>(middle - first);
+
+		uint32_t children = m_UsedNodesCount.fetch_add(2);
+		node.m_FirstChildOrObject = children;
+		node.m_ObjectsCount = 0;
+
+		if ((0 < parallelDepth) && (objectsCount >= MinimalObjectsPerThread))
+		{
+			std::thread thread(&BoundingVolumeHierarchy::BuildNode, this, children, firstObject, leftCount, std::cref(objectBounds), std::cref(centroids), parallelDepth - 1);
+			BuildNode(children + 1, firstObject + leftCount, objectsCount - leftCount, objectBounds, centroids, parallelDepth - 1);
+			thread.join();
+		}
+		else
+		{
+			BuildNode(children, firstObject, leftCount, objectBounds, centroids, 0);
+			BuildNode(children + 1, firstObject + leftCount, objectsCount - leftCount, objectBounds, centroids, 0);
+		}
+	}
+
+	void BoundingVolumeHierarchy::CollectObjects(uint32_t nodeIndex, std::vector<uint32_t> &objects) const
+	{
+		// Objects of a subtree occupy a continuous range, bounded by its leftmost and rightmost leaves
+		uint32_t leftmost = nodeIndex;
+		while (0 == m_Nodes[leftmost].m_ObjectsCount)
+		{
+			leftmost = m_Nodes[leftmost].m_FirstChildOrObject;
+		}
+		uint32_t rightmost = nodeIndex;
+		while (0 == m_Nodes[rightmost].m_ObjectsCount)
+		{
+			rightmost = m_Nodes[rightmost].m_FirstChildOrObject + 1;
+		}
+		uint32_t begin = m_Nodes[leftmost].m_FirstChildOrObject;
+		uint32_t end = m_Nodes[rightmost].m_FirstChildOrObject + m_Nodes[rightmost].m_ObjectsCount;
+		objects.insert(objects.end(), m_Objects.begin() + begin, m_Objects.begin() + end);
+	}
+}
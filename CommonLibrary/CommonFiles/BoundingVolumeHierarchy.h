@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include "Tools.h"
+
+namespace VulkanSampleFramework
+{
+	struct BoundingBox
+	{
+		Vector3 m_Min;
+		Vector3 m_Max;
+	};
+
+	struct Ray
+	{
+		Vector3 m_Origin;
+		Vector3 m_Direction;
+	};
+
+	// Box containing the transformed box (Arvo's method)
+	BoundingBox TransformBoundingBox(BoundingBox const &box, Matrix4x4 const &matrix);
+	// Returns false when the ray misses the box or enters it farther than maxDistance
+	bool IntersectRayWithBoundingBox(Ray const &ray, BoundingBox const &box, float maxDistance, float &distance);
+
+	// Hierarchy of boxes of scene objects (e.g. mesh parts transformed to the world space), built with binned surface area heuristic.
+	// Moving objects are handled by refitting the hierarchy, which keeps its topology, so it should be rebuilt once objects move far.
+	class BoundingVolumeHierarchy
+	{
+	public:
+		void Build(std::vector<BoundingBox> const &objectBounds);
+		// Number and order of objects must be the same as during the building
+		void Refit(std::vector<BoundingBox> const &objectBounds);
+		// Planes point inside the frustum, as returned by the ExtractFrustumPlanes()
+		void QueryFrustum(std::array<Vector4, 6> const &planes, std::vector<uint32_t> &visibleObjects) const;
+		// Optional function tests an object precisely (e.g. its triangles) and returns the distance of the hit, otherwise boxes are hit
+		bool QueryClosestRayHit(Ray const &ray, float maxDistance, uint32_t &object, float &distance,
+			std::function<bool(uint32_t object, Ray const &ray, float &distance)> const &intersectObject = nullptr) const;
+
+		uint32_t GetNodesCount() const;
+		BoundingBox GetBounds() const;
+
+		BoundingVolumeHierarchy();
+
+	private:
+		// Interior nodes have zero objects and their children are stored next to each other
+		struct Node
+		{
+			BoundingBox	m_Bounds;
+			uint32_t	m_FirstChildOrObject;
+			uint32_t	m_ObjectsCount;
+		};
+
+		void BuildNode(uint32_t nodeIndex, uint32_t firstObject, uint32_t objectsCount, std::vector<BoundingBox> const &objectBounds,
+			std::vector<Vector3> const &centroids, uint32_t parallelDepth);
+		void CollectObjects(uint32_t nodeIndex, std::vector<uint32_t> &objects) const;
+
+		std::vector<Node>			m_Nodes;
+		std::vector<uint32_t>		m_Objects;			// Objects of each leaf form a continuous range
+		std::vector<BoundingBox>	m_ObjectBounds;
+		std::atomic<uint32_t>		m_UsedNodesCount;
+	};
+}
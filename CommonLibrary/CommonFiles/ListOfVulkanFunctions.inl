@@ -48,6 +48,8 @@ INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkGetPhysicalDeviceSurfaceCapabili
 INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkGetPhysicalDeviceSurfaceFormatsKHR, VK_KHR_SURFACE_EXTENSION_NAME)
 INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkGetPhysicalDeviceSurfacePresentModesKHR, VK_KHR_SURFACE_EXTENSION_NAME)
 INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkDestroySurfaceKHR, VK_KHR_SURFACE_EXTENSION_NAME)
+INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkGetPhysicalDeviceFeatures2KHR, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)
+INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkGetPhysicalDeviceMemoryProperties2KHR, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)
 
 #ifdef VK_USE_PLATFORM_WIN32_KHR
 INSTANCE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkCreateWin32SurfaceKHR, VK_KHR_WIN32_SURFACE_EXTENSION_NAME)
@@ -83,6 +85,7 @@ DEVICE_LEVEL_VULKAN_FUNCTION(vkUnmapMemory)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdCopyBuffer)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdCopyBufferToImage)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdCopyImageToBuffer)
+DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdFillBuffer)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkBeginCommandBuffer)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkEndCommandBuffer)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkQueueSubmit)
@@ -95,6 +98,7 @@ DEVICE_LEVEL_VULKAN_FUNCTION(vkAllocateCommandBuffers)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCreateSemaphore)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCreateFence)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkWaitForFences)
+DEVICE_LEVEL_VULKAN_FUNCTION(vkGetFenceStatus)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkResetFences)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkDestroyFence)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkDestroySemaphore)
@@ -142,8 +146,11 @@ DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdSetScissor)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdBindVertexBuffers)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdDraw)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdDrawIndexed)
+DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdDrawIndirect)
+DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdDrawIndexedIndirect)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdDispatch)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdCopyImage)
+DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdBlitImage)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdPushConstants)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdClearColorImage)
 DEVICE_LEVEL_VULKAN_FUNCTION(vkCmdClearDepthStencilImage)
@@ -167,5 +174,10 @@ DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkGetSwapchainImagesKHR, VK_KHR_SWAP
 DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkAcquireNextImageKHR, VK_KHR_SWAPCHAIN_EXTENSION_NAME)
 DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkQueuePresentKHR, VK_KHR_SWAPCHAIN_EXTENSION_NAME)
 DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkDestroySwapchainKHR, VK_KHR_SWAPCHAIN_EXTENSION_NAME)
+DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkCmdDrawIndirectCountAMD, VK_AMD_DRAW_INDIRECT_COUNT_EXTENSION_NAME)
+DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkCmdPipelineBarrier2KHR, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME)
+DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkGetSemaphoreCounterValueKHR, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)
+DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkWaitSemaphoresKHR, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)
+DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION(vkSignalSemaphoreKHR, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)
 
 #undef DEVICE_LEVEL_VULKAN_FUNCTION_FROM_EXTENSION
@@ -0,0 +1,154 @@
+#pragma once
+#include "vulkan/vulkan.h"
+
+// Extensions newer than the bundled Vulkan headers, defined the same way as in the official headers.
+// Each block is skipped when the headers are updated and already contain the extension.
+
+#ifndef VK_EXT_memory_budget
+#define VK_EXT_memory_budget 1
+#define VK_EXT_MEMORY_BUDGET_EXTENSION_NAME "VK_EXT_memory_budget"
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT static_cast<VkStructureType>(1000237000)
+
+typedef struct VkPhysicalDeviceMemoryBudgetPropertiesEXT {
+	VkStructureType    sType;
+	void*              pNext;
+	VkDeviceSize       heapBudget[VK_MAX_MEMORY_HEAPS];
+	VkDeviceSize       heapUsage[VK_MAX_MEMORY_HEAPS];
+} VkPhysicalDeviceMemoryBudgetPropertiesEXT;
+#endif
+
+#ifndef VK_KHR_synchronization2
+#define VK_KHR_synchronization2 1
+#define VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME "VK_KHR_synchronization2"
+#define VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR static_cast<VkStructureType>(1000314000)
+#define VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR static_cast<VkStructureType>(1000314001)
+#define VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR static_cast<VkStructureType>(1000314002)
+#define VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR static_cast<VkStructureType>(1000314003)
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR static_cast<VkStructureType>(1000314007)
+
+// Lower 32 bits of the 64-bit flags match the original pipeline stage and access flags
+typedef uint64_t VkPipelineStageFlags2KHR;
+typedef uint64_t VkAccessFlags2KHR;
+
+typedef struct VkMemoryBarrier2KHR {
+	VkStructureType             sType;
+	const void*                 pNext;
+	VkPipelineStageFlags2KHR    srcStageMask;
+	VkAccessFlags2KHR           srcAccessMask;
+	VkPipelineStageFlags2KHR    dstStageMask;
+	VkAccessFlags2KHR           dstAccessMask;
+} VkMemoryBarrier2KHR;
+
+typedef struct VkBufferMemoryBarrier2KHR {
+	VkStructureType             sType;
+	const void*                 pNext;
+	VkPipelineStageFlags2KHR    srcStageMask;
+	VkAccessFlags2KHR           srcAccessMask;
+	VkPipelineStageFlags2KHR    dstStageMask;
+	VkAccessFlags2KHR           dstAccessMask;
+	uint32_t                    srcQueueFamilyIndex;
+	uint32_t                    dstQueueFamilyIndex;
+	VkBuffer                    buffer;
+	VkDeviceSize                offset;
+	VkDeviceSize                size;
+} VkBufferMemoryBarrier2KHR;
+
+typedef struct VkImageMemoryBarrier2KHR {
+	VkStructureType             sType;
+	const void*                 pNext;
+	VkPipelineStageFlags2KHR    srcStageMask;
+	VkAccessFlags2KHR           srcAccessMask;
+	VkPipelineStageFlags2KHR    dstStageMask;
+	VkAccessFlags2KHR           dstAccessMask;
+	VkImageLayout               oldLayout;
+	VkImageLayout               newLayout;
+	uint32_t                    srcQueueFamilyIndex;
+	uint32_t                    dstQueueFamilyIndex;
+	VkImage                     image;
+	VkImageSubresourceRange     subresourceRange;
+} VkImageMemoryBarrier2KHR;
+
+typedef struct VkDependencyInfoKHR {
+	VkStructureType                     sType;
+	const void*                         pNext;
+	VkDependencyFlags                   dependencyFlags;
+	uint32_t                            memoryBarrierCount;
+	const VkMemoryBarrier2KHR*          pMemoryBarriers;
+	uint32_t                            bufferMemoryBarrierCount;
+	const VkBufferMemoryBarrier2KHR*    pBufferMemoryBarriers;
+	uint32_t                            imageMemoryBarrierCount;
+	const VkImageMemoryBarrier2KHR*     pImageMemoryBarriers;
+} VkDependencyInfoKHR;
+
+typedef struct VkPhysicalDeviceSynchronization2FeaturesKHR {
+	VkStructureType    sType;
+	void*              pNext;
+	VkBool32           synchronization2;
+} VkPhysicalDeviceSynchronization2FeaturesKHR;
+
+typedef void (VKAPI_PTR *PFN_vkCmdPipelineBarrier2KHR)(VkCommandBuffer commandBuffer, const VkDependencyInfoKHR* pDependencyInfo);
+#endif
+
+#ifndef VK_KHR_timeline_semaphore
+#define VK_KHR_timeline_semaphore 1
+#define VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME "VK_KHR_timeline_semaphore"
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR static_cast<VkStructureType>(1000207000)
+#define VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR static_cast<VkStructureType>(1000207002)
+#define VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR static_cast<VkStructureType>(1000207003)
+#define VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR static_cast<VkStructureType>(1000207004)
+#define VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO_KHR static_cast<VkStructureType>(1000207005)
+
+typedef enum VkSemaphoreTypeKHR {
+	VK_SEMAPHORE_TYPE_BINARY_KHR = 0,
+	VK_SEMAPHORE_TYPE_TIMELINE_KHR = 1,
+	VK_SEMAPHORE_TYPE_MAX_ENUM_KHR = 0x7FFFFFFF
+} VkSemaphoreTypeKHR;
+
+typedef enum VkSemaphoreWaitFlagBitsKHR {
+	VK_SEMAPHORE_WAIT_ANY_BIT_KHR = 0x00000001,
+	VK_SEMAPHORE_WAIT_FLAG_BITS_MAX_ENUM_KHR = 0x7FFFFFFF
+} VkSemaphoreWaitFlagBitsKHR;
+typedef VkFlags VkSemaphoreWaitFlagsKHR;
+
+typedef struct VkPhysicalDeviceTimelineSemaphoreFeaturesKHR {
+	VkStructureType    sType;
+	void*              pNext;
+	VkBool32           timelineSemaphore;
+} VkPhysicalDeviceTimelineSemaphoreFeaturesKHR;
+
+typedef struct VkSemaphoreTypeCreateInfoKHR {
+	VkStructureType       sType;
+	const void*           pNext;
+	VkSemaphoreTypeKHR    semaphoreType;
+	uint64_t              initialValue;
+} VkSemaphoreTypeCreateInfoKHR;
+
+typedef struct VkTimelineSemaphoreSubmitInfoKHR {
+	VkStructureType    sType;
+	const void*        pNext;
+	uint32_t           waitSemaphoreValueCount;
+	const uint64_t*    pWaitSemaphoreValues;
+	uint32_t           signalSemaphoreValueCount;
+	const uint64_t*    pSignalSemaphoreValues;
+} VkTimelineSemaphoreSubmitInfoKHR;
+
+typedef struct VkSemaphoreWaitInfoKHR {
+	VkStructureType            sType;
+	const void*                pNext;
+	VkSemaphoreWaitFlagsKHR    flags;
+	uint32_t                   semaphoreCount;
+	const VkSemaphore*         pSemaphores;
+	const uint64_t*            pValues;
+} VkSemaphoreWaitInfoKHR;
+
+typedef struct VkSemaphoreSignalInfoKHR {
+	VkStructureType    sType;
+	const void*        pNext;
+	VkSemaphore        semaphore;
+	uint64_t           value;
+} VkSemaphoreSignalInfoKHR;
+
+typedef VkResult (VKAPI_PTR *PFN_vkGetSemaphoreCounterValueKHR)(VkDevice device, VkSemaphore semaphore, uint64_t* pValue);
+typedef VkResult (VKAPI_PTR *PFN_vkWaitSemaphoresKHR)(VkDevice device, const VkSemaphoreWaitInfoKHR* pWaitInfo, uint64_t timeout);
+typedef VkResult (VKAPI_PTR *PFN_vkSignalSemaphoreKHR)(VkDevice device, const VkSemaphoreSignalInfoKHR* pSignalInfo);
+#endif
@@ -13,7 +13,8 @@ namespace VulkanSampleFramework
 			USER_MESSAGE_QUIT,
 			USER_MESSAGE_MOUSE_CLICK,
 			USER_MESSAGE_MOUSE_MOVE,
-			USER_MESSAGE_MOUSE_WHEEL
+			USER_MESSAGE_MOUSE_WHEEL,
+			USER_MESSAGE_KEY_PRESS
 		};
 	}
 
@@ -48,6 +49,10 @@ namespace VulkanSampleFramework
 			{
 				PostMessage(hWnd, USER_MESSAGE_QUIT, wParam, lParam);
 			}
+			else
+			{
+				PostMessage(hWnd, USER_MESSAGE_KEY_PRESS, wParam, lParam);
+			}
 			break;
 		case WM_CLOSE:
 			PostMessage(hWnd, USER_MESSAGE_QUIT, wParam, lParam);
@@ -135,6 +140,9 @@ namespace VulkanSampleFramework
 					case USER_MESSAGE_MOUSE_WHEEL:
 						m_Sample.MouseWheel(static_cast<short>(message.wParam) * 0.002f);
 						break;
+					case USER_MESSAGE_KEY_PRESS:
+						m_Sample.KeyPress(static_cast<uint32_t>(message.wParam));
+						break;
 					case USER_MESSAGE_RESIZE:
 						if (!m_Sample.Resize())
 						{
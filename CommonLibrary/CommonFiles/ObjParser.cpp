@@ -0,0 +1,590 @@
+#include <algorithm>
+#include "ObjParser.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		size_t const MinimalChunkSize = 1 << 20;
+
+		class MemoryMappedFile
+		{
+		public:
+			bool Open(char const *filename)
+			{
+#ifdef _WIN32
+				m_File = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+				if (INVALID_HANDLE_VALUE == m_File)
+				{
+					return false;
+				}
+				LARGE_INTEGER size;
+				if (!GetFileSizeEx(m_File, &size))
+				{
+					return false;
+				}
+				m_Size = static_cast<size_t>(size.QuadPart);
+				if (0 == m_Size)
+				{
+					return true;
+				}
+				m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (nullptr == m_Mapping)
+				{
+					return false;
+				}
+				m_Data = static_cast<char const *>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+				return nullptr != m_Data;
+#else
+				m_File = open(filename, O_RDONLY);
+				if (-1 == m_File)
+				{
+					return false;
+				}
+				struct stat fileStatus;
+				if (-1 == fstat(m_File, &fileStatus))
+				{
+					return false;
+				}
+				m_Size = static_cast<size_t>(fileStatus.st_size);
+				if (0 == m_Size)
+				{
+					return true;
+				}
+				void *data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_File, 0);
+				if (MAP_FAILED == data)
+				{
+					return false;
+				}
+				madvise(data, m_Size, MADV_SEQUENTIAL);
+				m_Data = static_cast<char const *>(data);
+				return true;
+#endif
+			}
+
+			char const * GetData() const
+			{
+				return m_Data;
+			}
+
+			size_t GetSize() const
+			{
+				return m_Size;
+			}
+
+#ifdef _WIN32
+			MemoryMappedFile() :
+				m_File(INVALID_HANDLE_VALUE),
+				m_Mapping(nullptr),
+				m_Data(nullptr),
+				m_Size(0)
+			{
+			}
+
+			~MemoryMappedFile()
+			{
+				if (nullptr != m_Data)
+				{
+					UnmapViewOfFile(m_Data);
+				}
+				if (nullptr != m_Mapping)
+				{
+					CloseHandle(m_Mapping);
+				}
+				if (INVALID_HANDLE_VALUE != m_File)
+				{
+					CloseHandle(m_File);
+				}
+			}
+
+		private:
+			HANDLE		m_File;
+			HANDLE		m_Mapping;
+#else
+			MemoryMappedFile() :
+				m_File(-1),
+				m_Data(nullptr),
+				m_Size(0)
+			{
+			}
+
+			~MemoryMappedFile()
+			{
+				if (nullptr != m_Data)
+				{
+					munmap(const_cast<char *>(m_Data), m_Size);
+				}
+				if (-1 != m_File)
+				{
+					close(m_File);
+				}
+			}
+
+		private:
+			int			m_File;
+#endif
+			char const	*m_Data;
+			size_t		m_Size;
+		};
+
+		struct ChunkData
+		{
+			std::vector<float>		m_Positions;
+			std::vector<float>		m_Normals;
+			std::vector<float>		m_Texcoords;
+			std::vector<ObjIndex>	m_Indices;
+			// Negative (relative) indices are stored relative to the beginning of the chunk, bits mark which of them
+			// have to be offset by the number of attributes defined in previous chunks. Masks are stored for all indices
+			// after the first relative one is found.
+			std::vector<uint8_t>	m_RelativeIndices;
+			bool					m_HasRelativeIndices;
+			std::vector<size_t>		m_PartStarts;
+			size_t					m_InvalidLine;
+		};
+
+		uint8_t const RelativePosition = 1;
+		uint8_t const RelativeTexcoord = 2;
+		uint8_t const RelativeNormal = 4;
+
+		inline bool IsSpace(char character)
+		{
+			return (' ' == character) || ('\t' == character) || ('\r' == character);
+		}
+
+		inline char const * SkipSpaces(char const *current, char const *end)
+		{
+			while ((current < end) && IsSpace(*current))
+			{
+				++current;
+			}
+			return current;
+		}
+
+		// Decimal mantissa is accumulated as an integer and scaled once, which is much faster than strtof and accurate
+		// to within a unit in the last place for the number of digits written by exporters
+		char const * ParseFloat(char const *current, char const *end, float &value)
+		{
+			static double const powersOf10[] =
+			{
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+			};
+
+			current = SkipSpaces(current, end);
+			bool negative = false;
+			if ((current < end) && (('-' == *current) || ('+' == *current)))
+			{
+				negative = '-' == *current;
+				++current;
+			}
+
+			uint64_t mantissa = 0;
+			int exponent = 0;
+			int significantDigits = 0;
+			bool anyDigit = false;
+			for (; (current < end) && (*current >= '0') && (*current <= '9'); ++current)
+			{
+				anyDigit = true;
+				if (significantDigits < 19)
+				{
+					mantissa = mantissa * 10 + (*current - '0');
+					significantDigits += (0 != mantissa) ? 1 : 0;
+				}
+				else
+				{
+					++exponent;
+				}
+			}
+			if ((current < end) && ('.' == *current))
+			{
+				++current;
+				for (; (current < end) && (*current >= '0') && (*current <= '9'); ++current)
+				{
+					anyDigit = true;
+					if (significantDigits < 19)
+					{
+						mantissa = mantissa * 10 + (*current - '0');
+						significantDigits += (0 != mantissa) ? 1 : 0;
+						--exponent;
+					}
+				}
+			}
+			if (!anyDigit)
+			{
+				return nullptr;
+			}
+			if ((current < end) && (('e' == *current) || ('E' == *current)))
+			{
+				++current;
+				bool negativeExponent = false;
+				if ((current < end) && (('-' == *current) || ('+' == *current)))
+				{
+					negativeExponent = '-' == *current;
+					++current;
+				}
+				int explicitExponent = 0;
+				for (; (current < end) && (*current >= '0') && (*current <= '9'); ++current)
+				{
+					explicitExponent = explicitExponent < 10000 ? explicitExponent * 10 + (*current - '0') : explicitExponent;
+				}
+				exponent += negativeExponent ? -explicitExponent : explicitExponent;
+			}
+
+			double result = static_cast<double>(mantissa);
+			if ((exponent >= -22) && (exponent <= 22))
+			{
+				result = exponent < 0 ? result / powersOf10[-exponent] : result * powersOf10[exponent];
+			}
+			else
+			{
+				result *= std::pow(10.0, exponent);
+			}
+			value = static_cast<float>(negative ? -result : result);
+			return current;
+		}
+
+		char const * ParseInteger(char const *current, char const *end, int64_t &value)
+		{
+			bool negative = false;
+			if ((current < end) && (('-' == *current) || ('+' == *current)))
+			{
+				negative = '-' == *current;
+				++current;
+			}
+			if ((current >= end) || (*current < '0') || (*current > '9'))
+			{
+				return nullptr;
+			}
+			value = 0;
+			for (; (current < end) && (*current >= '0') && (*current <= '9'); ++current)
+			{
+				value = value * 10 + (*current - '0');
+			}
+			value = negative ? -value : value;
+			return current;
+		}
+
+		// Converts one-based OBJ index into a zero-based one, relative indices are converted relative to the chunk
+		inline int32_t ResolveIndex(int64_t index, size_t chunkCount, uint8_t relativeBit, uint8_t &relativeMask)
+		{
+			if (index < 0)
+			{
+				relativeMask |= relativeBit;
+				return static_cast<int32_t>(static_cast<int64_t>(chunkCount) + index);
+			}
+			return static_cast<int32_t>(index - 1);
+		}
+
+		char const * ParseFaceVertex(char const *current, char const *end, ChunkData &chunk, ObjIndex &index, uint8_t &relativeMask)
+		{
+			int64_t value;
+			index = { -1, -1, -1 };
+
+			current = ParseInteger(current, end, value);
+			if ((nullptr == current) || (0 == value))
+			{
+				return nullptr;
+			}
+			index.m_Position = ResolveIndex(value, chunk.m_Positions.size() / 3, RelativePosition, relativeMask);
+
+			if ((current < end) && ('/' == *current))
+			{
+				++current;
+				if ((current < end) && ('/' != *current))
+				{
+					current = ParseInteger(current, end, value);
+					if ((nullptr == current) || (0 == value))
+					{
+						return nullptr;
+					}
+					index.m_Texcoord = ResolveIndex(value, chunk.m_Texcoords.size() / 2, RelativeTexcoord, relativeMask);
+				}
+				if ((current < end) && ('/' == *current))
+				{
+					++current;
+					current = ParseInteger(current, end, value);
+					if ((nullptr == current) || (0 == value))
+					{
+						return nullptr;
+					}
+					index.m_Normal = ResolveIndex(value, chunk.m_Normals.size() / 3, RelativeNormal, relativeMask);
+				}
+			}
+			return current;
+		}
+
+		bool ParseLine(char const *current, char const *end, ChunkData &chunk, std::vector<ObjIndex> &polygon, std::vector<uint8_t> &polygonRelativeMasks)
+		{
+			// Comments may also follow statements, so everything from '#' is ignored
+			char const *comment = static_cast<char const *>(std::memchr(current, '#', end - current));
+			end = (nullptr != comment) ? comment : end;
+
+			current = SkipSpaces(current, end);
+			if (current >= end)
+			{
+				return true;
+			}
+
+			auto isStatement = [&current, end](char const *keyword, size_t length) -> bool
+			{
+				return (static_cast<size_t>(end - current) > length) && (0 == std::memcmp(current, keyword, length)) && IsSpace(current[length]);
+			};
+
+			if (isStatement("v", 1) || isStatement("vn", 2))
+			{
+				std::vector<float> &target = ('n' == current[1]) ? chunk.m_Normals : chunk.m_Positions;
+				current += ('n' == current[1]) ? 2 : 1;
+				for (int component = 0; component < 3; ++component)
+				{
+					float value;
+					current = ParseFloat(current, end, value);
+					if (nullptr == current)
+					{
+						return false;
+					}
+					target.push_back(value);
+				}
+			}
+			else if (isStatement("vt", 2))
+			{
+				current += 2;
+				for (int component = 0; component < 2; ++component)
+				{
+					float value = 0.0f;
+					char const *next = ParseFloat(current, end, value);
+					// Second coordinate is optional
+					if ((nullptr == next) && (0 == component))
+					{
+						return false;
+					}
+					current = (nullptr != next) ? next : current;
+					chunk.m_Texcoords.push_back(value);
+				}
+			}
+			else if (isStatement("f", 1))
+			{
+				current += 1;
+				polygon.clear();
+				polygonRelativeMasks.clear();
+				while (true)
+				{
+					current = SkipSpaces(current, end);
+					if (current >= end)
+					{
+						break;
+					}
+					ObjIndex index;
+					uint8_t relativeMask = 0;
+					current = ParseFaceVertex(current, end, chunk, index, relativeMask);
+					if (nullptr == current)
+					{
+						return false;
+					}
+					polygon.push_back(index);
+					polygonRelativeMasks.push_back(relativeMask);
+				}
+				if (polygon.size() < 3)
+				{
+					return false;
+				}
+
+				// Polygons are triangulated as fans
+				bool anyRelative = false;
+				for (auto mask : polygonRelativeMasks)
+				{
+					anyRelative = anyRelative || (0 != mask);
+				}
+				// Indices of previous faces are absolute, masks of this one are added below
+				if (anyRelative && !chunk.m_HasRelativeIndices)
+				{
+					chunk.m_RelativeIndices.resize(chunk.m_Indices.size(), 0);
+					chunk.m_HasRelativeIndices = true;
+				}
+				for (size_t vertex = 2; vertex < polygon.size(); ++vertex)
+				{
+					size_t const corners[3] = { 0, vertex - 1, vertex };
+					for (auto corner : corners)
+					{
+						chunk.m_Indices.push_back(polygon[corner]);
+						if (chunk.m_HasRelativeIndices)
+						{
+							chunk.m_RelativeIndices.push_back(polygonRelativeMasks[corner]);
+						}
+					}
+				}
+			}
+			else if (isStatement("o", 1) || isStatement("g", 1))
+			{
+				chunk.m_PartStarts.push_back(chunk.m_Indices.size());
+			}
+			// Comments, materials, smoothing groups and other statements don't affect geometry
+			return true;
+		}
+
+		void ParseChunk(char const *begin, char const *end, ChunkData &chunk)
+		{
+			// Rough estimates reduce the number of reallocations
+			size_t estimatedLines = static_cast<size_t>(end - begin) / 32;
+			chunk.m_Positions.reserve(estimatedLines);
+			chunk.m_Indices.reserve(estimatedLines);
+			chunk.m_InvalidLine = 0;
+
+			std::vector<ObjIndex> polygon;
+			std::vector<uint8_t> polygonRelativeMasks;
+			size_t line = 1;
+			for (char const *current = begin; current < end; ++line)
+			{
+				char const *lineEnd = static_cast<char const *>(std::memchr(current, '\n', end - current));
+				lineEnd = (nullptr != lineEnd) ? lineEnd : end;
+				if (!ParseLine(current, lineEnd, chunk, polygon, polygonRelativeMasks))
+				{
+					chunk.m_InvalidLine = line;
+					return;
+				}
+				current = lineEnd + 1;
+			}
+		}
+
+		char const * FindLineStart(char const *position, char const *end)
+		{
+			char const *lineEnd = static_cast<char const *>(std::memchr(position, '\n', end - position));
+			return (nullptr != lineEnd) ? lineEnd + 1 : end;
+		}
+
+		void RunOnThreads(size_t count, std::function<void(size_t)> const &function)
+		{
+			std::vector<std::thread> threads;
+			for (size_t i = 1; i < count; ++i)
+			{
+				threads.emplace_back(function, i);
+			}
+			if (count > 0)
+			{
+				function(0);
+			}
+			for (auto & thread : threads)
+			{
+				thread.join();
+			}
+		}
+	}
+
+	bool ParseObjFile(char const *filename, ObjData &data)
+	{
+		data = {};
+
+		MemoryMappedFile file;
+		if (!file.Open(filename))
+		{
+			std::cout << "Could not open the '" << filename << "' file." << std::endl;
+			return false;
+		}
+
+		char const *begin = file.GetData();
+		char const *end = begin + file.GetSize();
+
+		// Chunk boundaries are moved to the beginning of the next line
+		size_t chunksCount = file.GetSize() / MinimalChunkSize;
+		size_t threadsCount = std::thread::hardware_concurrency();
+		chunksCount = chunksCount > threadsCount ? threadsCount : chunksCount;
+		chunksCount = chunksCount > 1 ? chunksCount : 1;
+
+		std::vector<char const *> boundaries(chunksCount + 1);
+		boundaries[0] = begin;
+		for (size_t i = 1; i < chunksCount; ++i)
+		{
+			boundaries[i] = FindLineStart(begin + i * (file.GetSize() / chunksCount), end);
+			boundaries[i] = boundaries[i] > boundaries[i - 1] ? boundaries[i] : boundaries[i - 1];
+		}
+		boundaries[chunksCount] = end;
+
+		std::vector<ChunkData> chunks(chunksCount);
+		RunOnThreads(chunksCount, [&](size_t chunk)
+		{
+			ParseChunk(boundaries[chunk], boundaries[chunk + 1], chunks[chunk]);
+		});
+
+		for (size_t chunk = 0; chunk < chunksCount; ++chunk)
+		{
+			if (0 != chunks[chunk].m_InvalidLine)
+			{
+				// Line numbers are counted per chunk, so the chunk beginning is reported along with it
+				std::cout << "Could not parse the '" << filename << "' file, invalid statement in line " << chunks[chunk].m_InvalidLine
+					<< " counted from byte offset " << (boundaries[chunk] - begin) << "." << std::endl;
+				return false;
+			}
+		}
+
+		// Offsets of chunks in the merged arrays
+		struct ChunkOffsets
+		{
+			size_t m_Positions;
+			size_t m_Normals;
+			size_t m_Texcoords;
+			size_t m_Indices;
+		};
+		std::vector<ChunkOffsets> offsets(chunksCount + 1, { 0, 0, 0, 0 });
+		for (size_t chunk = 0; chunk < chunksCount; ++chunk)
+		{
+			offsets[chunk + 1].m_Positions = offsets[chunk].m_Positions + chunks[chunk].m_Positions.size();
+			offsets[chunk + 1].m_Normals = offsets[chunk].m_Normals + chunks[chunk].m_Normals.size();
+			offsets[chunk + 1].m_Texcoords = offsets[chunk].m_Texcoords + chunks[chunk].m_Texcoords.size();
+			offsets[chunk + 1].m_Indices = offsets[chunk].m_Indices + chunks[chunk].m_Indices.size();
+		}
+
+		std::vector<size_t> partStarts = { 0 };
+		for (size_t chunk = 0; chunk < chunksCount; ++chunk)
+		{
+			for (auto start : chunks[chunk].m_PartStarts)
+			{
+				partStarts.push_back(offsets[chunk].m_Indices + start);
+			}
+		}
+		partStarts.push_back(offsets[chunksCount].m_Indices);
+
+		data.m_Positions.resize(offsets[chunksCount].m_Positions);
+		data.m_Normals.resize(offsets[chunksCount].m_Normals);
+		data.m_Texcoords.resize(offsets[chunksCount].m_Texcoords);
+		data.m_Indices.resize(offsets[chunksCount].m_Indices);
+
+		RunOnThreads(chunksCount, [&](size_t chunk)
+		{
+			ChunkData &source = chunks[chunk];
+			ChunkOffsets const &offset = offsets[chunk];
+			std::copy(source.m_Positions.begin(), source.m_Positions.end(), data.m_Positions.begin() + offset.m_Positions);
+			std::copy(source.m_Normals.begin(), source.m_Normals.end(), data.m_Normals.begin() + offset.m_Normals);
+			std::copy(source.m_Texcoords.begin(), source.m_Texcoords.end(), data.m_Texcoords.begin() + offset.m_Texcoords);
+
+			// Positive indices are already global, relative ones are offset by the number of attributes in previous chunks
+			ObjIndex *indices = data.m_Indices.data() + offset.m_Indices;
+			for (size_t i = 0; i < source.m_Indices.size(); ++i)
+			{
+				ObjIndex index = source.m_Indices[i];
+				uint8_t relativeMask = source.m_HasRelativeIndices ? source.m_RelativeIndices[i] : 0;
+				if (0 != relativeMask)
+				{
+					index.m_Position += (relativeMask & RelativePosition) ? static_cast<int32_t>(offset.m_Positions / 3) : 0;
+					index.m_Texcoord += (relativeMask & RelativeTexcoord) ? static_cast<int32_t>(offset.m_Texcoords / 2) : 0;
+					index.m_Normal += (relativeMask & RelativeNormal) ? static_cast<int32_t>(offset.m_Normals / 3) : 0;
+				}
+				indices[i] = index;
+			}
+			source = {};
+		});
+
+		for (size_t part = 0; part + 1 < partStarts.size(); ++part)
+		{
+			if (partStarts[part + 1] > partStarts[part])
+			{
+				data.m_Parts.push_back({ partStarts[part], partStarts[part + 1] - partStarts[part] });
+			}
+		}
+		return true;
+	}
+}
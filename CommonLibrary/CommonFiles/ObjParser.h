@@ -0,0 +1,32 @@
+#pragma once
+#include "Common.h"
+
+namespace VulkanSampleFramework
+{
+	// Zero-based indices of vertex attributes, -1 when the attribute wasn't specified for a face vertex
+	struct ObjIndex
+	{
+		int32_t m_Position;
+		int32_t m_Texcoord;
+		int32_t m_Normal;
+	};
+
+	struct ObjData
+	{
+		struct Part
+		{
+			size_t m_FirstIndex;
+			size_t m_IndicesCount;
+		};
+
+		std::vector<float>		m_Positions;	// 3 components per position
+		std::vector<float>		m_Normals;		// 3 components per normal
+		std::vector<float>		m_Texcoords;	// 2 components per texture coordinate
+		std::vector<ObjIndex>	m_Indices;		// Faces are triangulated, 3 indices per triangle
+		std::vector<Part>		m_Parts;		// Started by "o" and "g" statements, parts without faces are skipped
+	};
+
+	// File is memory mapped and split into line-aligned chunks parsed on separate threads. Only geometry is read,
+	// materials and other statements are ignored.
+	bool ParseObjFile(char const *filename, ObjData &data);
+}
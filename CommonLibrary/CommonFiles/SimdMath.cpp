@@ -0,0 +1,252 @@
+#include "SimdMath.h"
+
+#if defined(SIMD_MATH_AVX2)
+#include <immintrin.h>
+#elif defined(SIMD_MATH_SSE4)
+#include <smmintrin.h>
+#elif defined(SIMD_MATH_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+#if defined(SIMD_MATH_SSE2)
+
+		inline __m128 MultiplyAdd(__m128 a, __m128 b, __m128 c)
+		{
+#if defined(SIMD_MATH_AVX2)
+			return _mm_fmadd_ps(a, b, c);
+#else
+			return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+		}
+
+		// Linear combination of matrix columns with vector components as weights, i.e. matrix * vector
+		inline __m128 TransformColumn(__m128 const (&columns)[4], __m128 vector)
+		{
+			__m128 result = _mm_mul_ps(columns[0], _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(0, 0, 0, 0)));
+			result = MultiplyAdd(columns[1], _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(1, 1, 1, 1)), result);
+			result = MultiplyAdd(columns[2], _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(2, 2, 2, 2)), result);
+			return MultiplyAdd(columns[3], _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(3, 3, 3, 3)), result);
+		}
+
+		// Fourth column (translation) is added with weight w, which is 1 for points and 0 for directions
+		template<bool Points>
+		void TransformVectors(AlignedMatrix4x4 const &matrix, AlignedVector3 const *vectors, AlignedVector3 *results, size_t count)
+		{
+			__m128 const c0 = _mm_load_ps(matrix.m_Data);
+			__m128 const c1 = _mm_load_ps(matrix.m_Data + 4);
+			__m128 const c2 = _mm_load_ps(matrix.m_Data + 8);
+			__m128 const c3 = Points ? _mm_load_ps(matrix.m_Data + 12) : _mm_setzero_ps();
+
+			size_t index = 0;
+#if defined(SIMD_MATH_AVX2)
+			// Two vectors per iteration, each 128-bit lane holds one of them
+			__m256 const w0 = _mm256_broadcast_ps(&c0);
+			__m256 const w1 = _mm256_broadcast_ps(&c1);
+			__m256 const w2 = _mm256_broadcast_ps(&c2);
+			__m256 const w3 = _mm256_broadcast_ps(&c3);
+			for (; index + 2 <= count; index += 2)
+			{
+				__m256 v = _mm256_loadu_ps(vectors[index].m_Data);
+				__m256 result = _mm256_fmadd_ps(w0, _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)), w3);
+				result = _mm256_fmadd_ps(w1, _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), result);
+				result = _mm256_fmadd_ps(w2, _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), result);
+				_mm256_storeu_ps(results[index].m_Data, result);
+			}
+#endif
+			for (; index < count; ++index)
+			{
+				__m128 v = _mm_load_ps(vectors[index].m_Data);
+				__m128 result = MultiplyAdd(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), c3);
+				result = MultiplyAdd(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), result);
+				result = MultiplyAdd(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), result);
+				_mm_store_ps(results[index].m_Data, result);
+			}
+		}
+
+#else
+
+		template<bool Points>
+		void TransformVectors(AlignedMatrix4x4 const &matrix, AlignedVector3 const *vectors, AlignedVector3 *results, size_t count)
+		{
+			float const *m = matrix.m_Data;
+			float const w = Points ? 1.0f : 0.0f;
+			for (size_t index = 0; index < count; ++index)
+			{
+				float const x = vectors[index].m_Data[0];
+				float const y = vectors[index].m_Data[1];
+				float const z = vectors[index].m_Data[2];
+				for (int row = 0; row < 4; ++row)
+				{
+					results[index].m_Data[row] = m[row] * x + m[4 + row] * y + m[8 + row] * z + m[12 + row] * w;
+				}
+			}
+		}
+
+#endif
+	}
+
+	char const * GetSimdMathBackendName()
+	{
+#if defined(SIMD_MATH_AVX2)
+		return "AVX2";
+#elif defined(SIMD_MATH_SSE4)
+		return "SSE4.1";
+#elif defined(SIMD_MATH_SSE2)
+		return "SSE2";
+#else
+		return "Scalar";
+#endif
+	}
+
+	void LoadMatrix(Matrix4x4 const &source, AlignedMatrix4x4 &destination)
+	{
+		std::memcpy(destination.m_Data, source.data(), sizeof(destination.m_Data));
+	}
+
+	void StoreMatrix(AlignedMatrix4x4 const &source, Matrix4x4 &destination)
+	{
+		std::memcpy(destination.data(), source.m_Data, sizeof(source.m_Data));
+	}
+
+	void MultiplyMatrices(AlignedMatrix4x4 const &left, AlignedMatrix4x4 const &right, AlignedMatrix4x4 &result)
+	{
+#if defined(SIMD_MATH_SSE2)
+		__m128 const columns[4] =
+		{
+			_mm_load_ps(left.m_Data),
+			_mm_load_ps(left.m_Data + 4),
+			_mm_load_ps(left.m_Data + 8),
+			_mm_load_ps(left.m_Data + 12)
+		};
+		for (int column = 0; column < 4; ++column)
+		{
+			_mm_store_ps(result.m_Data + 4 * column, TransformColumn(columns, _mm_load_ps(right.m_Data + 4 * column)));
+		}
+#else
+		MultiplyMatrices(left.m_Data, right.m_Data, result.m_Data);
+#endif
+	}
+
+	void MultiplyMatrices(AlignedMatrix4x4 const &first, AlignedMatrix4x4 const &second, AlignedMatrix4x4 const &third, AlignedMatrix4x4 &result)
+	{
+#if defined(SIMD_MATH_SSE2)
+		__m128 const firstColumns[4] =
+		{
+			_mm_load_ps(first.m_Data),
+			_mm_load_ps(first.m_Data + 4),
+			_mm_load_ps(first.m_Data + 8),
+			_mm_load_ps(first.m_Data + 12)
+		};
+		__m128 const secondColumns[4] =
+		{
+			_mm_load_ps(second.m_Data),
+			_mm_load_ps(second.m_Data + 4),
+			_mm_load_ps(second.m_Data + 8),
+			_mm_load_ps(second.m_Data + 12)
+		};
+		for (int column = 0; column < 4; ++column)
+		{
+			__m128 intermediate = TransformColumn(secondColumns, _mm_load_ps(third.m_Data + 4 * column));
+			_mm_store_ps(result.m_Data + 4 * column, TransformColumn(firstColumns, intermediate));
+		}
+#else
+		AlignedMatrix4x4 intermediate;
+		MultiplyMatrices(second.m_Data, third.m_Data, intermediate.m_Data);
+		MultiplyMatrices(first.m_Data, intermediate.m_Data, result.m_Data);
+#endif
+	}
+
+	void MultiplyMatrices(float const *left, float const *right, float *result)
+	{
+#if defined(SIMD_MATH_SSE2)
+		__m128 const columns[4] =
+		{
+			_mm_loadu_ps(left),
+			_mm_loadu_ps(left + 4),
+			_mm_loadu_ps(left + 8),
+			_mm_loadu_ps(left + 12)
+		};
+		for (int column = 0; column < 4; ++column)
+		{
+			_mm_storeu_ps(result + 4 * column, TransformColumn(columns, _mm_loadu_ps(right + 4 * column)));
+		}
+#else
+		// Temporary storage, so the result may alias the arguments
+		float product[16];
+		for (int column = 0; column < 4; ++column)
+		{
+			for (int row = 0; row < 4; ++row)
+			{
+				product[4 * column + row] =
+					left[row] * right[4 * column] +
+					left[4 + row] * right[4 * column + 1] +
+					left[8 + row] * right[4 * column + 2] +
+					left[12 + row] * right[4 * column + 3];
+			}
+		}
+		std::memcpy(result, product, sizeof(product));
+#endif
+	}
+
+	void TransformPoints(AlignedMatrix4x4 const &matrix, AlignedVector3 const *points, AlignedVector3 *results, size_t count)
+	{
+		TransformVectors<true>(matrix, points, results, count);
+	}
+
+	void TransformDirections(AlignedMatrix4x4 const &matrix, AlignedVector3 const *directions, AlignedVector3 *results, size_t count)
+	{
+		TransformVectors<false>(matrix, directions, results, count);
+	}
+
+	float Dot(AlignedVector3 const &left, AlignedVector3 const &right)
+	{
+#if defined(SIMD_MATH_SSE4)
+		return _mm_cvtss_f32(_mm_dp_ps(_mm_load_ps(left.m_Data), _mm_load_ps(right.m_Data), 0x71));
+#elif defined(SIMD_MATH_SSE2)
+		__m128 product = _mm_mul_ps(_mm_load_ps(left.m_Data), _mm_load_ps(right.m_Data));
+		__m128 sum = _mm_add_ss(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 2, 2, 2))));
+#else
+		return left.m_Data[0] * right.m_Data[0] + left.m_Data[1] * right.m_Data[1] + left.m_Data[2] * right.m_Data[2];
+#endif
+	}
+
+	void Cross(AlignedVector3 const &left, AlignedVector3 const &right, AlignedVector3 &result)
+	{
+#if defined(SIMD_MATH_SSE2)
+		__m128 l = _mm_load_ps(left.m_Data);
+		__m128 r = _mm_load_ps(right.m_Data);
+		// (l.yzx * r.zxy - l.zxy * r.yzx)
+		__m128 lYZX = _mm_shuffle_ps(l, l, _MM_SHUFFLE(3, 0, 2, 1));
+		__m128 rYZX = _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 0, 2, 1));
+		__m128 difference = _mm_sub_ps(_mm_mul_ps(l, rYZX), _mm_mul_ps(lYZX, r));
+		_mm_store_ps(result.m_Data, _mm_shuffle_ps(difference, difference, _MM_SHUFFLE(3, 0, 2, 1)));
+#else
+		float const x = left.m_Data[1] * right.m_Data[2] - left.m_Data[2] * right.m_Data[1];
+		float const y = left.m_Data[2] * right.m_Data[0] - left.m_Data[0] * right.m_Data[2];
+		float const z = left.m_Data[0] * right.m_Data[1] - left.m_Data[1] * right.m_Data[0];
+		result.m_Data[0] = x;
+		result.m_Data[1] = y;
+		result.m_Data[2] = z;
+		result.m_Data[3] = 0.0f;
+#endif
+	}
+
+	void Normalize(AlignedVector3 &vector)
+	{
+#if defined(SIMD_MATH_SSE4)
+		__m128 v = _mm_load_ps(vector.m_Data);
+		__m128 length = _mm_sqrt_ps(_mm_dp_ps(v, v, 0x7F));
+		_mm_store_ps(vector.m_Data, _mm_div_ps(v, length));
+#else
+		float length = std::sqrt(Dot(vector, vector));
+		vector.m_Data[0] /= length;
+		vector.m_Data[1] /= length;
+		vector.m_Data[2] /= length;
+#endif
+	}
+}
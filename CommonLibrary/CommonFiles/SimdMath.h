@@ -0,0 +1,53 @@
+#pragma once
+#include "Tools.h"
+
+// Backend is selected at compile time from the instruction sets enabled for the compiler: AVX2 and FMA with /arch:AVX2
+// (or -mavx2 -mfma), SSE4.1 with /arch:AVX (or -msse4.1), SSE2 on all other x86-64 builds. Define SIMD_MATH_FORCE_SCALAR
+// to use the portable implementation.
+#if !defined(SIMD_MATH_FORCE_SCALAR)
+// MSVC doesn't define __FMA__, but /arch:AVX2 enables FMA instructions as well.
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define SIMD_MATH_AVX2
+#endif
+#if defined(__AVX2__) || defined(__AVX__) || defined(__SSE4_1__)
+#define SIMD_MATH_SSE4
+#endif
+#if defined(SIMD_MATH_SSE4) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define SIMD_MATH_SSE2
+#endif
+#endif
+
+namespace VulkanSampleFramework
+{
+	// Column major, same as Matrix4x4
+	struct alignas(16) AlignedMatrix4x4
+	{
+		float m_Data[16];
+	};
+
+	// Fourth component is ignored on input and holds w after a transformation
+	struct alignas(16) AlignedVector3
+	{
+		float m_Data[4];
+	};
+
+	char const * GetSimdMathBackendName();
+
+	void LoadMatrix(Matrix4x4 const &source, AlignedMatrix4x4 &destination);
+	void StoreMatrix(AlignedMatrix4x4 const &source, Matrix4x4 &destination);
+
+	// Result may alias any of the arguments
+	void MultiplyMatrices(AlignedMatrix4x4 const &left, AlignedMatrix4x4 const &right, AlignedMatrix4x4 &result);
+	// first * second * third (e.g. projection * view * model) without storing the intermediate product
+	void MultiplyMatrices(AlignedMatrix4x4 const &first, AlignedMatrix4x4 const &second, AlignedMatrix4x4 const &third, AlignedMatrix4x4 &result);
+	// Version for unaligned data, e.g. Matrix4x4 objects
+	void MultiplyMatrices(float const *left, float const *right, float *result);
+
+	// Points are transformed with w = 1, directions with w = 0; results are not divided by w
+	void TransformPoints(AlignedMatrix4x4 const &matrix, AlignedVector3 const *points, AlignedVector3 *results, size_t count);
+	void TransformDirections(AlignedMatrix4x4 const &matrix, AlignedVector3 const *directions, AlignedVector3 *results, size_t count);
+
+	float Dot(AlignedVector3 const &left, AlignedVector3 const &right);
+	void Cross(AlignedVector3 const &left, AlignedVector3 const &right, AlignedVector3 &result);
+	void Normalize(AlignedVector3 &vector);
+}
@@ -0,0 +1,477 @@
+#include "TextureContainers.h"
+#include "Tools.h"
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		uint32_t const DdsMagic = 0x20534444;	// "DDS "
+		uint32_t const DdsFlagDepth = 0x800000;
+		uint32_t const DdsFlagMipmapsCount = 0x20000;
+		uint32_t const DdsPixelFormatFlagFourCC = 0x4;
+		uint32_t const DdsCaps2Cubemap = 0x200;
+		uint32_t const DdsCaps2CubemapAllFaces = 0xFC00;
+		uint32_t const DdsMiscFlagTextureCube = 0x4;
+		uint32_t const DdsResourceDimensionTexture3D = 4;
+
+		unsigned char const Ktx2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+		struct DdsPixelFormat
+		{
+			uint32_t	m_Size;
+			uint32_t	m_Flags;
+			uint32_t	m_FourCC;
+			uint32_t	m_RGBBitCount;
+			uint32_t	m_BitMasks[4];
+		};
+
+		struct DdsHeader
+		{
+			uint32_t		m_Size;
+			uint32_t		m_Flags;
+			uint32_t		m_Height;
+			uint32_t		m_Width;
+			uint32_t		m_PitchOrLinearSize;
+			uint32_t		m_Depth;
+			uint32_t		m_MipmapsCount;
+			uint32_t		m_Reserved1[11];
+			DdsPixelFormat	m_PixelFormat;
+			uint32_t		m_Caps[4];
+			uint32_t		m_Reserved2;
+		};
+
+		struct DdsHeaderDxt10
+		{
+			uint32_t	m_DxgiFormat;
+			uint32_t	m_ResourceDimension;
+			uint32_t	m_MiscFlag;
+			uint32_t	m_ArraySize;
+			uint32_t	m_MiscFlags2;
+		};
+
+		struct Ktx2Header
+		{
+			unsigned char	m_Identifier[12];
+			uint32_t		m_VkFormat;
+			uint32_t		m_TypeSize;
+			uint32_t		m_PixelWidth;
+			uint32_t		m_PixelHeight;
+			uint32_t		m_PixelDepth;
+			uint32_t		m_LayersCount;
+			uint32_t		m_FacesCount;
+			uint32_t		m_LevelsCount;
+			uint32_t		m_SupercompressionScheme;
+			uint32_t		m_DfdByteOffset;
+			uint32_t		m_DfdByteLength;
+			uint32_t		m_KvdByteOffset;
+			uint32_t		m_KvdByteLength;
+			uint64_t		m_SgdByteOffset;
+			uint64_t		m_SgdByteLength;
+		};
+
+		struct Ktx2LevelIndex
+		{
+			uint64_t	m_ByteOffset;
+			uint64_t	m_ByteLength;
+			uint64_t	m_UncompressedByteLength;
+		};
+
+		// Subresource to be copied from the file contents
+		struct SourceSubresource
+		{
+			CompressedTexture::Subresource	m_Subresource;
+			size_t							m_SourceOffset;
+		};
+
+		uint32_t MakeFourCC(char a, char b, char c, char d)
+		{
+			return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+		}
+
+		VkFormat GetFormatFromFourCC(uint32_t fourCC)
+		{
+			if (MakeFourCC('D', 'X', 'T', '1') == fourCC)
+			{
+				return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+			}
+			if ((MakeFourCC('D', 'X', 'T', '2') == fourCC) || (MakeFourCC('D', 'X', 'T', '3') == fourCC))
+			{
+				return VK_FORMAT_BC2_UNORM_BLOCK;
+			}
+			if ((MakeFourCC('D', 'X', 'T', '4') == fourCC) || (MakeFourCC('D', 'X', 'T', '5') == fourCC))
+			{
+				return VK_FORMAT_BC3_UNORM_BLOCK;
+			}
+			if ((MakeFourCC('A', 'T', 'I', '1') == fourCC) || (MakeFourCC('B', 'C', '4', 'U') == fourCC))
+			{
+				return VK_FORMAT_BC4_UNORM_BLOCK;
+			}
+			if (MakeFourCC('B', 'C', '4', 'S') == fourCC)
+			{
+				return VK_FORMAT_BC4_SNORM_BLOCK;
+			}
+			if ((MakeFourCC('A', 'T', 'I', '2') == fourCC) || (MakeFourCC('B', 'C', '5', 'U') == fourCC))
+			{
+				return VK_FORMAT_BC5_UNORM_BLOCK;
+			}
+			if (MakeFourCC('B', 'C', '5', 'S') == fourCC)
+			{
+				return VK_FORMAT_BC5_SNORM_BLOCK;
+			}
+			return VK_FORMAT_UNDEFINED;
+		}
+
+		VkFormat GetFormatFromDxgiFormat(uint32_t dxgiFormat)
+		{
+			switch (dxgiFormat)
+			{
+			case 71: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+			case 72: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+			case 74: return VK_FORMAT_BC2_UNORM_BLOCK;
+			case 75: return VK_FORMAT_BC2_SRGB_BLOCK;
+			case 77: return VK_FORMAT_BC3_UNORM_BLOCK;
+			case 78: return VK_FORMAT_BC3_SRGB_BLOCK;
+			case 80: return VK_FORMAT_BC4_UNORM_BLOCK;
+			case 81: return VK_FORMAT_BC4_SNORM_BLOCK;
+			case 83: return VK_FORMAT_BC5_UNORM_BLOCK;
+			case 84: return VK_FORMAT_BC5_SNORM_BLOCK;
+			case 95: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+			case 96: return VK_FORMAT_BC6H_SFLOAT_BLOCK;
+			case 98: return VK_FORMAT_BC7_UNORM_BLOCK;
+			case 99: return VK_FORMAT_BC7_SRGB_BLOCK;
+			default: return VK_FORMAT_UNDEFINED;
+			}
+		}
+
+		uint32_t GetLevelDimension(uint32_t dimension, uint32_t level)
+		{
+			dimension >>= level;
+			return dimension > 0 ? dimension : 1;
+		}
+
+		VkExtent3D GetLevelSize(VkExtent3D const &size, uint32_t level)
+		{
+			return { GetLevelDimension(size.width, level), GetLevelDimension(size.height, level), GetLevelDimension(size.depth, level) };
+		}
+
+		VkDeviceSize GetSubresourceDataSize(VkFormat format, VkExtent3D const &size)
+		{
+			uint32_t blockWidth;
+			uint32_t blockHeight;
+			uint32_t blockSize;
+			GetCompressedFormatBlockInfo(format, blockWidth, blockHeight, blockSize);
+
+			VkDeviceSize blocksInRow = (size.width + blockWidth - 1) / blockWidth;
+			VkDeviceSize blockRows = (size.height + blockHeight - 1) / blockHeight;
+			return blocksInRow * blockRows * size.depth * blockSize;
+		}
+
+		bool IsLevelLoaded(uint32_t level, uint32_t mostDetailedMipLevel, uint32_t mipLevelsCount)
+		{
+			return (level >= mostDetailedMipLevel) && (level - mostDetailedMipLevel < mipLevelsCount);
+		}
+
+		// Subresources are repacked, as offsets in files don't have to be aligned to the block size
+		bool CopySubresources(std::vector<unsigned char> const &contents, std::vector<SourceSubresource> const &sources, CompressedTexture &texture)
+		{
+			VkDeviceSize dataSize = 0;
+			for (auto const &source : sources)
+			{
+				if (source.m_SourceOffset + source.m_Subresource.m_DataSize > contents.size())
+				{
+					std::cout << "Could not load texture, file is truncated." << std::endl;
+					return false;
+				}
+				dataSize = (dataSize + 15) & ~static_cast<VkDeviceSize>(15);
+				dataSize += source.m_Subresource.m_DataSize;
+			}
+
+			texture.m_Data.resize(static_cast<size_t>(dataSize));
+			texture.m_Subresources.clear();
+			texture.m_Subresources.reserve(sources.size());
+
+			VkDeviceSize dataOffset = 0;
+			for (auto const &source : sources)
+			{
+				dataOffset = (dataOffset + 15) & ~static_cast<VkDeviceSize>(15);
+				texture.m_Subresources.push_back(source.m_Subresource);
+				texture.m_Subresources.back().m_DataOffset = dataOffset;
+				std::memcpy(&texture.m_Data[static_cast<size_t>(dataOffset)], &contents[source.m_SourceOffset],
+					static_cast<size_t>(source.m_Subresource.m_DataSize));
+				dataOffset += source.m_Subresource.m_DataSize;
+			}
+			return true;
+		}
+
+		bool LoadDdsTexture(std::vector<unsigned char> const &contents, uint32_t mostDetailedMipLevel, uint32_t mipLevelsCount, CompressedTexture &texture)
+		{
+			size_t dataOffset = sizeof(uint32_t) + sizeof(DdsHeader);
+			if (contents.size() < dataOffset)
+			{
+				std::cout << "Could not load texture, DDS header is truncated." << std::endl;
+				return false;
+			}
+
+			DdsHeader header;
+			std::memcpy(&header, &contents[sizeof(uint32_t)], sizeof(DdsHeader));
+			if ((sizeof(DdsHeader) != header.m_Size) || !(header.m_PixelFormat.m_Flags & DdsPixelFormatFlagFourCC))
+			{
+				std::cout << "Could not load texture, only block-compressed DDS files are supported." << std::endl;
+				return false;
+			}
+
+			texture.m_Size = { header.m_Width, header.m_Height, (header.m_Flags & DdsFlagDepth) && (header.m_Depth > 0) ? header.m_Depth : 1 };
+			texture.m_MipmapsCount = (header.m_Flags & DdsFlagMipmapsCount) && (header.m_MipmapsCount > 0) ? header.m_MipmapsCount : 1;
+			texture.m_LayersCount = 1;
+			texture.m_Cubemap = false;
+
+			if (MakeFourCC('D', 'X', '1', '0') == header.m_PixelFormat.m_FourCC)
+			{
+				if (contents.size() < dataOffset + sizeof(DdsHeaderDxt10))
+				{
+					std::cout << "Could not load texture, DDS header is truncated." << std::endl;
+					return false;
+				}
+
+				DdsHeaderDxt10 headerDxt10;
+				std::memcpy(&headerDxt10, &contents[dataOffset], sizeof(DdsHeaderDxt10));
+				dataOffset += sizeof(DdsHeaderDxt10);
+
+				texture.m_Format = GetFormatFromDxgiFormat(headerDxt10.m_DxgiFormat);
+				texture.m_Cubemap = 0 != (headerDxt10.m_MiscFlag & DdsMiscFlagTextureCube);
+				texture.m_LayersCount = (headerDxt10.m_ArraySize > 0 ? headerDxt10.m_ArraySize : 1) * (texture.m_Cubemap ? 6 : 1);
+				if (DdsResourceDimensionTexture3D != headerDxt10.m_ResourceDimension)
+				{
+					texture.m_Size.depth = 1;
+				}
+			}
+			else
+			{
+				texture.m_Format = GetFormatFromFourCC(header.m_PixelFormat.m_FourCC);
+				if (header.m_Caps[1] & DdsCaps2Cubemap)
+				{
+					if (DdsCaps2CubemapAllFaces != (header.m_Caps[1] & DdsCaps2CubemapAllFaces))
+					{
+						std::cout << "Could not load texture, DDS cubemap doesn't contain all faces." << std::endl;
+						return false;
+					}
+					texture.m_Cubemap = true;
+					texture.m_LayersCount = 6;
+				}
+			}
+
+			if (VK_FORMAT_UNDEFINED == texture.m_Format)
+			{
+				std::cout << "Could not load texture, DDS format is not supported." << std::endl;
+				return false;
+			}
+
+			// Each layer stores its whole mipmap chain
+			std::vector<SourceSubresource> sources;
+			for (uint32_t layer = 0; layer < texture.m_LayersCount; ++layer)
+			{
+				for (uint32_t level = 0; level < texture.m_MipmapsCount; ++level)
+				{
+					VkExtent3D levelSize = GetLevelSize(texture.m_Size, level);
+					VkDeviceSize levelDataSize = GetSubresourceDataSize(texture.m_Format, levelSize);
+					if (IsLevelLoaded(level, mostDetailedMipLevel, mipLevelsCount))
+					{
+						sources.push_back({ { level, layer, levelSize, 0, levelDataSize }, dataOffset });
+					}
+					dataOffset += static_cast<size_t>(levelDataSize);
+				}
+			}
+			return CopySubresources(contents, sources, texture);
+		}
+
+		bool LoadKtx2Texture(std::vector<unsigned char> const &contents, uint32_t mostDetailedMipLevel, uint32_t mipLevelsCount, CompressedTexture &texture)
+		{
+			if (contents.size() < sizeof(Ktx2Header))
+			{
+				std::cout << "Could not load texture, KTX2 header is truncated." << std::endl;
+				return false;
+			}
+
+			Ktx2Header header;
+			std::memcpy(&header, &contents[0], sizeof(Ktx2Header));
+			if (0 != header.m_SupercompressionScheme)
+			{
+				std::cout << "Could not load texture, supercompressed KTX2 files are not supported." << std::endl;
+				return false;
+			}
+
+			uint32_t blockWidth;
+			uint32_t blockHeight;
+			uint32_t blockSize;
+			texture.m_Format = static_cast<VkFormat>(header.m_VkFormat);
+			if (!GetCompressedFormatBlockInfo(texture.m_Format, blockWidth, blockHeight, blockSize))
+			{
+				std::cout << "Could not load texture, only block-compressed KTX2 files are supported." << std::endl;
+				return false;
+			}
+
+			// Zero dimensions, layers or levels denote 1D, 2D and non-array textures or the lack of a mipmap chain
+			uint32_t facesCount = header.m_FacesCount > 0 ? header.m_FacesCount : 1;
+			texture.m_Size = { header.m_PixelWidth, header.m_PixelHeight > 0 ? header.m_PixelHeight : 1, header.m_PixelDepth > 0 ? header.m_PixelDepth : 1 };
+			texture.m_MipmapsCount = header.m_LevelsCount > 0 ? header.m_LevelsCount : 1;
+			texture.m_LayersCount = (header.m_LayersCount > 0 ? header.m_LayersCount : 1) * facesCount;
+			texture.m_Cubemap = 6 == facesCount;
+
+			size_t levelIndexOffset = sizeof(Ktx2Header);
+			if (contents.size() < levelIndexOffset + texture.m_MipmapsCount * sizeof(Ktx2LevelIndex))
+			{
+				std::cout << "Could not load texture, KTX2 level index is truncated." << std::endl;
+				return false;
+			}
+
+			// Each level stores all of its layers and faces
+			std::vector<SourceSubresource> sources;
+			for (uint32_t level = mostDetailedMipLevel; (level < texture.m_MipmapsCount) && IsLevelLoaded(level, mostDetailedMipLevel, mipLevelsCount); ++level)
+			{
+				Ktx2LevelIndex levelIndex;
+				std::memcpy(&levelIndex, &contents[levelIndexOffset + level * sizeof(Ktx2LevelIndex)], sizeof(Ktx2LevelIndex));
+
+				VkExtent3D levelSize = GetLevelSize(texture.m_Size, level);
+				VkDeviceSize levelDataSize = GetSubresourceDataSize(texture.m_Format, levelSize);
+				if (levelIndex.m_ByteLength < levelDataSize * texture.m_LayersCount)
+				{
+					std::cout << "Could not load texture, KTX2 level is smaller than its contents." << std::endl;
+					return false;
+				}
+
+				for (uint32_t layer = 0; layer < texture.m_LayersCount; ++layer)
+				{
+					sources.push_back({ { level, layer, levelSize, 0, levelDataSize }, static_cast<size_t>(levelIndex.m_ByteOffset + layer * levelDataSize) });
+				}
+			}
+			return CopySubresources(contents, sources, texture);
+		}
+	}
+
+	bool GetCompressedFormatBlockInfo(VkFormat format, uint32_t &blockWidth, uint32_t &blockHeight, uint32_t &blockSize)
+	{
+		blockWidth = 4;
+		blockHeight = 4;
+
+		switch (format)
+		{
+		case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+		case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+		case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+		case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		case VK_FORMAT_BC4_UNORM_BLOCK:
+		case VK_FORMAT_BC4_SNORM_BLOCK:
+		case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+		case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+		case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+		case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+		case VK_FORMAT_EAC_R11_UNORM_BLOCK:
+		case VK_FORMAT_EAC_R11_SNORM_BLOCK:
+			blockSize = 8;
+			return true;
+		case VK_FORMAT_BC2_UNORM_BLOCK:
+		case VK_FORMAT_BC2_SRGB_BLOCK:
+		case VK_FORMAT_BC3_UNORM_BLOCK:
+		case VK_FORMAT_BC3_SRGB_BLOCK:
+		case VK_FORMAT_BC5_UNORM_BLOCK:
+		case VK_FORMAT_BC5_SNORM_BLOCK:
+		case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+		case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+		case VK_FORMAT_BC7_UNORM_BLOCK:
+		case VK_FORMAT_BC7_SRGB_BLOCK:
+		case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+		case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+		case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+		case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+			blockSize = 16;
+			return true;
+		default:
+			break;
+		}
+
+		// ASTC formats come in UNORM and SRGB pairs ordered by the block dimensions
+		if ((format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK) && (format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK))
+		{
+			static uint32_t const astcBlockDimensions[14][2] =
+			{
+				{ 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 },
+				{ 8, 8 }, { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 }
+			};
+			uint32_t index = (format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2;
+			blockWidth = astcBlockDimensions[index][0];
+			blockHeight = astcBlockDimensions[index][1];
+			blockSize = 16;
+			return true;
+		}
+
+		blockWidth = 1;
+		blockHeight = 1;
+		blockSize = 0;
+		return false;
+	}
+
+	bool LoadCompressedTextureFromFile(char const *filename, CompressedTexture &texture, uint32_t mostDetailedMipLevel, uint32_t mipLevelsCount)
+	{
+		std::vector<unsigned char> contents;
+		if (!GetBinaryFileContents(filename, contents))
+		{
+			return false;
+		}
+
+		bool result = false;
+		uint32_t magic = 0;
+		if (contents.size() >= sizeof(magic))
+		{
+			std::memcpy(&magic, &contents[0], sizeof(magic));
+		}
+
+		if (DdsMagic == magic)
+		{
+			result = LoadDdsTexture(contents, mostDetailedMipLevel, mipLevelsCount, texture);
+		}
+		else if ((contents.size() >= sizeof(Ktx2Identifier)) && (0 == std::memcmp(&contents[0], Ktx2Identifier, sizeof(Ktx2Identifier))))
+		{
+			result = LoadKtx2Texture(contents, mostDetailedMipLevel, mipLevelsCount, texture);
+		}
+		else
+		{
+			std::cout << "Could not load texture, '" << filename << "' is neither a KTX2 nor a DDS file." << std::endl;
+		}
+
+		if (!result)
+		{
+			texture.m_Data.clear();
+			texture.m_Subresources.clear();
+		}
+		return result;
+	}
+
+	void SpecifyCompressedTextureCopyRegions(CompressedTexture const &texture, std::vector<VkBufferImageCopy> &regions)
+	{
+		uint32_t blockWidth;
+		uint32_t blockHeight;
+		uint32_t blockSize;
+		GetCompressedFormatBlockInfo(texture.m_Format, blockWidth, blockHeight, blockSize);
+
+		regions.clear();
+		regions.reserve(texture.m_Subresources.size());
+		for (auto const &subresource : texture.m_Subresources)
+		{
+			// Pitches are given in texels, rounded up to whole blocks
+			regions.push_back(
+				{
+					subresource.m_DataOffset,												// VkDeviceSize               bufferOffset
+					(subresource.m_Size.width + blockWidth - 1) / blockWidth * blockWidth,	// uint32_t                   bufferRowLength
+					(subresource.m_Size.height + blockHeight - 1) / blockHeight * blockHeight,	// uint32_t                   bufferImageHeight
+					{																		// VkImageSubresourceLayers   imageSubresource
+						VK_IMAGE_ASPECT_COLOR_BIT,											// VkImageAspectFlags         aspectMask
+						subresource.m_MipLevel,												// uint32_t                   mipLevel
+						subresource.m_Layer,												// uint32_t                   baseArrayLayer
+						1																	// uint32_t                   layerCount
+					},
+					{ 0, 0, 0 },															// VkOffset3D                 imageOffset
+					subresource.m_Size														// VkExtent3D                 imageExtent
+				});
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "Common.h"
+
+namespace VulkanSampleFramework
+{
+	// Texture stored in its GPU format (e.g. BC1/BC3/BC5/BC7, ETC2 or ASTC blocks) with a precomputed mipmap chain,
+	// so its subresources may be copied to an image without any decoding
+	struct CompressedTexture
+	{
+		struct Subresource
+		{
+			uint32_t	m_MipLevel;
+			uint32_t	m_Layer;			// Faces of cubemaps are consecutive layers
+			VkExtent3D	m_Size;				// In texels, not rounded up to whole blocks
+			VkDeviceSize	m_DataOffset;	// Aligned to the block size
+			VkDeviceSize	m_DataSize;
+		};
+
+		VkFormat					m_Format;
+		VkExtent3D					m_Size;
+		uint32_t					m_MipmapsCount;
+		uint32_t					m_LayersCount;
+		bool						m_Cubemap;
+		std::vector<unsigned char>	m_Data;
+		std::vector<Subresource>	m_Subresources;
+	};
+
+	// Block dimensions in texels and block size in bytes of block-compressed formats, returns false for other formats
+	bool GetCompressedFormatBlockInfo(VkFormat format, uint32_t &blockWidth, uint32_t &blockHeight, uint32_t &blockSize);
+	// Recognizes KTX2 files (without supercompression) and DDS files (including the DX10 header extension) by their contents.
+	// Only subresources of the given range of levels are loaded, but the size and levels count describe the whole texture.
+	bool LoadCompressedTextureFromFile(char const *filename, CompressedTexture &texture, uint32_t mostDetailedMipLevel = 0,
+		uint32_t mipLevelsCount = VK_REMAINING_MIP_LEVELS);
+	// Regions for UseStagingBufferToUpdateImageRegionsWithDeviceLocalMemoryBound() with the whole texture data as a source
+	void SpecifyCompressedTextureCopyRegions(CompressedTexture const &texture, std::vector<VkBufferImageCopy> &regions);
+}
@@ -1,7 +1,16 @@
+#include <fstream>
+#include <atomic>
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
 #include "Tools.h"
+#include "SimdMath.h"
 
-#define TINYOBJLOADER_IMPLEMENTATION
-#include "../External/tiny_obj_loader.h"
+#if defined(SIMD_MATH_SSE2)
+#include <emmintrin.h>
+#endif
+
+#include "ObjParser.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "../External/stb_image.h"
@@ -21,63 +30,1146 @@ namespace VulkanSampleFramework
 			Vector3 const tangent = Normalize(faceTangent - normal * Dot(normal, faceTangent));
 
 			// Calculate handedness
-			float handedness = (Dot(Cross(normal, tangent), faceTangent) < 0.0f) ? -1.0f : 1.0f;
+			float handedness = (Dot(Cross(normal, tangent), faceBitangent) < 0.0f) ? -1.0f : 1.0f;
+
+			Vector3 const bitangent = handedness * Cross(normal, tangent);
+
+			tangentData[0] = tangent[0];
+			tangentData[1] = tangent[1];
+			tangentData[2] = tangent[2];
+
+			bitangentData[0] = bitangent[0];
+			bitangentData[1] = bitangent[1];
+			bitangentData[2] = bitangent[2];
+		}
+
+		// Layout of vertices loaded with normals, texture coordinates and tangent space vectors
+		size_t const NormalOffset = 3;
+		size_t const TexcoordOffset = 6;
+		size_t const TangentOffset = 8;
+		size_t const BitangentOffset = 11;
+		size_t const TangentSpaceVertexStride = BitangentOffset + 3;
+
+		size_t const TrianglesPerChunk = 4096;
+		size_t const MinimalVerticesPerThread = 65536;
+
+		// Ranges of triangles, each inside the vertex range of a single part
+		struct TriangleRange
+		{
+			size_t m_FirstTriangle;
+			size_t m_TrianglesCount;
+		};
+
+		std::vector<TriangleRange> PrepareTriangleChunks(Mesh const &mesh)
+		{
+			std::vector<TriangleRange> chunks;
+			for (auto & part : mesh.m_Parts)
+			{
+				size_t firstTriangle = part.m_VertexOffset / 3;
+				size_t trianglesCount = part.m_VertexCount / 3;
+				for (size_t offset = 0; offset < trianglesCount; offset += TrianglesPerChunk)
+				{
+					size_t count = trianglesCount - offset;
+					chunks.push_back({ firstTriangle + offset, count > TrianglesPerChunk ? TrianglesPerChunk : count });
+				}
+			}
+			return chunks;
+		}
+
+		// Chunks are taken by worker threads one at a time, so parts of different sizes are still balanced
+		void ProcessChunksInParallel(std::vector<TriangleRange> const &chunks, std::function<void(TriangleRange const &)> const &function)
+		{
+			std::atomic<size_t> nextChunk(0);
+			auto worker = [&]()
+			{
+				for (size_t chunk = nextChunk++; chunk < chunks.size(); chunk = nextChunk++)
+				{
+					function(chunks[chunk]);
+				}
+			};
+
+			size_t threadsCount = std::thread::hardware_concurrency();
+			threadsCount = threadsCount > chunks.size() ? chunks.size() : threadsCount;
+			std::vector<std::thread> threads;
+			for (size_t i = 1; i < threadsCount; ++i)
+			{
+				threads.emplace_back(worker);
+			}
+			worker();
+
+			for (auto & thread : threads)
+			{
+				thread.join();
+			}
+		}
+
+		void CalculateFaceTangentAndBitangent(float const *vertex1, float const *vertex2, float const *vertex3, Vector3 &faceTangent, Vector3 &faceBitangent)
+		{
+			float x1 = vertex2[0] - vertex1[0];
+			float x2 = vertex3[0] - vertex1[0];
+			float y1 = vertex2[1] - vertex1[1];
+			float y2 = vertex3[1] - vertex1[1];
+			float z1 = vertex2[2] - vertex1[2];
+			float z2 = vertex3[2] - vertex1[2];
+
+			float s1 = vertex2[TexcoordOffset] - vertex1[TexcoordOffset];
+			float s2 = vertex3[TexcoordOffset] - vertex1[TexcoordOffset];
+			float t1 = vertex2[TexcoordOffset + 1] - vertex1[TexcoordOffset + 1];
+			float t2 = vertex3[TexcoordOffset + 1] - vertex1[TexcoordOffset + 1];
+
+			float r = 1.0f / (s1 * t2 - s2 * t1);
+			faceTangent = { (t2 * x1 - t1 * x2) * r, (t2 * y1 - t1 * y2) * r, (t2 * z1 - t1 * z2) * r };
+			faceBitangent = { (s1 * x2 - s2 * x1) * r, (s1 * y2 - s2 * y1) * r, (s1 * z2 - s2 * z1) * r };
+		}
+
+		void GenerateTangentSpaceVectorsForTriangles(Mesh &mesh, TriangleRange const &range)
+		{
+			size_t triangle = range.m_FirstTriangle;
+			size_t const lastTriangle = range.m_FirstTriangle + range.m_TrianglesCount;
+			float *data = mesh.m_Data.data();
+
+#if defined(SIMD_MATH_SSE2)
+			// Four triangles at once, each lane holds values of a different triangle
+			for (; triangle + 4 <= lastTriangle; triangle += 4)
+			{
+				float *vertices[4][3];
+				for (int lane = 0; lane < 4; ++lane)
+				{
+					for (int corner = 0; corner < 3; ++corner)
+					{
+						vertices[lane][corner] = data + (3 * (triangle + lane) + corner) * TangentSpaceVertexStride;
+					}
+				}
+				auto load = [&vertices](int corner, size_t offset) -> __m128
+				{
+					return _mm_setr_ps(vertices[0][corner][offset], vertices[1][corner][offset], vertices[2][corner][offset], vertices[3][corner][offset]);
+				};
+				auto store = [&vertices](int corner, size_t offset, __m128 value)
+				{
+					alignas(16) float values[4];
+					_mm_store_ps(values, value);
+					for (int lane = 0; lane < 4; ++lane)
+					{
+						vertices[lane][corner][offset] = values[lane];
+					}
+				};
+
+				__m128 x1 = _mm_sub_ps(load(1, 0), load(0, 0));
+				__m128 x2 = _mm_sub_ps(load(2, 0), load(0, 0));
+				__m128 y1 = _mm_sub_ps(load(1, 1), load(0, 1));
+				__m128 y2 = _mm_sub_ps(load(2, 1), load(0, 1));
+				__m128 z1 = _mm_sub_ps(load(1, 2), load(0, 2));
+				__m128 z2 = _mm_sub_ps(load(2, 2), load(0, 2));
+				__m128 s1 = _mm_sub_ps(load(1, TexcoordOffset), load(0, TexcoordOffset));
+				__m128 s2 = _mm_sub_ps(load(2, TexcoordOffset), load(0, TexcoordOffset));
+				__m128 t1 = _mm_sub_ps(load(1, TexcoordOffset + 1), load(0, TexcoordOffset + 1));
+				__m128 t2 = _mm_sub_ps(load(2, TexcoordOffset + 1), load(0, TexcoordOffset + 1));
+
+				__m128 r = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sub_ps(_mm_mul_ps(s1, t2), _mm_mul_ps(s2, t1)));
+				__m128 faceTangent[3] =
+				{
+					_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(t2, x1), _mm_mul_ps(t1, x2)), r),
+					_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(t2, y1), _mm_mul_ps(t1, y2)), r),
+					_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(t2, z1), _mm_mul_ps(t1, z2)), r)
+				};
+				__m128 faceBitangent[3] =
+				{
+					_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(s1, x2), _mm_mul_ps(s2, x1)), r),
+					_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(s1, y2), _mm_mul_ps(s2, y1)), r),
+					_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(s1, z2), _mm_mul_ps(s2, z1)), r)
+				};
+
+				for (int corner = 0; corner < 3; ++corner)
+				{
+					__m128 normal[3] = { load(corner, NormalOffset), load(corner, NormalOffset + 1), load(corner, NormalOffset + 2) };
+
+					// Gram-Schmidt orthogonalize
+					__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normal[0], faceTangent[0]), _mm_mul_ps(normal[1], faceTangent[1])), _mm_mul_ps(normal[2], faceTangent[2]));
+					__m128 tangent[3];
+					for (int i = 0; i < 3; ++i)
+					{
+						tangent[i] = _mm_sub_ps(faceTangent[i], _mm_mul_ps(normal[i], dot));
+					}
+					__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tangent[0], tangent[0]), _mm_mul_ps(tangent[1], tangent[1])), _mm_mul_ps(tangent[2], tangent[2])));
+					for (int i = 0; i < 3; ++i)
+					{
+						tangent[i] = _mm_div_ps(tangent[i], length);
+					}
+
+					// Calculate handedness
+					__m128 bitangent[3] =
+					{
+						_mm_sub_ps(_mm_mul_ps(normal[1], tangent[2]), _mm_mul_ps(normal[2], tangent[1])),
+						_mm_sub_ps(_mm_mul_ps(normal[2], tangent[0]), _mm_mul_ps(normal[0], tangent[2])),
+						_mm_sub_ps(_mm_mul_ps(normal[0], tangent[1]), _mm_mul_ps(normal[1], tangent[0]))
+					};
+					__m128 handednessDot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bitangent[0], faceBitangent[0]), _mm_mul_ps(bitangent[1], faceBitangent[1])),
+						_mm_mul_ps(bitangent[2], faceBitangent[2]));
+					// Sign bit of negative products flips the bitangent
+					__m128 handednessSign = _mm_and_ps(_mm_cmplt_ps(handednessDot, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+
+					for (int i = 0; i < 3; ++i)
+					{
+						store(corner, TangentOffset + i, tangent[i]);
+						store(corner, BitangentOffset + i, _mm_xor_ps(bitangent[i], handednessSign));
+					}
+				}
+			}
+#endif
+			for (; triangle < lastTriangle; ++triangle)
+			{
+				float *vertex1 = data + 3 * triangle * TangentSpaceVertexStride;
+				float *vertex2 = vertex1 + TangentSpaceVertexStride;
+				float *vertex3 = vertex2 + TangentSpaceVertexStride;
+
+				Vector3 faceTangent;
+				Vector3 faceBitangent;
+				CalculateFaceTangentAndBitangent(vertex1, vertex2, vertex3, faceTangent, faceBitangent);
+
+				CalculateTangentAndBitangent(vertex1 + NormalOffset, faceTangent, faceBitangent, vertex1 + TangentOffset, vertex1 + BitangentOffset);
+				CalculateTangentAndBitangent(vertex2 + NormalOffset, faceTangent, faceBitangent, vertex2 + TangentOffset, vertex2 + BitangentOffset);
+				CalculateTangentAndBitangent(vertex3 + NormalOffset, faceTangent, faceBitangent, vertex3 + TangentOffset, vertex3 + BitangentOffset);
+			}
+		}
+
+		// Vertices are shared when their position, normal and texture coordinates are bitwise equal
+		struct SharedVertexKey
+		{
+			std::array<float, TangentOffset> m_Attributes;
+
+			bool operator== (SharedVertexKey const &other) const
+			{
+				return 0 == std::memcmp(m_Attributes.data(), other.m_Attributes.data(), sizeof(m_Attributes));
+			}
+		};
+
+		struct SharedVertexKeyHash
+		{
+			size_t operator() (SharedVertexKey const &key) const
+			{
+				uint32_t words[TangentOffset];
+				std::memcpy(words, key.m_Attributes.data(), sizeof(words));
+				size_t hash = 14695981039346656037ull;
+				for (auto word : words)
+				{
+					hash = (hash ^ word) * 1099511628211ull;
+				}
+				return hash;
+			}
+		};
+
+		// Face vectors are accumulated for all corners sharing a vertex, weighted by the angle of the corner, and orthogonalized per vertex
+		// afterwards, which is how MikkTSpace smooths tangent frames of indexed meshes
+		void GenerateAveragedTangentSpaceVectors(Mesh &mesh, std::vector<TriangleRange> const &chunks)
+		{
+			size_t const verticesCount = mesh.m_Data.size() / TangentSpaceVertexStride;
+			std::vector<Vector3> cornerTangents(verticesCount, Vector3{ 0.0f, 0.0f, 0.0f });
+			std::vector<Vector3> cornerBitangents(verticesCount, Vector3{ 0.0f, 0.0f, 0.0f });
+
+			ProcessChunksInParallel(chunks, [&mesh, &cornerTangents, &cornerBitangents](TriangleRange const &range)
+			{
+				for (size_t triangle = range.m_FirstTriangle; triangle < range.m_FirstTriangle + range.m_TrianglesCount; ++triangle)
+				{
+					float const *vertices[3];
+					for (size_t corner = 0; corner < 3; ++corner)
+					{
+						vertices[corner] = mesh.m_Data.data() + (3 * triangle + corner) * TangentSpaceVertexStride;
+					}
+
+					Vector3 faceTangent;
+					Vector3 faceBitangent;
+					CalculateFaceTangentAndBitangent(vertices[0], vertices[1], vertices[2], faceTangent, faceBitangent);
+
+					for (size_t corner = 0; corner < 3; ++corner)
+					{
+						Vector3 const position = { vertices[corner][0], vertices[corner][1], vertices[corner][2] };
+						float const *next = vertices[(corner + 1) % 3];
+						float const *previous = vertices[(corner + 2) % 3];
+						Vector3 const toNext = Vector3{ next[0], next[1], next[2] } - position;
+						Vector3 const toPrevious = Vector3{ previous[0], previous[1], previous[2] } - position;
+
+						float cosine = Dot(Normalize(toNext), Normalize(toPrevious));
+						cosine = cosine > 1.0f ? 1.0f : (cosine < -1.0f ? -1.0f : cosine);
+						float angle = std::acos(cosine);
+
+						cornerTangents[3 * triangle + corner] = angle * faceTangent;
+						cornerBitangents[3 * triangle + corner] = angle * faceBitangent;
+					}
+				}
+			});
+
+			// Grouping is sequential, but linear in the number of vertices
+			std::unordered_map<SharedVertexKey, uint32_t, SharedVertexKeyHash> groups;
+			groups.reserve(verticesCount);
+			std::vector<uint32_t> vertexGroups(verticesCount);
+			std::vector<Vector3> groupTangents;
+			std::vector<Vector3> groupBitangents;
+			groupTangents.reserve(verticesCount);
+			groupBitangents.reserve(verticesCount);
+
+			for (size_t vertex = 0; vertex < verticesCount; ++vertex)
+			{
+				SharedVertexKey key;
+				std::memcpy(key.m_Attributes.data(), &mesh.m_Data[vertex * TangentSpaceVertexStride], sizeof(key.m_Attributes));
+
+				auto group = groups.insert({ key, static_cast<uint32_t>(groupTangents.size()) });
+				if (group.second)
+				{
+					groupTangents.push_back({ 0.0f, 0.0f, 0.0f });
+					groupBitangents.push_back({ 0.0f, 0.0f, 0.0f });
+				}
+				uint32_t groupIndex = group.first->second;
+				vertexGroups[vertex] = groupIndex;
+				groupTangents[groupIndex] = groupTangents[groupIndex] + cornerTangents[vertex];
+				groupBitangents[groupIndex] = groupBitangents[groupIndex] + cornerBitangents[vertex];
+			}
+
+			ProcessChunksInParallel(chunks, [&mesh, &vertexGroups, &groupTangents, &groupBitangents](TriangleRange const &range)
+			{
+				for (size_t vertex = 3 * range.m_FirstTriangle; vertex < 3 * (range.m_FirstTriangle + range.m_TrianglesCount); ++vertex)
+				{
+					float *vertexData = &mesh.m_Data[vertex * TangentSpaceVertexStride];
+					CalculateTangentAndBitangent(vertexData + NormalOffset, groupTangents[vertexGroups[vertex]], groupBitangents[vertexGroups[vertex]],
+						vertexData + TangentOffset, vertexData + BitangentOffset);
+				}
+			});
+		}
+
+		void GenerateTangentSpaceVectors(Mesh & mesh, bool averageSharedVertices)
+		{
+			// Each triangle is processed exactly once, only inside the vertex range of the part it belongs to
+			std::vector<TriangleRange> chunks = PrepareTriangleChunks(mesh);
+			if (chunks.empty())
+			{
+				return;
+			}
+
+			if (averageSharedVertices)
+			{
+				GenerateAveragedTangentSpaceVectors(mesh, chunks);
+			}
+			else
+			{
+				ProcessChunksInParallel(chunks, [&mesh](TriangleRange const &range)
+				{
+					GenerateTangentSpaceVectorsForTriangles(mesh, range);
+				});
+			}
+		}
+
+		uint32_t GetVertexStride(VertexLayout const &layout)
+		{
+			return 3 + (layout.m_HasNormals ? 3 : 0) + (layout.m_HasTexcoords ? 2 : 0) + (layout.m_HasTangentSpace ? 6 : 0);
+		}
+
+		// Compares first m_Size floats of vertices identified by their indices, so vertices don't have to be copied into keys
+		struct VertexDataHash
+		{
+			float const	*m_Data;
+			uint32_t	m_Stride;
+			uint32_t	m_Size;
+
+			size_t operator() (uint32_t vertex) const
+			{
+				size_t hash = 14695981039346656037ull;
+				for (uint32_t i = 0; i < m_Size; ++i)
+				{
+					uint32_t word;
+					std::memcpy(&word, &m_Data[vertex * m_Stride + i], sizeof(word));
+					hash = (hash ^ word) * 1099511628211ull;
+				}
+				return hash;
+			}
+		};
+
+		struct VertexDataEqual
+		{
+			float const	*m_Data;
+			uint32_t	m_Stride;
+			uint32_t	m_Size;
+
+			bool operator() (uint32_t left, uint32_t right) const
+			{
+				return 0 == std::memcmp(&m_Data[left * m_Stride], &m_Data[right * m_Stride], m_Size * sizeof(float));
+			}
+		};
+
+		// Assigns the same identifier to vertices with bitwise equal first "size" floats
+		uint32_t IdentifySharedVertices(Mesh const &mesh, uint32_t stride, uint32_t size, Mesh::Part const &part, std::vector<uint32_t> &identifiers,
+			std::vector<uint32_t> *representatives)
+		{
+			VertexDataHash hash = { mesh.m_Data.data(), stride, size };
+			VertexDataEqual equal = { mesh.m_Data.data(), stride, size };
+			std::unordered_map<uint32_t, uint32_t, VertexDataHash, VertexDataEqual> groups(part.m_VertexCount, hash, equal);
+
+			identifiers.resize(part.m_VertexCount);
+			for (uint32_t i = 0; i < part.m_VertexCount; ++i)
+			{
+				auto group = groups.insert({ part.m_VertexOffset + i, static_cast<uint32_t>(groups.size()) });
+				identifiers[i] = group.first->second;
+				if (group.second && representatives)
+				{
+					representatives->push_back(part.m_VertexOffset + i);
+				}
+			}
+			return static_cast<uint32_t>(groups.size());
+		}
+
+		// Ritter's approximation, within a few percent of the minimal sphere
+		Vector4 CalculateBoundingSphere(std::vector<Vector3> const &points)
+		{
+			auto farthest = [&points](Vector3 const &from) -> Vector3
+			{
+				Vector3 result = points[0];
+				float distance = 0.0f;
+				for (auto & point : points)
+				{
+					Vector3 difference = point - from;
+					float current = Dot(difference, difference);
+					if (current > distance)
+					{
+						distance = current;
+						result = point;
+					}
+				}
+				return result;
+			};
+
+			Vector3 first = farthest(points[0]);
+			Vector3 second = farthest(first);
+			Vector3 center = 0.5f * (first + second);
+			Vector3 diameter = second - first;
+			float radius = 0.5f * std::sqrt(Dot(diameter, diameter));
+
+			for (auto & point : points)
+			{
+				Vector3 difference = point - center;
+				float distance = std::sqrt(Dot(difference, difference));
+				if (distance > radius)
+				{
+					float newRadius = 0.5f * (radius + distance);
+					center = center + ((newRadius - radius) / distance) * difference;
+					radius = newRadius;
+				}
+			}
+			return { center[0], center[1], center[2], radius };
+		}
+
+		// Cone containing normals of all triangles, with an apex placed so that the cone lies behind all of them. Meshlets with normals spread
+		// over more than a hemisphere get a zero axis and cutoff of 1, so they are never culled.
+		void CalculateNormalCone(std::vector<Vector3> const &points, std::vector<unsigned char> const &triangleIndices, size_t firstIndex, uint32_t triangleCount,
+			Vector4 const &boundingSphere, Meshlet &meshlet)
+		{
+			meshlet.m_ConeApex = { 0.0f, 0.0f, 0.0f, 0.0f };
+			meshlet.m_ConeAxisAndCutoff = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+			std::vector<Vector3> normals;
+			Vector3 axis = { 0.0f, 0.0f, 0.0f };
+			for (uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+			{
+				unsigned char const *indices = &triangleIndices[firstIndex + 3 * triangle];
+				Vector3 normal = Cross(points[indices[1]] - points[indices[0]], points[indices[2]] - points[indices[0]]);
+				float length = std::sqrt(Dot(normal, normal));
+				// Degenerate triangles are invisible, so they don't constrain the cone
+				normals.push_back(length > 0.0f ? (1.0f / length) * normal : Vector3{ 0.0f, 0.0f, 0.0f });
+				axis = axis + normals.back();
+			}
+
+			float axisLength = std::sqrt(Dot(axis, axis));
+			if (0.0f == axisLength)
+			{
+				return;
+			}
+			axis = (1.0f / axisLength) * axis;
+
+			float minimalDot = 1.0f;
+			for (auto & normal : normals)
+			{
+				if (Dot(normal, normal) > 0.0f)
+				{
+					float dot = Dot(normal, axis);
+					minimalDot = dot < minimalDot ? dot : minimalDot;
+				}
+			}
+			if (minimalDot <= 0.0f)
+			{
+				return;
+			}
+
+			// Apex is moved along the axis until all triangle planes are in front of it
+			Vector3 center = { boundingSphere[0], boundingSphere[1], boundingSphere[2] };
+			float maximalDistance = 0.0f;
+			for (uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+			{
+				Vector3 const &normal = normals[triangle];
+				float axisDot = Dot(normal, axis);
+				if (axisDot > 0.0f)
+				{
+					float distance = Dot(center - points[triangleIndices[firstIndex + 3 * triangle]], normal) / axisDot;
+					maximalDistance = distance > maximalDistance ? distance : maximalDistance;
+				}
+			}
+
+			Vector3 apex = center - maximalDistance * axis;
+			meshlet.m_ConeApex = { apex[0], apex[1], apex[2], 0.0f };
+			meshlet.m_ConeAxisAndCutoff = { axis[0], axis[1], axis[2], std::sqrt(1.0f - minimalDot * minimalDot) };
+		}
+
+		// Greedily grows each meshlet with adjacent triangles that add the fewest new vertices. Adjacency is based on positions only,
+		// so meshlets also grow across texture and normal seams.
+		// Only meshlets, vertex and triangle indices of the given data are filled
+		void BuildPartMeshlets(Mesh const &mesh, uint32_t stride, Mesh::Part const &part, uint32_t maxVertices, uint32_t maxTriangles, MeshletData &meshlets)
+		{
+			std::vector<uint32_t> vertexIdentifiers;
+			std::vector<uint32_t> uniqueVertices;
+			IdentifySharedVertices(mesh, stride, stride, part, vertexIdentifiers, &uniqueVertices);
+			std::vector<uint32_t> positionIdentifiers;
+			uint32_t positionsCount = IdentifySharedVertices(mesh, stride, 3, part, positionIdentifiers, nullptr);
+
+			uint32_t trianglesCount = part.m_VertexCount / 3;
+
+			// Triangles sharing each position, in the compressed sparse row format
+			std::vector<uint32_t> adjacencyOffsets(positionsCount + 1, 0);
+			for (uint32_t i = 0; i < 3 * trianglesCount; ++i)
+			{
+				++adjacencyOffsets[positionIdentifiers[i] + 1];
+			}
+			for (uint32_t i = 0; i < positionsCount; ++i)
+			{
+				adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+			}
+			std::vector<uint32_t> adjacency(adjacencyOffsets.back());
+			std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32_t i = 0; i < 3 * trianglesCount; ++i)
+			{
+				adjacency[adjacencyFill[positionIdentifiers[i]]++] = i / 3;
+			}
+
+			std::vector<bool> usedTriangles(trianglesCount, false);
+			std::vector<int32_t> localIndices(uniqueVertices.size(), -1);
+			std::vector<uint32_t> meshletVertices;
+			std::vector<uint32_t> meshletTriangles;
+			uint32_t nextSeed = 0;
+
+			auto countNewVertices = [&](uint32_t triangle) -> uint32_t
+			{
+				uint32_t const *corners = &vertexIdentifiers[3 * triangle];
+				return (localIndices[corners[0]] < 0 ? 1 : 0) +
+					((localIndices[corners[1]] < 0) && (corners[1] != corners[0]) ? 1 : 0) +
+					((localIndices[corners[2]] < 0) && (corners[2] != corners[0]) && (corners[2] != corners[1]) ? 1 : 0);
+			};
+
+			auto addTriangle = [&](uint32_t triangle)
+			{
+				for (uint32_t corner = 0; corner < 3; ++corner)
+				{
+					uint32_t vertex = vertexIdentifiers[3 * triangle + corner];
+					if (localIndices[vertex] < 0)
+					{
+						localIndices[vertex] = static_cast<int32_t>(meshletVertices.size());
+						meshletVertices.push_back(vertex);
+					}
+				}
+				meshletTriangles.push_back(triangle);
+				usedTriangles[triangle] = true;
+			};
+
+			while (true)
+			{
+				while ((nextSeed < trianglesCount) && usedTriangles[nextSeed])
+				{
+					++nextSeed;
+				}
+				if (nextSeed == trianglesCount)
+				{
+					break;
+				}
+
+				meshletVertices.clear();
+				meshletTriangles.clear();
+				addTriangle(nextSeed);
+
+				while (meshletTriangles.size() < maxTriangles)
+				{
+					uint32_t bestTriangle = trianglesCount;
+					uint32_t bestNewVertices = 4;
+					for (size_t i = 0; (i < meshletVertices.size()) && (0 != bestNewVertices); ++i)
+					{
+						uint32_t position = positionIdentifiers[uniqueVertices[meshletVertices[i]] - part.m_VertexOffset];
+						for (uint32_t j = adjacencyOffsets[position]; j < adjacencyOffsets[position + 1]; ++j)
+						{
+							uint32_t triangle = adjacency[j];
+							if (usedTriangles[triangle])
+							{
+								continue;
+							}
+							uint32_t newVertices = countNewVertices(triangle);
+							if ((newVertices < bestNewVertices) && (meshletVertices.size() + newVertices <= maxVertices))
+							{
+								bestTriangle = triangle;
+								bestNewVertices = newVertices;
+								if (0 == newVertices)
+								{
+									break;
+								}
+							}
+						}
+					}
+					// Disconnected triangles start a new meshlet, so meshlets stay spatially compact
+					if (trianglesCount == bestTriangle)
+					{
+						break;
+					}
+					addTriangle(bestTriangle);
+				}
+
+				Meshlet meshlet = {};
+				meshlet.m_FirstVertex = static_cast<uint32_t>(meshlets.m_VertexIndices.size());
+				meshlet.m_VertexCount = static_cast<uint32_t>(meshletVertices.size());
+				meshlet.m_TriangleOffset = static_cast<uint32_t>(meshlets.m_TriangleIndices.size());
+				meshlet.m_TriangleCount = static_cast<uint32_t>(meshletTriangles.size());
+
+				std::vector<Vector3> points;
+				for (auto vertex : meshletVertices)
+				{
+					float const *position = &mesh.m_Data[uniqueVertices[vertex] * stride];
+					points.push_back({ position[0], position[1], position[2] });
+					meshlets.m_VertexIndices.push_back(uniqueVertices[vertex]);
+				}
+				for (auto triangle : meshletTriangles)
+				{
+					for (uint32_t corner = 0; corner < 3; ++corner)
+					{
+						meshlets.m_TriangleIndices.push_back(static_cast<unsigned char>(localIndices[vertexIdentifiers[3 * triangle + corner]]));
+					}
+				}
+				// Triangles of each meshlet start at a 4-byte boundary, so shaders can read them as 32-bit words
+				while (0 != meshlets.m_TriangleIndices.size() % 4)
+				{
+					meshlets.m_TriangleIndices.push_back(0);
+				}
+
+				meshlet.m_BoundingSphere = CalculateBoundingSphere(points);
+				CalculateNormalCone(points, meshlets.m_TriangleIndices, meshlet.m_TriangleOffset, meshlet.m_TriangleCount, meshlet.m_BoundingSphere, meshlet);
+				meshlets.m_Meshlets.push_back(meshlet);
+
+				for (auto vertex : meshletVertices)
+				{
+					localIndices[vertex] = -1;
+				}
+			}
+		}
+
+		struct MeshletFileHeader
+		{
+			char		m_Magic[4];
+			uint32_t	m_Version;
+			uint32_t	m_MeshletsCount;
+			uint32_t	m_VertexIndicesCount;
+			uint32_t	m_TriangleIndicesSize;
+			uint32_t	m_PartsCount;
+		};
+
+		char const MeshletFileMagic[4] = { 'M', 'S', 'H', 'L' };
+		uint32_t const MeshletFileVersion = 1;
+
+		// Symmetric 4x4 matrix of a sum of squared distances to planes: a2, ab, ac, ad, b2, bc, bd, c2, cd, d2
+		struct Quadric
+		{
+			std::array<double, 10>	m_Values;
+			double					m_Weight;	// Sum of weights of all planes
+		};
+
+		void AddPlaneToQuadric(Quadric &quadric, Vector3 const &normal, float distance, double weight)
+		{
+			double a = normal[0];
+			double b = normal[1];
+			double c = normal[2];
+			double d = distance;
+			double const values[10] = { a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d };
+			for (int i = 0; i < 10; ++i)
+			{
+				quadric.m_Values[i] += weight * values[i];
+			}
+			quadric.m_Weight += weight;
+		}
+
+		double EvaluateQuadric(Quadric const &quadric, Vector3 const &point)
+		{
+			double x = point[0];
+			double y = point[1];
+			double z = point[2];
+			std::array<double, 10> const &q = quadric.m_Values;
+			double result = q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 2.0 * q[3] * x +
+				q[4] * y * y + 2.0 * q[5] * y * z + 2.0 * q[6] * y +
+				q[7] * z * z + 2.0 * q[8] * z + q[9];
+			return result > 0.0 ? result : 0.0;
+		}
+
+		// Border planes are weighted more than surface planes, so borders don't shrink
+		double const BorderQuadricWeight = 10.0;
+		// Penalty (relative to the squared edge length) for collapsing vertices with different normal vectors
+		double const NormalDeviationWeight = 1.0;
+
+		struct EdgeCollapse
+		{
+			double		m_Cost;
+			uint32_t	m_Source;
+			uint32_t	m_Target;
+			uint32_t	m_SourceVersion;
+			uint32_t	m_TargetVersion;
+
+			bool operator< (EdgeCollapse const &other) const
+			{
+				// Priority queue pops the largest element first
+				return m_Cost > other.m_Cost;
+			}
+		};
+
+		// Half-edge collapses move vertices onto their neighbors, so no new attribute values have to be interpolated. Levels are captured
+		// from a single sequence of collapses, each time the number of remaining triangles reaches the next target.
+		class PartSimplifier
+		{
+		public:
+			PartSimplifier(Mesh const &mesh, uint32_t stride, uint32_t attributesSize, Mesh::Part const &part) :
+				m_Mesh(mesh),
+				m_Stride(stride),
+				m_AttributesSize(attributesSize),
+				m_MaximalError(0.0)
+			{
+				std::vector<uint32_t> cornerVertices;
+				IdentifySharedVertices(mesh, stride, attributesSize, part, cornerVertices, &m_VertexSources);
+				std::vector<uint32_t> cornerPositions;
+				uint32_t positionsCount = IdentifySharedVertices(mesh, stride, 3, part, cornerPositions, nullptr);
+
+				m_VertexPositions.resize(m_VertexSources.size());
+				for (size_t i = 0; i < cornerVertices.size(); ++i)
+				{
+					m_VertexPositions[cornerVertices[i]] = cornerPositions[i];
+				}
+
+				// Positions shared by more than one vertex lie on seams
+				m_Positions.resize(positionsCount);
+				m_PositionVertices.resize(positionsCount, -1);
+				m_Locked.resize(positionsCount, false);
+				m_Border.resize(positionsCount, false);
+				m_Versions.resize(positionsCount, 0);
+				m_Quadrics.resize(positionsCount, Quadric{ {}, 0.0 });
+				m_PositionTriangles.resize(positionsCount);
+				for (uint32_t vertex = 0; vertex < static_cast<uint32_t>(m_VertexSources.size()); ++vertex)
+				{
+					uint32_t position = m_VertexPositions[vertex];
+					float const *data = &mesh.m_Data[m_VertexSources[vertex] * stride];
+					m_Positions[position] = { data[0], data[1], data[2] };
+					m_Locked[position] = m_Locked[position] || (-1 != m_PositionVertices[position]);
+					m_PositionVertices[position] = static_cast<int32_t>(vertex);
+				}
+
+				uint32_t trianglesCount = part.m_VertexCount / 3;
+				m_Triangles.resize(trianglesCount);
+				m_AliveTriangles.resize(trianglesCount, true);
+				m_AliveTrianglesCount = trianglesCount;
+				for (uint32_t triangle = 0; triangle < trianglesCount; ++triangle)
+				{
+					m_Triangles[triangle] = { cornerVertices[3 * triangle], cornerVertices[3 * triangle + 1], cornerVertices[3 * triangle + 2] };
+					for (uint32_t corner = 0; corner < 3; ++corner)
+					{
+						m_PositionTriangles[cornerPositions[3 * triangle + corner]].push_back(triangle);
+					}
+				}
+
+				// Surface quadrics, border detection and border quadrics
+				for (uint32_t triangle = 0; triangle < trianglesCount; ++triangle)
+				{
+					Vector3 normal = GetTriangleNormal(triangle, nullptr, 0);
+					float length = std::sqrt(Dot(normal, normal));
+					if (0.0f == length)
+					{
+						continue;
+					}
+					normal = (1.0f / length) * normal;
+					for (uint32_t corner = 0; corner < 3; ++corner)
+					{
+						uint32_t position = GetPosition(triangle, corner);
+						AddPlaneToQuadric(m_Quadrics[position], normal, -Dot(normal, m_Positions[position]), 1.0);
+					}
+					for (uint32_t corner = 0; corner < 3; ++corner)
+					{
+						uint32_t from = GetPosition(triangle, corner);
+						uint32_t to = GetPosition(triangle, (corner + 1) % 3);
+						if (1 == CountTrianglesWithEdge(from, to))
+						{
+							m_Border[from] = true;
+							m_Border[to] = true;
+							Vector3 edge = m_Positions[to] - m_Positions[from];
+							Vector3 borderNormal = Cross(edge, normal);
+							float borderLength = std::sqrt(Dot(borderNormal, borderNormal));
+							if (borderLength > 0.0f)
+							{
+								borderNormal = (1.0f / borderLength) * borderNormal;
+								float distance = -Dot(borderNormal, m_Positions[from]);
+								AddPlaneToQuadric(m_Quadrics[from], borderNormal, distance, BorderQuadricWeight);
+								AddPlaneToQuadric(m_Quadrics[to], borderNormal, distance, BorderQuadricWeight);
+							}
+						}
+					}
+				}
+
+				for (uint32_t position = 0; position < positionsCount; ++position)
+				{
+					PushCollapses(position);
+				}
+			}
+
+			// Returns false when no more collapses are possible
+			bool Simplify(uint32_t targetTrianglesCount)
+			{
+				while (m_AliveTrianglesCount > targetTrianglesCount)
+				{
+					if (m_Collapses.empty())
+					{
+						return false;
+					}
+					EdgeCollapse collapse = m_Collapses.top();
+					m_Collapses.pop();
+					if ((collapse.m_SourceVersion != m_Versions[collapse.m_Source]) || (collapse.m_TargetVersion != m_Versions[collapse.m_Target]))
+					{
+						continue;
+					}
+					int32_t targetVertex = GetCollapseTargetVertex(collapse.m_Source, collapse.m_Target);
+					if (targetVertex < 0)
+					{
+						continue;
+					}
+					Collapse(collapse.m_Source, collapse.m_Target, static_cast<uint32_t>(targetVertex));
+				}
+				return true;
+			}
+
+			uint32_t GetTrianglesCount() const
+			{
+				return m_AliveTrianglesCount;
+			}
+
+			float GetError() const
+			{
+				return static_cast<float>(std::sqrt(m_MaximalError));
+			}
+
+			// Tangent space vectors are zeroed, they have to be generated for the simplified geometry
+			void AppendVertices(std::vector<float> &data) const
+			{
+				for (uint32_t triangle = 0; triangle < static_cast<uint32_t>(m_Triangles.size()); ++triangle)
+				{
+					if (!m_AliveTriangles[triangle])
+					{
+						continue;
+					}
+					for (uint32_t corner = 0; corner < 3; ++corner)
+					{
+						float const *source = &m_Mesh.m_Data[m_VertexSources[m_Triangles[triangle][corner]] * m_Stride];
+						data.insert(data.end(), source, source + m_AttributesSize);
+						data.insert(data.end(), m_Stride - m_AttributesSize, 0.0f);
+					}
+				}
+			}
+
+		private:
+			uint32_t GetPosition(uint32_t triangle, uint32_t corner) const
+			{
+				return m_VertexPositions[m_Triangles[triangle][corner]];
+			}
+
+			// Optionally with one position replaced by another one
+			Vector3 GetTriangleNormal(uint32_t triangle, uint32_t const *replacedPosition, uint32_t replacement) const
+			{
+				Vector3 points[3];
+				for (uint32_t corner = 0; corner < 3; ++corner)
+				{
+					uint32_t position = GetPosition(triangle, corner);
+					points[corner] = m_Positions[(replacedPosition && (position == *replacedPosition)) ? replacement : position];
+				}
+				return Cross(points[1] - points[0], points[2] - points[0]);
+			}
+
+			bool ContainsPosition(uint32_t triangle, uint32_t position) const
+			{
+				return (GetPosition(triangle, 0) == position) || (GetPosition(triangle, 1) == position) || (GetPosition(triangle, 2) == position);
+			}
+
+			uint32_t CountTrianglesWithEdge(uint32_t from, uint32_t to) const
+			{
+				uint32_t count = 0;
+				for (auto triangle : m_PositionTriangles[from])
+				{
+					count += (m_AliveTriangles[triangle] && ContainsPosition(triangle, to)) ? 1 : 0;
+				}
+				return count;
+			}
+
+			void GatherNeighbors(uint32_t position, std::vector<uint32_t> &neighbors) const
+			{
+				neighbors.clear();
+				for (auto triangle : m_PositionTriangles[position])
+				{
+					for (uint32_t corner = 0; corner < 3; ++corner)
+					{
+						uint32_t neighbor = GetPosition(triangle, corner);
+						if ((neighbor != position) && (neighbors.end() == std::find(neighbors.begin(), neighbors.end(), neighbor)))
+						{
+							neighbors.push_back(neighbor);
+						}
+					}
+				}
+			}
+
+			double CalculateCost(uint32_t source, uint32_t target) const
+			{
+				double cost = EvaluateQuadric(m_Quadrics[source], m_Positions[target]);
+				if (m_Mesh.m_Layout.m_HasNormals)
+				{
+					float const *sourceNormal = &m_Mesh.m_Data[m_VertexSources[m_PositionVertices[source]] * m_Stride + 3];
+					float const *targetNormal = &m_Mesh.m_Data[m_VertexSources[m_PositionVertices[target]] * m_Stride + 3];
+					double normalDot = sourceNormal[0] * targetNormal[0] + sourceNormal[1] * targetNormal[1] + sourceNormal[2] * targetNormal[2];
+					Vector3 edge = m_Positions[target] - m_Positions[source];
+					cost += NormalDeviationWeight * (1.0 - normalDot) * Dot(edge, edge);
+				}
+				return cost;
+			}
+
+			void PushCollapses(uint32_t position)
+			{
+				if (m_PositionTriangles[position].empty())
+				{
+					return;
+				}
+				std::vector<uint32_t> neighbors;
+				GatherNeighbors(position, neighbors);
+				for (auto neighbor : neighbors)
+				{
+					if (!m_Locked[position])
+					{
+						m_Collapses.push({ CalculateCost(position, neighbor), position, neighbor, m_Versions[position], m_Versions[neighbor] });
+					}
+					if (!m_Locked[neighbor])
+					{
+						m_Collapses.push({ CalculateCost(neighbor, position), neighbor, position, m_Versions[neighbor], m_Versions[position] });
+					}
+				}
+			}
 
-			Vector3 const bitangent = handedness * Cross(normal, tangent);
+			// Returns the vertex replacing the source vertex, or -1 when the collapse would damage the mesh
+			int32_t GetCollapseTargetVertex(uint32_t source, uint32_t target) const
+			{
+				uint32_t sharedTrianglesCount = CountTrianglesWithEdge(source, target);
+				if (0 == sharedTrianglesCount)
+				{
+					return -1;
+				}
+				// Border vertices may only slide along the border
+				if (m_Border[source] && (!m_Border[target] || (1 != sharedTrianglesCount)))
+				{
+					return -1;
+				}
 
-			tangentData[0] = tangent[0];
-			tangentData[1] = tangent[1];
-			tangentData[2] = tangent[2];
+				// Triangles around the edge have to agree on the target vertex (seams on the target side)
+				int32_t targetVertex = -1;
+				for (auto triangle : m_PositionTriangles[source])
+				{
+					if (!m_AliveTriangles[triangle] || !ContainsPosition(triangle, target))
+					{
+						continue;
+					}
+					for (uint32_t corner = 0; corner < 3; ++corner)
+					{
+						if (GetPosition(triangle, corner) == target)
+						{
+							int32_t vertex = static_cast<int32_t>(m_Triangles[triangle][corner]);
+							if ((-1 != targetVertex) && (vertex != targetVertex))
+							{
+								return -1;
+							}
+							targetVertex = vertex;
+						}
+					}
+				}
 
-			bitangentData[0] = bitangent[0];
-			bitangentData[1] = bitangent[1];
-			bitangentData[2] = bitangent[2];
-		}
+				// Link condition: vertices adjacent to both ends can only be the opposite vertices of the collapsed triangles,
+				// otherwise the mesh would become non-manifold
+				std::vector<uint32_t> sourceNeighbors;
+				std::vector<uint32_t> targetNeighbors;
+				GatherNeighbors(source, sourceNeighbors);
+				GatherNeighbors(target, targetNeighbors);
+				uint32_t commonNeighborsCount = 0;
+				for (auto neighbor : sourceNeighbors)
+				{
+					commonNeighborsCount += (targetNeighbors.end() != std::find(targetNeighbors.begin(), targetNeighbors.end(), neighbor)) ? 1 : 0;
+				}
+				if (commonNeighborsCount != sharedTrianglesCount)
+				{
+					return -1;
+				}
 
-		void GenerateTangentSpaceVectors(Mesh & mesh)
-		{
-			size_t const normalOffset = 3;
-			size_t const texcoordOffset = 6;
-			size_t const tangentOffset = 8;
-			size_t const bitangentOffset = 11;
-			size_t const stride = bitangentOffset + 3;
+				// Remaining triangles must not flip
+				for (auto triangle : m_PositionTriangles[source])
+				{
+					if (ContainsPosition(triangle, target))
+					{
+						continue;
+					}
+					Vector3 before = GetTriangleNormal(triangle, nullptr, 0);
+					Vector3 after = GetTriangleNormal(triangle, &source, target);
+					if (Dot(before, after) <= 0.0f)
+					{
+						return -1;
+					}
+				}
+				return targetVertex;
+			}
 
-			for (auto & part : mesh.m_Parts)
+			void Collapse(uint32_t source, uint32_t target, uint32_t targetVertex)
 			{
-				for (size_t i = 0; i < mesh.m_Data.size(); i += stride * 3)
+				// Error is measured as a root mean square distance to the planes accumulated by the collapsed vertex
+				Quadric const &quadric = m_Quadrics[source];
+				double error = quadric.m_Weight > 0.0 ? EvaluateQuadric(quadric, m_Positions[target]) / quadric.m_Weight : 0.0;
+				m_MaximalError = error > m_MaximalError ? error : m_MaximalError;
+
+				for (auto triangle : m_PositionTriangles[source])
 				{
-					size_t i1 = i;
-					size_t i2 = i1 + stride;
-					size_t i3 = i2 + stride;
-					Vector3 const v1 = { mesh.m_Data[i1], mesh.m_Data[i1 + 1], mesh.m_Data[i1 + 2] };
-					Vector3 const v2 = { mesh.m_Data[i2], mesh.m_Data[i2 + 1], mesh.m_Data[i2 + 2] };
-					Vector3 const v3 = { mesh.m_Data[i3], mesh.m_Data[i3 + 1], mesh.m_Data[i3 + 2] };
+					if (ContainsPosition(triangle, target))
+					{
+						m_AliveTriangles[triangle] = false;
+						--m_AliveTrianglesCount;
+						continue;
+					}
+					for (uint32_t corner = 0; corner < 3; ++corner)
+					{
+						if (GetPosition(triangle, corner) == source)
+						{
+							m_Triangles[triangle][corner] = targetVertex;
+						}
+					}
+					m_PositionTriangles[target].push_back(triangle);
+				}
+				m_PositionTriangles[source].clear();
 
-					std::array<float, 2> const w1 = { mesh.m_Data[i1 + texcoordOffset], mesh.m_Data[i1 + texcoordOffset + 1] };
-					std::array<float, 2> const w2 = { mesh.m_Data[i2 + texcoordOffset], mesh.m_Data[i2 + texcoordOffset + 1] };
-					std::array<float, 2> const w3 = { mesh.m_Data[i3 + texcoordOffset], mesh.m_Data[i3 + texcoordOffset + 1] };
+				// Lists of all affected positions are compacted
+				std::vector<uint32_t> neighbors;
+				GatherNeighbors(target, neighbors);
+				neighbors.push_back(target);
+				for (auto position : neighbors)
+				{
+					auto & triangles = m_PositionTriangles[position];
+					triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [this](uint32_t triangle)
+					{
+						return !m_AliveTriangles[triangle];
+					}), triangles.end());
+				}
 
-					float x1 = v2[0] - v1[0];
-					float x2 = v3[0] - v1[0];
-					float y1 = v2[1] - v1[1];
-					float y2 = v3[1] - v1[1];
-					float z1 = v2[2] - v1[2];
-					float z2 = v3[2] - v1[2];
+				for (int i = 0; i < 10; ++i)
+				{
+					m_Quadrics[target].m_Values[i] += m_Quadrics[source].m_Values[i];
+				}
+				m_Quadrics[target].m_Weight += m_Quadrics[source].m_Weight;
+				++m_Versions[source];
+				++m_Versions[target];
+				PushCollapses(target);
+			}
 
-					float s1 = w2[0] - w1[0];
-					float s2 = w3[0] - w1[0];
-					float t1 = w2[1] - w1[1];
-					float t2 = w3[1] - w1[1];
+			Mesh const								&m_Mesh;
+			uint32_t								m_Stride;
+			uint32_t								m_AttributesSize;
+			std::vector<uint32_t>					m_VertexSources;		// Index of the first occurrence of each vertex in the Mesh::m_Data
+			std::vector<uint32_t>					m_VertexPositions;
+			std::vector<Vector3>					m_Positions;
+			std::vector<int32_t>					m_PositionVertices;		// Any vertex at a given position
+			std::vector<bool>						m_Locked;
+			std::vector<bool>						m_Border;
+			std::vector<uint32_t>					m_Versions;
+			std::vector<Quadric>					m_Quadrics;
+			std::vector<std::vector<uint32_t>>		m_PositionTriangles;
+			std::vector<std::array<uint32_t, 3>>	m_Triangles;
+			std::vector<bool>						m_AliveTriangles;
+			uint32_t								m_AliveTrianglesCount;
+			std::priority_queue<EdgeCollapse>		m_Collapses;
+			double									m_MaximalError;
+		};
 
-					float r = 1.0f / (s1 * t2 - s2 * t1);
-					Vector3 faceTangent = { (t2 * x1 - t1 * x2) * r, (t2 * y1 - t1 * y2) * r, (t2 * z1 - t1 * z2) * r };
-					Vector3 faceBitangent = { (s1 * x2 - s2 * x1) * r, (s1 * y2 - s2 * y1) * r, (s1 * z2 - s2 * z1) * r };
+		// Positions are loaded with 4-wide vector loads, so the last vertex of a buffer is processed separately when the fourth float would
+		// be read past its end
+		void CalculatePartBounds(std::vector<float> const &data, uint32_t stride, Mesh::Part &part)
+		{
+			if (0 == part.m_VertexCount)
+			{
+				part.m_BoundingBoxMin = { 0.0f, 0.0f, 0.0f };
+				part.m_BoundingBoxMax = { 0.0f, 0.0f, 0.0f };
+				part.m_BoundingSphere = { 0.0f, 0.0f, 0.0f, 0.0f };
+				return;
+			}
 
-					CalculateTangentAndBitangent(&mesh.m_Data[i1 + normalOffset], faceTangent, faceBitangent, &mesh.m_Data[i1 + tangentOffset], &mesh.m_Data[i1 + bitangentOffset]);
-					CalculateTangentAndBitangent(&mesh.m_Data[i2 + normalOffset], faceTangent, faceBitangent, &mesh.m_Data[i2 + tangentOffset], &mesh.m_Data[i2 + bitangentOffset]);
-					CalculateTangentAndBitangent(&mesh.m_Data[i3 + normalOffset], faceTangent, faceBitangent, &mesh.m_Data[i3 + tangentOffset], &mesh.m_Data[i3 + bitangentOffset]);
+			uint32_t const begin = part.m_VertexOffset;
+			uint32_t const end = part.m_VertexOffset + part.m_VertexCount;
+			uint32_t const vectorEnd = ((static_cast<size_t>(end) * stride + 1 > data.size()) && (3 == stride)) ? end - 1 : end;
+			float const *first = &data[begin * stride];
+			Vector3 minimum = { first[0], first[1], first[2] };
+			Vector3 maximum = minimum;
+
+			uint32_t vertex = begin;
+#if defined(SIMD_MATH_SSE2)
+			__m128 minimumVector = _mm_setr_ps(first[0], first[1], first[2], 0.0f);
+			__m128 maximumVector = minimumVector;
+			for (; vertex < vectorEnd; ++vertex)
+			{
+				__m128 position = _mm_loadu_ps(&data[vertex * stride]);
+				minimumVector = _mm_min_ps(minimumVector, position);
+				maximumVector = _mm_max_ps(maximumVector, position);
+			}
+			float minimumValues[4];
+			float maximumValues[4];
+			_mm_storeu_ps(minimumValues, minimumVector);
+			_mm_storeu_ps(maximumValues, maximumVector);
+			minimum = { minimumValues[0], minimumValues[1], minimumValues[2] };
+			maximum = { maximumValues[0], maximumValues[1], maximumValues[2] };
+#endif
+			for (; vertex < end; ++vertex)
+			{
+				float const *position = &data[vertex * stride];
+				for (int i = 0; i < 3; ++i)
+				{
+					minimum[i] = position[i] < minimum[i] ? position[i] : minimum[i];
+					maximum[i] = position[i] > maximum[i] ? position[i] : maximum[i];
 				}
 			}
+
+			// Sphere is centered in the box, its radius is the distance to the farthest vertex
+			Vector3 center = 0.5f * (minimum + maximum);
+			float squaredRadius = 0.0f;
+			vertex = begin;
+#if defined(SIMD_MATH_SSE2)
+			__m128 const centerVector = _mm_setr_ps(center[0], center[1], center[2], 0.0f);
+			__m128 const mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+			__m128 squaredRadiusVector = _mm_setzero_ps();
+			for (; vertex < vectorEnd; ++vertex)
+			{
+				__m128 difference = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(&data[vertex * stride]), centerVector), mask);
+				__m128 squared = _mm_mul_ps(difference, difference);
+				squared = _mm_add_ps(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 3, 0, 1)));
+				squared = _mm_add_ps(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(1, 0, 3, 2)));
+				squaredRadiusVector = _mm_max_ps(squaredRadiusVector, squared);
+			}
+			squaredRadius = _mm_cvtss_f32(squaredRadiusVector);
+#endif
+			for (; vertex < end; ++vertex)
+			{
+				float const *position = &data[vertex * stride];
+				Vector3 difference = Vector3{ position[0], position[1], position[2] } - center;
+				float squared = Dot(difference, difference);
+				squaredRadius = squared > squaredRadius ? squared : squaredRadius;
+			}
+
+			part.m_BoundingBoxMin = minimum;
+			part.m_BoundingBoxMax = maximum;
+			part.m_BoundingSphere = { center[0], center[1], center[2], std::sqrt(squaredRadius) };
 		}
 	}
 
@@ -125,23 +1217,18 @@ namespace VulkanSampleFramework
 		return true;
 	}
 
-	bool Load3DModelFromObjFile(char const *filename, bool loadNormals, bool loadTexcoords, bool generateTangentSpaceVectors, bool unify, Mesh &mesh, uint32_t *vertexStride/* = nullptr*/)
+	bool Load3DModelFromObjFile(char const *filename, bool loadNormals, bool loadTexcoords, bool generateTangentSpaceVectors, bool unify, Mesh &mesh, uint32_t *vertexStride/* = nullptr*/,
+		bool averageTangentSpaceVectors/* = false*/)
 	{
 		// Load model
-		tinyobj::attrib_t attribs;
-		std::vector<tinyobj::shape_t> shapes;
-		std::vector<tinyobj::material_t> materials;
-		std::string error;
-
-		bool result = tinyobj::LoadObj(&attribs, &shapes, &materials, &error, filename);
-		if (!result)
+		ObjData objData;
+		if (!ParseObjFile(filename, objData))
 		{
-			std::cout << "Could not open the '" << filename << "' file.";
-			if (0 < error.size())
-			{
-				std::cout << " " << error;
-			}
-			std::cout << std::endl;
+			return false;
+		}
+		if (objData.m_Indices.empty())
+		{
+			std::cout << "Could not load geometry data in the '" << filename << "' file." << std::endl;
 			return false;
 		}
 
@@ -151,116 +1238,127 @@ namespace VulkanSampleFramework
 			generateTangentSpaceVectors = false;
 		}
 
-		// Load model data and unify (normalize) its size and position
-		float minX = attribs.vertices[0];
-		float maxX = attribs.vertices[0];
-		float minY = attribs.vertices[1];
-		float maxY = attribs.vertices[1];
-		float minZ = attribs.vertices[2];
-		float maxZ = attribs.vertices[2];
+		// Validate indices before writing any vertex, so the filling loop doesn't need to check anything
+		int32_t positionsCount = static_cast<int32_t>(objData.m_Positions.size() / 3);
+		int32_t normalsCount = static_cast<int32_t>(objData.m_Normals.size() / 3);
+		int32_t texcoordsCount = static_cast<int32_t>(objData.m_Texcoords.size() / 2);
+		for (auto & index : objData.m_Indices)
+		{
+			if ((index.m_Position < 0) || (index.m_Position >= positionsCount))
+			{
+				std::cout << "Could not load positions data in the '" << filename << "' file." << std::endl;
+				return false;
+			}
+			if (loadNormals && ((index.m_Normal < 0) || (index.m_Normal >= normalsCount)))
+			{
+				std::cout << "Could not load normal vectors data in the '" << filename << "' file." << std::endl;
+				return false;
+			}
+			if (loadTexcoords && ((index.m_Texcoord < 0) || (index.m_Texcoord >= texcoordsCount)))
+			{
+				std::cout << "Could not load texture coordinates data in the '" << filename << "' file." << std::endl;
+				return false;
+			}
+		}
 
-		mesh = {};
-		uint32_t offset = 0;
+		uint32_t stride = 3 + (loadNormals ? 3 : 0) + (loadTexcoords ? 2 : 0) + (generateTangentSpaceVectors ? 6 : 0);
+		if (vertexStride)
+		{
+			*vertexStride = stride * sizeof(float);
+		}
 
-		for (auto & shape : shapes)
+		// Vertex data is allocated once with its exact size and filled in parallel, each thread tracks its own bounding box
+		mesh = {};
+		mesh.m_Data.resize(objData.m_Indices.size() * stride);
+		mesh.m_Layout = { loadNormals, loadTexcoords, generateTangentSpaceVectors, VertexAttributeEncoding::Float32, VertexAttributeEncoding::Float32,
+			VertexAttributeEncoding::Float32, VertexAttributeEncoding::Float32, false };
+		for (auto & part : objData.m_Parts)
 		{
-			uint32_t partOffset = offset;
+			mesh.m_Parts.push_back({ static_cast<uint32_t>(part.m_FirstIndex), static_cast<uint32_t>(part.m_IndicesCount),
+				{ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 0.0f } });
+		}
+
+		size_t verticesCount = objData.m_Indices.size();
+		size_t threadsCount = std::thread::hardware_concurrency();
+		size_t maxUsefulThreadsCount = verticesCount / MinimalVerticesPerThread;
+		threadsCount = threadsCount > maxUsefulThreadsCount ? maxUsefulThreadsCount : threadsCount;
+		threadsCount = threadsCount > 1 ? threadsCount : 1;
+		size_t verticesPerThread = (verticesCount + threadsCount - 1) / threadsCount;
 
-			for (auto & index : shape.mesh.indices)
+		float const *firstPosition = &objData.m_Positions[3 * objData.m_Indices[0].m_Position];
+		std::vector<std::array<float, 6>> bounds(threadsCount, { { firstPosition[0], firstPosition[1], firstPosition[2], firstPosition[0], firstPosition[1], firstPosition[2] } });
+
+		auto fillVertices = [&](size_t thread)
+		{
+			size_t begin = thread * verticesPerThread;
+			size_t end = begin + verticesPerThread > verticesCount ? verticesCount : begin + verticesPerThread;
+			std::array<float, 6> &bound = bounds[thread];
+			for (size_t i = begin; i < end; ++i)
 			{
-				mesh.m_Data.emplace_back(attribs.vertices[3 * index.vertex_index + 0]);
-				mesh.m_Data.emplace_back(attribs.vertices[3 * index.vertex_index + 1]);
-				mesh.m_Data.emplace_back(attribs.vertices[3 * index.vertex_index + 2]);
-				++offset;
+				ObjIndex const &index = objData.m_Indices[i];
+				float *vertex = &mesh.m_Data[i * stride];
+				float const *position = &objData.m_Positions[3 * index.m_Position];
+				vertex[0] = position[0];
+				vertex[1] = position[1];
+				vertex[2] = position[2];
+				vertex += 3;
 
 				if (loadNormals)
 				{
-					if (attribs.normals.size() == 0)
-					{
-						std::cout << "Could not load normal vectors data in the '" << filename << "' file.";
-						return false;
-					}
-					else
-					{
-						mesh.m_Data.emplace_back(attribs.normals[3 * index.normal_index + 0]);
-						mesh.m_Data.emplace_back(attribs.normals[3 * index.normal_index + 1]);
-						mesh.m_Data.emplace_back(attribs.normals[3 * index.normal_index + 2]);
-					}
+					float const *normal = &objData.m_Normals[3 * index.m_Normal];
+					vertex[0] = normal[0];
+					vertex[1] = normal[1];
+					vertex[2] = normal[2];
+					vertex += 3;
 				}
 
 				if (loadTexcoords)
 				{
-					if (attribs.texcoords.size() == 0) 
-					{
-						std::cout << "Could not load texture coordinates data in the '" << filename << "' file.";
-						return false;
-					}
-					else
-					{
-						mesh.m_Data.emplace_back(attribs.texcoords[2 * index.texcoord_index + 0]);
-						mesh.m_Data.emplace_back(attribs.texcoords[2 * index.texcoord_index + 1]);
-					}
-				}
-
-				if (generateTangentSpaceVectors)
-				{
-					// Insert temporary tangent space vectors data
-					for (int i = 0; i < 6; ++i)
-					{
-						mesh.m_Data.emplace_back(0.0f);
-					}
+					float const *texcoord = &objData.m_Texcoords[2 * index.m_Texcoord];
+					vertex[0] = texcoord[0];
+					vertex[1] = texcoord[1];
 				}
 
-				if (unify)
-				{
-					if (attribs.vertices[3 * index.vertex_index + 0] < minX)
-					{
-						minX = attribs.vertices[3 * index.vertex_index + 0];
-					}
-
-					if (attribs.vertices[3 * index.vertex_index + 0] > maxX) 
-					{
-						maxX = attribs.vertices[3 * index.vertex_index + 0];
-					}
-
-					if (attribs.vertices[3 * index.vertex_index + 1] < minY) 
-					{
-						minY = attribs.vertices[3 * index.vertex_index + 1];
-					}
-
-					if (attribs.vertices[3 * index.vertex_index + 1] > maxY)
-					{
-						maxY = attribs.vertices[3 * index.vertex_index + 1];
-					}
-
-					if (attribs.vertices[3 * index.vertex_index + 2] < minZ) 
-					{
-						minZ = attribs.vertices[3 * index.vertex_index + 2];
-					}
-
-					if (attribs.vertices[3 * index.vertex_index + 2] > maxZ)
-					{
-						maxZ = attribs.vertices[3 * index.vertex_index + 2];
-					}
-				}
+				bound[0] = position[0] < bound[0] ? position[0] : bound[0];
+				bound[1] = position[1] < bound[1] ? position[1] : bound[1];
+				bound[2] = position[2] < bound[2] ? position[2] : bound[2];
+				bound[3] = position[0] > bound[3] ? position[0] : bound[3];
+				bound[4] = position[1] > bound[4] ? position[1] : bound[4];
+				bound[5] = position[2] > bound[5] ? position[2] : bound[5];
 			}
+		};
 
-			uint32_t partVertexCount = offset - partOffset;
-			if (0 < partVertexCount)
-			{
-				mesh.m_Parts.push_back({ partOffset, partVertexCount });
-			}
+		std::vector<std::thread> threads;
+		for (size_t thread = 1; thread < threadsCount; ++thread)
+		{
+			threads.emplace_back(fillVertices, thread);
 		}
-
-		uint32_t stride = 3 + (loadNormals ? 3 : 0) + (loadTexcoords ? 2 : 0) + (generateTangentSpaceVectors ? 6 : 0);
-		if (vertexStride)
+		fillVertices(0);
+		for (auto & thread : threads)
 		{
-			*vertexStride = stride * sizeof(float);
+			thread.join();
+		}
+		objData = {};
+
+		float minX = bounds[0][0];
+		float minY = bounds[0][1];
+		float minZ = bounds[0][2];
+		float maxX = bounds[0][3];
+		float maxY = bounds[0][4];
+		float maxZ = bounds[0][5];
+		for (auto & bound : bounds)
+		{
+			minX = bound[0] < minX ? bound[0] : minX;
+			minY = bound[1] < minY ? bound[1] : minY;
+			minZ = bound[2] < minZ ? bound[2] : minZ;
+			maxX = bound[3] > maxX ? bound[3] : maxX;
+			maxY = bound[4] > maxY ? bound[4] : maxY;
+			maxZ = bound[5] > maxZ ? bound[5] : maxZ;
 		}
 
 		if (generateTangentSpaceVectors)
 		{
-			GenerateTangentSpaceVectors(mesh);
+			GenerateTangentSpaceVectors(mesh, averageTangentSpaceVectors);
 		}
 
 		if (unify)
@@ -282,9 +1380,287 @@ namespace VulkanSampleFramework
 			}
 		}
 
+		CalculateMeshPartBounds(mesh);
+		return true;
+	}
+
+	bool BuildMeshlets(Mesh const &mesh, uint32_t maxVertices, uint32_t maxTriangles, MeshletData &meshlets)
+	{
+		meshlets = {};
+
+		// Local vertex indices are stored in bytes
+		if ((maxVertices < 3) || (maxVertices > 256) || (0 == maxTriangles))
+		{
+			std::cout << "Could not build meshlets. Invalid vertex or triangle limit." << std::endl;
+			return false;
+		}
+
+		uint32_t stride = GetVertexStride(mesh.m_Layout);
+		std::vector<Mesh::Part> parts = mesh.m_Parts;
+		if (parts.empty())
+		{
+			parts.push_back({ 0, static_cast<uint32_t>(mesh.m_Data.size() / stride),
+				{ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 0.0f } });
+		}
+
+		// Parts are independent, so they are processed in parallel and merged afterwards
+		std::vector<MeshletData> partMeshlets(parts.size());
+		std::atomic<size_t> nextPart(0);
+		auto buildMeshlets = [&]()
+		{
+			for (size_t part = nextPart++; part < parts.size(); part = nextPart++)
+			{
+				BuildPartMeshlets(mesh, stride, parts[part], maxVertices, maxTriangles, partMeshlets[part]);
+			}
+		};
+
+		size_t threadsCount = std::thread::hardware_concurrency();
+		threadsCount = threadsCount < parts.size() ? threadsCount : parts.size();
+		std::vector<std::thread> threads;
+		for (size_t i = 1; i < threadsCount; ++i)
+		{
+			threads.emplace_back(buildMeshlets);
+		}
+		buildMeshlets();
+		for (auto & thread : threads)
+		{
+			thread.join();
+		}
+
+		for (auto & part : partMeshlets)
+		{
+			uint32_t firstMeshlet = static_cast<uint32_t>(meshlets.m_Meshlets.size());
+			uint32_t firstVertex = static_cast<uint32_t>(meshlets.m_VertexIndices.size());
+			uint32_t triangleOffset = static_cast<uint32_t>(meshlets.m_TriangleIndices.size());
+			for (auto & meshlet : part.m_Meshlets)
+			{
+				meshlets.m_Meshlets.push_back(meshlet);
+				meshlets.m_Meshlets.back().m_FirstVertex += firstVertex;
+				meshlets.m_Meshlets.back().m_TriangleOffset += triangleOffset;
+			}
+			meshlets.m_VertexIndices.insert(meshlets.m_VertexIndices.end(), part.m_VertexIndices.begin(), part.m_VertexIndices.end());
+			meshlets.m_TriangleIndices.insert(meshlets.m_TriangleIndices.end(), part.m_TriangleIndices.begin(), part.m_TriangleIndices.end());
+			meshlets.m_Parts.push_back({ firstMeshlet, static_cast<uint32_t>(part.m_Meshlets.size()) });
+		}
+		return true;
+	}
+
+	bool SaveMeshletsToFile(std::string const &fileName, MeshletData const &meshlets)
+	{
+		MeshletFileHeader header = {
+			{ MeshletFileMagic[0], MeshletFileMagic[1], MeshletFileMagic[2], MeshletFileMagic[3] },
+			MeshletFileVersion,
+			static_cast<uint32_t>(meshlets.m_Meshlets.size()),
+			static_cast<uint32_t>(meshlets.m_VertexIndices.size()),
+			static_cast<uint32_t>(meshlets.m_TriangleIndices.size()),
+			static_cast<uint32_t>(meshlets.m_Parts.size())
+		};
+
+		size_t meshletsSize = meshlets.m_Meshlets.size() * sizeof(Meshlet);
+		size_t vertexIndicesSize = meshlets.m_VertexIndices.size() * sizeof(uint32_t);
+		size_t partsSize = meshlets.m_Parts.size() * sizeof(MeshletData::Part);
+
+		std::vector<unsigned char> contents(sizeof(header) + meshletsSize + vertexIndicesSize + header.m_TriangleIndicesSize + partsSize);
+		unsigned char *destination = contents.data();
+		std::memcpy(destination, &header, sizeof(header));
+		destination += sizeof(header);
+		std::memcpy(destination, meshlets.m_Meshlets.data(), meshletsSize);
+		destination += meshletsSize;
+		std::memcpy(destination, meshlets.m_VertexIndices.data(), vertexIndicesSize);
+		destination += vertexIndicesSize;
+		std::memcpy(destination, meshlets.m_TriangleIndices.data(), header.m_TriangleIndicesSize);
+		destination += header.m_TriangleIndicesSize;
+		std::memcpy(destination, meshlets.m_Parts.data(), partsSize);
+
+		return SaveBinaryFileContents(fileName, contents);
+	}
+
+	bool LoadMeshletsFromFile(std::string const &fileName, MeshletData &meshlets)
+	{
+		meshlets = {};
+
+		std::vector<unsigned char> contents;
+		if (!GetBinaryFileContents(fileName, contents))
+		{
+			return false;
+		}
+
+		MeshletFileHeader header;
+		if (contents.size() < sizeof(header))
+		{
+			std::cout << "Could not load meshlets from the '" << fileName << "' file. File is too small." << std::endl;
+			return false;
+		}
+		std::memcpy(&header, contents.data(), sizeof(header));
+
+		size_t meshletsSize = static_cast<size_t>(header.m_MeshletsCount) * sizeof(Meshlet);
+		size_t vertexIndicesSize = static_cast<size_t>(header.m_VertexIndicesCount) * sizeof(uint32_t);
+		size_t partsSize = static_cast<size_t>(header.m_PartsCount) * sizeof(MeshletData::Part);
+		if ((0 != std::memcmp(header.m_Magic, MeshletFileMagic, sizeof(MeshletFileMagic))) || (MeshletFileVersion != header.m_Version) ||
+			(contents.size() != sizeof(header) + meshletsSize + vertexIndicesSize + header.m_TriangleIndicesSize + partsSize))
+		{
+			std::cout << "Could not load meshlets from the '" << fileName << "' file. Invalid file format." << std::endl;
+			return false;
+		}
+
+		meshlets.m_Meshlets.resize(header.m_MeshletsCount);
+		meshlets.m_VertexIndices.resize(header.m_VertexIndicesCount);
+		meshlets.m_TriangleIndices.resize(header.m_TriangleIndicesSize);
+		meshlets.m_Parts.resize(header.m_PartsCount);
+
+		unsigned char const *source = contents.data() + sizeof(header);
+		std::memcpy(meshlets.m_Meshlets.data(), source, meshletsSize);
+		source += meshletsSize;
+		std::memcpy(meshlets.m_VertexIndices.data(), source, vertexIndicesSize);
+		source += vertexIndicesSize;
+		std::memcpy(meshlets.m_TriangleIndices.data(), source, header.m_TriangleIndicesSize);
+		source += header.m_TriangleIndicesSize;
+		std::memcpy(meshlets.m_Parts.data(), source, partsSize);
+		return true;
+	}
+
+	bool GenerateMeshLods(Mesh &mesh, uint32_t maxLodsCount, float reductionFactor/* = 0.5f*/)
+	{
+		if ((reductionFactor <= 0.0f) || (reductionFactor >= 1.0f))
+		{
+			std::cout << "Could not generate levels of detail. Reduction factor must be in the (0, 1) range." << std::endl;
+			return false;
+		}
+
+		uint32_t stride = GetVertexStride(mesh.m_Layout);
+		uint32_t attributesSize = stride - (mesh.m_Layout.m_HasTangentSpace ? 6 : 0);
+		mesh.m_Lods.clear();
+		if (mesh.m_Parts.empty())
+		{
+			mesh.m_Parts.push_back({ 0, static_cast<uint32_t>(mesh.m_Data.size() / stride),
+				{ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 0.0f } });
+		}
+		// Vertices of previously generated levels are discarded
+		Mesh::Part const &lastPart = mesh.m_Parts.back();
+		mesh.m_Data.resize((lastPart.m_VertexOffset + lastPart.m_VertexCount) * stride);
+
+		// Parts are simplified in parallel, each level of each part gets its own vertices
+		std::vector<std::vector<std::vector<float>>> partLevels(mesh.m_Parts.size());
+		std::vector<std::vector<float>> partErrors(mesh.m_Parts.size());
+		std::atomic<size_t> nextPart(0);
+		auto simplifyParts = [&]()
+		{
+			for (size_t part = nextPart++; part < mesh.m_Parts.size(); part = nextPart++)
+			{
+				PartSimplifier simplifier(mesh, stride, attributesSize, mesh.m_Parts[part]);
+				float targetTrianglesCount = static_cast<float>(simplifier.GetTrianglesCount());
+				for (uint32_t level = 0; level < maxLodsCount; ++level)
+				{
+					targetTrianglesCount *= reductionFactor;
+					simplifier.Simplify(static_cast<uint32_t>(targetTrianglesCount));
+					partLevels[part].emplace_back();
+					simplifier.AppendVertices(partLevels[part].back());
+					partErrors[part].push_back(simplifier.GetError());
+				}
+			}
+		};
+
+		size_t threadsCount = std::thread::hardware_concurrency();
+		threadsCount = threadsCount < mesh.m_Parts.size() ? threadsCount : mesh.m_Parts.size();
+		std::vector<std::thread> threads;
+		for (size_t i = 1; i < threadsCount; ++i)
+		{
+			threads.emplace_back(simplifyParts);
+		}
+		simplifyParts();
+		for (auto & thread : threads)
+		{
+			thread.join();
+		}
+
+		size_t previousVerticesCount = mesh.m_Data.size() / stride;
+		for (uint32_t level = 0; level < maxLodsCount; ++level)
+		{
+			Mesh lod = {};
+			lod.m_Layout = mesh.m_Layout;
+			float error = 0.0f;
+			for (size_t part = 0; part < mesh.m_Parts.size(); ++part)
+			{
+				std::vector<float> const &data = partLevels[part][level];
+				lod.m_Parts.push_back({ static_cast<uint32_t>(lod.m_Data.size() / stride), static_cast<uint32_t>(data.size() / stride),
+					{ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 0.0f } });
+				lod.m_Data.insert(lod.m_Data.end(), data.begin(), data.end());
+				error = partErrors[part][level] > error ? partErrors[part][level] : error;
+			}
+
+			// Levels which don't remove a noticeable number of triangles aren't worth switching to
+			size_t verticesCount = lod.m_Data.size() / stride;
+			if ((0 == verticesCount) || (static_cast<float>(verticesCount) > 0.95f * static_cast<float>(previousVerticesCount)))
+			{
+				break;
+			}
+			previousVerticesCount = verticesCount;
+
+			if (mesh.m_Layout.m_HasTangentSpace)
+			{
+				GenerateTangentSpaceVectors(lod, false);
+			}
+
+			uint32_t firstVertex = static_cast<uint32_t>(mesh.m_Data.size() / stride);
+			for (auto & part : lod.m_Parts)
+			{
+				part.m_VertexOffset += firstVertex;
+			}
+			mesh.m_Data.insert(mesh.m_Data.end(), lod.m_Data.begin(), lod.m_Data.end());
+			mesh.m_Lods.push_back({ lod.m_Parts, error });
+		}
+
+		CalculateMeshPartBounds(mesh);
 		return true;
 	}
 
+	uint32_t SelectMeshLod(Mesh const &mesh, float distance, float objectScale, float fieldOfView, float viewportHeight, float maxScreenSpaceError/* = 1.0f*/)
+	{
+		// Same focal length as used by the PreparePerspectiveProjectionMatrix, converted from the [-1, 1] range to pixels
+		float pixelsPerUnit = 0.5f * viewportHeight / tan(Deg2Rad(0.5f * fieldOfView));
+		if (distance <= 0.0f)
+		{
+			return 0;
+		}
+
+		uint32_t selectedLod = 0;
+		for (uint32_t lod = 0; lod < static_cast<uint32_t>(mesh.m_Lods.size()); ++lod)
+		{
+			float screenSpaceError = mesh.m_Lods[lod].m_Error * objectScale * pixelsPerUnit / distance;
+			if (screenSpaceError > maxScreenSpaceError)
+			{
+				break;
+			}
+			selectedLod = lod + 1;
+		}
+		return selectedLod;
+	}
+
+	std::vector<Mesh::Part> const & GetMeshLodParts(Mesh const &mesh, uint32_t lod)
+	{
+		if ((0 == lod) || (mesh.m_Lods.empty()))
+		{
+			return mesh.m_Parts;
+		}
+		return mesh.m_Lods[(lod <= mesh.m_Lods.size() ? lod : static_cast<uint32_t>(mesh.m_Lods.size())) - 1].m_Parts;
+	}
+
+	void CalculateMeshPartBounds(Mesh &mesh)
+	{
+		uint32_t stride = GetVertexStride(mesh.m_Layout);
+		for (auto & part : mesh.m_Parts)
+		{
+			CalculatePartBounds(mesh.m_Data, stride, part);
+		}
+		for (auto & lod : mesh.m_Lods)
+		{
+			for (auto & part : lod.m_Parts)
+			{
+				CalculatePartBounds(mesh.m_Data, stride, part);
+			}
+		}
+	}
+
 	bool LoadTextureDataFromFile(char const *filename, int numRequestedComponents, std::vector<unsigned char> &imageData, int *imageWidth, int * imageHeight, int * imageNumComponents,
 		int *imageDataSize)
 	{
@@ -403,6 +1779,43 @@ namespace VulkanSampleFramework
 		return perspectiveProjectionMatrix;
 	}
 
+	std::array<Vector4, 6> ExtractFrustumPlanes(Matrix4x4 const &viewProjectionMatrix)
+	{
+		// Matrices are stored in column major order, so each row is gathered from four columns
+		auto row = [&viewProjectionMatrix](int index) -> Vector4
+		{
+			return { viewProjectionMatrix[index], viewProjectionMatrix[4 + index], viewProjectionMatrix[8 + index], viewProjectionMatrix[12 + index] };
+		};
+		Vector4 x = row(0);
+		Vector4 y = row(1);
+		Vector4 z = row(2);
+		Vector4 w = row(3);
+
+		// Vulkan clip volume: -w <= x <= w, -w <= y <= w, 0 <= z <= w
+		std::array<Vector4, 6> planes =
+		{{
+			{ w[0] + x[0], w[1] + x[1], w[2] + x[2], w[3] + x[3] },
+			{ w[0] - x[0], w[1] - x[1], w[2] - x[2], w[3] - x[3] },
+			{ w[0] + y[0], w[1] + y[1], w[2] + y[2], w[3] + y[3] },
+			{ w[0] - y[0], w[1] - y[1], w[2] - y[2], w[3] - y[3] },
+			z,
+			{ w[0] - z[0], w[1] - z[1], w[2] - z[2], w[3] - z[3] }
+		}};
+
+		for (auto & plane : planes)
+		{
+			float length = sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+			if (length > 0.0f)
+			{
+				for (auto & component : plane)
+				{
+					component /= length;
+				}
+			}
+		}
+		return planes;
+	}
+
 	float Deg2Rad(float value) 
 	{
 		return value * 0.01745329251994329576923690768489f;
@@ -550,27 +1963,8 @@ namespace VulkanSampleFramework
 
 	Matrix4x4 operator* (Matrix4x4 const &left, Matrix4x4 const &right)
 	{
-		return
-		{
-			left[0] * right[0] + left[4] * right[1] + left[8] * right[2] + left[12] * right[3],
-			left[1] * right[0] + left[5] * right[1] + left[9] * right[2] + left[13] * right[3],
-			left[2] * right[0] + left[6] * right[1] + left[10] * right[2] + left[14] * right[3],
-			left[3] * right[0] + left[7] * right[1] + left[11] * right[2] + left[15] * right[3],
-
-			left[0] * right[4] + left[4] * right[5] + left[8] * right[6] + left[12] * right[7],
-			left[1] * right[4] + left[5] * right[5] + left[9] * right[6] + left[13] * right[7],
-			left[2] * right[4] + left[6] * right[5] + left[10] * right[6] + left[14] * right[7],
-			left[3] * right[4] + left[7] * right[5] + left[11] * right[6] + left[15] * right[7],
-
-			left[0] * right[8] + left[4] * right[9] + left[8] * right[10] + left[12] * right[11],
-			left[1] * right[8] + left[5] * right[9] + left[9] * right[10] + left[13] * right[11],
-			left[2] * right[8] + left[6] * right[9] + left[10] * right[10] + left[14] * right[11],
-			left[3] * right[8] + left[7] * right[9] + left[11] * right[10] + left[15] * right[11],
-
-			left[0] * right[12] + left[4] * right[13] + left[8] * right[14] + left[12] * right[15],
-			left[1] * right[12] + left[5] * right[13] + left[9] * right[14] + left[13] * right[15],
-			left[2] * right[12] + left[6] * right[13] + left[10] * right[14] + left[14] * right[15],
-			left[3] * right[12] + left[7] * right[13] + left[11] * right[14] + left[15] * right[15]
-		};
+		Matrix4x4 result;
+		MultiplyMatrices(left.data(), right.data(), result.data());
+		return result;
 	}
 } 
@@ -3,6 +3,33 @@
 
 namespace VulkanSampleFramework
 {
+	enum class VertexAttributeEncoding
+	{
+		Float32,		// Any attribute, 32-bit floats
+		Float16,		// Positions and texture coordinates, half floats
+		Snorm16,		// Positions, 16-bit signed normalized values relative to bounds of each part
+		Unorm16,		// Texture coordinates from the [0, 1] range, 16-bit unsigned normalized values
+		Octahedral8,	// Normal, tangent and bitangent vectors mapped onto octahedron, 2 x 8-bit signed normalized values
+		Octahedral16	// Normal, tangent and bitangent vectors mapped onto octahedron, 2 x 16-bit signed normalized values
+	};
+
+	// Vertex consists of position and optionally normal, texture coordinates, tangent and bitangent (in that order)
+	struct VertexLayout
+	{
+		bool					m_HasNormals;
+		bool					m_HasTexcoords;
+		bool					m_HasTangentSpace;
+		VertexAttributeEncoding	m_PositionEncoding;
+		VertexAttributeEncoding	m_NormalEncoding;
+		VertexAttributeEncoding	m_TexcoordEncoding;
+		VertexAttributeEncoding	m_TangentSpaceEncoding;
+		bool					m_SeparatePositionStream;	// Positions are stored in a separate buffer (e.g. for depth-only passes)
+	};
+
+	using Vector3 = std::array<float, 3>;
+	using Vector4 = std::array<float, 4>;
+	using Matrix4x4 = std::array<float, 16>;
+
 	struct Mesh
 	{
 		std::vector<float> m_Data;
@@ -11,21 +38,84 @@ namespace VulkanSampleFramework
 		{
 			uint32_t  m_VertexOffset;
 			uint32_t  m_VertexCount;
+			Vector3   m_BoundingBoxMin;
+			Vector3   m_BoundingBoxMax;
+			Vector4   m_BoundingSphere;		// Center and radius
 		};
 
 		std::vector<Part> m_Parts;
+
+		// Describes m_Data, which always contains interleaved 32-bit floats
+		VertexLayout m_Layout;
+
+		// Simplified versions of all parts, vertices of each level are stored in m_Data after the vertices of previous levels
+		struct Lod
+		{
+			std::vector<Part>	m_Parts;
+			// Largest root mean square distance of a collapsed vertex to the planes of the original faces it replaced, in model
+			// space units. It estimates the deviation from the original surface, but doesn't bound it.
+			float				m_Error;
+		};
+
+		std::vector<Lod> m_Lods;
 	};
 
-	using Vector3 = std::array<float, 3>;
-	using Matrix4x4 = std::array<float, 16>;
+	// Cluster of triangles of a single mesh part, small enough to be culled and drawn as a unit
+	struct Meshlet
+	{
+		uint32_t	m_FirstVertex;			// Index into MeshletData::m_VertexIndices
+		uint32_t	m_VertexCount;
+		uint32_t	m_TriangleOffset;		// Offset into MeshletData::m_TriangleIndices, always a multiple of 4
+		uint32_t	m_TriangleCount;
+		Vector4		m_BoundingSphere;		// Center and radius
+		Vector4		m_ConeApex;				// Fourth component is unused
+		Vector4		m_ConeAxisAndCutoff;	// Meshlet faces away from the camera when dot(normalize(apex - camera), axis) >= cutoff
+	};
+
+	struct MeshletData
+	{
+		struct Part
+		{
+			uint32_t  m_FirstMeshlet;
+			uint32_t  m_MeshletCount;
+		};
+
+		std::vector<Meshlet>		m_Meshlets;
+		std::vector<uint32_t>		m_VertexIndices;	// Indices of vertices in the Mesh::m_Data
+		std::vector<unsigned char>	m_TriangleIndices;	// Three meshlet-local vertex indices per triangle
+		std::vector<Part>			m_Parts;			// Meshlets created for each Mesh::Part
+	};
+
+	uint32_t const MaxMeshletVertices = 64;
+	uint32_t const MaxMeshletTriangles = 124;
 
 	bool GetBinaryFileContents(std::string const &fileName, std::vector<unsigned char> &contents);
 	bool SaveBinaryFileContents(std::string const &fileName, std::vector<unsigned char> &contents);
-	bool Load3DModelFromObjFile(char const *filename, bool loadNormals, bool loadTexcoords, bool generateTangentSpaceVectors, bool unify, Mesh &mesh, uint32_t *vertexStride = nullptr);
+	// Averaging sums tangent space vectors of all corners sharing the same position, normal and texture coordinates (MikkTSpace-like smoothing),
+	// otherwise each triangle gets its own flat tangent space
+	bool Load3DModelFromObjFile(char const *filename, bool loadNormals, bool loadTexcoords, bool generateTangentSpaceVectors, bool unify, Mesh &mesh, uint32_t *vertexStride = nullptr,
+		bool averageTangentSpaceVectors = false);
+	// Vertices with bitwise equal attributes are shared by triangles of a meshlet, so meshes with averaged tangent space vectors produce
+	// fewer and fuller meshlets
+	bool BuildMeshlets(Mesh const &mesh, uint32_t maxVertices, uint32_t maxTriangles, MeshletData &meshlets);
+	bool SaveMeshletsToFile(std::string const &fileName, MeshletData const &meshlets);
+	bool LoadMeshletsFromFile(std::string const &fileName, MeshletData &meshlets);
+	// Parts are simplified with quadric error metrics. Vertices on texture or normal seams and on borders are kept in place (border vertices
+	// may only collapse along borders), so levels keep their texture mapping and silhouette. Each level has about reductionFactor times
+	// triangles of the previous one, generation stops early when a level can't be simplified any further.
+	bool GenerateMeshLods(Mesh &mesh, uint32_t maxLodsCount, float reductionFactor = 0.5f);
+	// Level 0 is the full-detail mesh, level N is mesh.m_Lods[N - 1]. Returns the coarsest level whose error projected onto the screen,
+	// for the vertical field of view (in degrees) used with PreparePerspectiveProjectionMatrix, doesn't exceed maxScreenSpaceError pixels.
+	uint32_t SelectMeshLod(Mesh const &mesh, float distance, float objectScale, float fieldOfView, float viewportHeight, float maxScreenSpaceError = 1.0f);
+	std::vector<Mesh::Part> const & GetMeshLodParts(Mesh const &mesh, uint32_t lod);
+	// Calculates bounding volumes of all parts, including parts of levels of detail
+	void CalculateMeshPartBounds(Mesh &mesh);
 	bool LoadTextureDataFromFile(char const *filename, int numRequestedComponents, std::vector<unsigned char> &imageData, int *imageWidth, int * imageHeight, int * imageNumComponents,
 		int *imageDataSize);
 	Matrix4x4 PrepareRotationMatrix(float angle, Vector3 const &axis, float normalizeAxis = false);
 	Matrix4x4 PreparePerspectiveProjectionMatrix(float aspectRatio, float fieldOfView, float nearPlane, float farPlane);
+	// Planes (left, right, bottom, top, near, far) are normalized and point inside the frustum, for points in the space transformed by the given matrix
+	std::array<Vector4, 6> ExtractFrustumPlanes(Matrix4x4 const &viewProjectionMatrix);
 	
 	float Deg2Rad(float value);
 
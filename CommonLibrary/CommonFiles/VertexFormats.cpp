@@ -0,0 +1,385 @@
+#include "VertexFormats.h"
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		struct AttributeDescription
+		{
+			VertexAttributeEncoding	m_Encoding;
+			uint32_t				m_SourceOffset;		// In floats, in the source vertex
+			uint32_t				m_ComponentsCount;	// In the source vertex
+			uint32_t				m_Stream;
+			uint32_t				m_Offset;			// In bytes, in the stream vertex
+		};
+
+		struct EncodingProperties
+		{
+			VkFormat	m_Format;
+			uint32_t	m_Size;
+			uint32_t	m_Alignment;
+		};
+
+		EncodingProperties GetEncodingProperties(VertexAttributeEncoding encoding, uint32_t componentsCount)
+		{
+			// 3-component 16-bit formats are rarely supported for vertex input, so such attributes are padded to 4 components
+			switch (encoding)
+			{
+			case VertexAttributeEncoding::Float16:
+				return 3 == componentsCount ? EncodingProperties{ VK_FORMAT_R16G16B16A16_SFLOAT, 8, 2 } : EncodingProperties{ VK_FORMAT_R16G16_SFLOAT, 4, 2 };
+			case VertexAttributeEncoding::Snorm16:
+				return { VK_FORMAT_R16G16B16A16_SNORM, 8, 2 };
+			case VertexAttributeEncoding::Unorm16:
+				return { VK_FORMAT_R16G16_UNORM, 4, 2 };
+			case VertexAttributeEncoding::Octahedral8:
+				return { VK_FORMAT_R8G8_SNORM, 2, 1 };
+			case VertexAttributeEncoding::Octahedral16:
+				return { VK_FORMAT_R16G16_SNORM, 4, 2 };
+			case VertexAttributeEncoding::Float32:
+			default:
+				return 3 == componentsCount ? EncodingProperties{ VK_FORMAT_R32G32B32_SFLOAT, 12, 4 } : EncodingProperties{ VK_FORMAT_R32G32_SFLOAT, 8, 4 };
+			}
+		}
+
+		uint32_t GetSourceVertexStride(VertexLayout const &layout)
+		{
+			return 3 + (layout.m_HasNormals ? 3 : 0) + (layout.m_HasTexcoords ? 2 : 0) + (layout.m_HasTangentSpace ? 6 : 0);
+		}
+
+		// Source offsets are calculated for the layout of the Mesh::m_Data, which has to contain all attributes of the target layout
+		std::vector<AttributeDescription> PrepareAttributeDescriptions(VertexLayout const &sourceLayout, VertexLayout const &layout, uint32_t streamStrides[2])
+		{
+			uint32_t const normalOffset = 3;
+			uint32_t const texcoordOffset = normalOffset + (sourceLayout.m_HasNormals ? 3 : 0);
+			uint32_t const tangentOffset = texcoordOffset + (sourceLayout.m_HasTexcoords ? 2 : 0);
+
+			std::vector<AttributeDescription> attributes;
+			attributes.push_back({ layout.m_PositionEncoding, 0, 3, 0, 0 });
+			uint32_t attributesStream = layout.m_SeparatePositionStream ? 1 : 0;
+			if (layout.m_HasNormals)
+			{
+				attributes.push_back({ layout.m_NormalEncoding, normalOffset, 3, attributesStream, 0 });
+			}
+			if (layout.m_HasTexcoords)
+			{
+				attributes.push_back({ layout.m_TexcoordEncoding, texcoordOffset, 2, attributesStream, 0 });
+			}
+			if (layout.m_HasTangentSpace)
+			{
+				attributes.push_back({ layout.m_TangentSpaceEncoding, tangentOffset, 3, attributesStream, 0 });
+				attributes.push_back({ layout.m_TangentSpaceEncoding, tangentOffset + 3, 3, attributesStream, 0 });
+			}
+
+			// Each attribute is aligned to the size of its components, vertices are aligned to 4 bytes
+			streamStrides[0] = 0;
+			streamStrides[1] = 0;
+			for (auto & attribute : attributes)
+			{
+				EncodingProperties properties = GetEncodingProperties(attribute.m_Encoding, attribute.m_ComponentsCount);
+				uint32_t &stride = streamStrides[attribute.m_Stream];
+				attribute.m_Offset = (stride + properties.m_Alignment - 1) & ~(properties.m_Alignment - 1);
+				stride = attribute.m_Offset + properties.m_Size;
+			}
+			streamStrides[0] = (streamStrides[0] + 3) & ~3u;
+			streamStrides[1] = (streamStrides[1] + 3) & ~3u;
+			return attributes;
+		}
+
+		bool IsEncodingSupported(VertexAttributeEncoding encoding, bool position, bool direction)
+		{
+			switch (encoding)
+			{
+			case VertexAttributeEncoding::Float32:
+				return true;
+			case VertexAttributeEncoding::Float16:
+				return !direction;
+			case VertexAttributeEncoding::Snorm16:
+				return position;
+			case VertexAttributeEncoding::Unorm16:
+				return !position && !direction;
+			case VertexAttributeEncoding::Octahedral8:
+			case VertexAttributeEncoding::Octahedral16:
+				return direction;
+			default:
+				return false;
+			}
+		}
+
+		// Round to nearest even, values out of the half range become infinities
+		uint16_t ConvertFloatToHalf(float value)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			uint32_t sign = (bits >> 16) & 0x8000;
+			uint32_t mantissa = bits & 0x7FFFFF;
+			int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+
+			if ((bits & 0x7FFFFFFF) >= 0x7F800000)
+			{
+				return static_cast<uint16_t>(sign | 0x7C00 | (0 != mantissa ? 0x200 : 0));
+			}
+			if (exponent >= 31)
+			{
+				return static_cast<uint16_t>(sign | 0x7C00);
+			}
+			if (exponent <= 0)
+			{
+				if (exponent < -10)
+				{
+					return static_cast<uint16_t>(sign);
+				}
+				mantissa |= 0x800000;
+				uint32_t shift = static_cast<uint32_t>(14 - exponent);
+				uint32_t half = mantissa >> shift;
+				uint32_t remainder = mantissa & ((1u << shift) - 1);
+				uint32_t halfway = 1u << (shift - 1);
+				half += ((remainder > halfway) || ((remainder == halfway) && (half & 1))) ? 1 : 0;
+				return static_cast<uint16_t>(sign | half);
+			}
+			uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+			uint32_t remainder = mantissa & 0x1FFF;
+			// Carry from the mantissa correctly increments the exponent
+			half += ((remainder > 0x1000) || ((remainder == 0x1000) && (half & 1))) ? 1 : 0;
+			return static_cast<uint16_t>(sign | half);
+		}
+
+		inline float Clamp(float value, float minimum, float maximum)
+		{
+			return value < minimum ? minimum : (value > maximum ? maximum : value);
+		}
+
+		inline int16_t ConvertToSnorm16(float value)
+		{
+			return static_cast<int16_t>(std::lround(Clamp(value, -1.0f, 1.0f) * 32767.0f));
+		}
+
+		inline int8_t ConvertToSnorm8(float value)
+		{
+			return static_cast<int8_t>(std::lround(Clamp(value, -1.0f, 1.0f) * 127.0f));
+		}
+
+		inline uint16_t ConvertToUnorm16(float value)
+		{
+			return static_cast<uint16_t>(std::lround(Clamp(value, 0.0f, 1.0f) * 65535.0f));
+		}
+
+		void EncodeOctahedral(float const *vector, float &u, float &v)
+		{
+			float sum = std::abs(vector[0]) + std::abs(vector[1]) + std::abs(vector[2]);
+			sum = sum > 0.0f ? sum : 1.0f;
+			u = vector[0] / sum;
+			v = vector[1] / sum;
+			if (vector[2] < 0.0f)
+			{
+				float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+				float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+				u = foldedU;
+				v = foldedV;
+			}
+		}
+
+		void EncodeAttribute(AttributeDescription const &attribute, float const *source, Vector4 const &positionOffset, Vector4 const &positionScale, unsigned char *destination)
+		{
+			switch (attribute.m_Encoding)
+			{
+			case VertexAttributeEncoding::Float16:
+			{
+				uint16_t values[4] = { 0, 0, 0, 0x3C00 };
+				for (uint32_t i = 0; i < attribute.m_ComponentsCount; ++i)
+				{
+					values[i] = ConvertFloatToHalf(source[i]);
+				}
+				std::memcpy(destination, values, 3 == attribute.m_ComponentsCount ? 8 : 4);
+				break;
+			}
+			case VertexAttributeEncoding::Snorm16:
+			{
+				int16_t values[4] = { 0, 0, 0, 32767 };
+				for (uint32_t i = 0; i < 3; ++i)
+				{
+					values[i] = ConvertToSnorm16((source[i] - positionOffset[i]) / positionScale[i]);
+				}
+				std::memcpy(destination, values, sizeof(values));
+				break;
+			}
+			case VertexAttributeEncoding::Unorm16:
+			{
+				uint16_t values[2] = { ConvertToUnorm16(source[0]), ConvertToUnorm16(source[1]) };
+				std::memcpy(destination, values, sizeof(values));
+				break;
+			}
+			case VertexAttributeEncoding::Octahedral8:
+			case VertexAttributeEncoding::Octahedral16:
+			{
+				float u;
+				float v;
+				EncodeOctahedral(source, u, v);
+				if (VertexAttributeEncoding::Octahedral8 == attribute.m_Encoding)
+				{
+					int8_t values[2] = { ConvertToSnorm8(u), ConvertToSnorm8(v) };
+					std::memcpy(destination, values, sizeof(values));
+				}
+				else
+				{
+					int16_t values[2] = { ConvertToSnorm16(u), ConvertToSnorm16(v) };
+					std::memcpy(destination, values, sizeof(values));
+				}
+				break;
+			}
+			case VertexAttributeEncoding::Float32:
+			default:
+				std::memcpy(destination, source, attribute.m_ComponentsCount * sizeof(float));
+				break;
+			}
+		}
+
+		QuantizedMesh::Part QuantizePart(Mesh const &mesh, uint32_t sourceStride, VertexAttributeEncoding positionEncoding, std::vector<AttributeDescription> const &attributes,
+			uint32_t const streamStrides[2], unsigned char * const streams[2], Mesh::Part const &part)
+		{
+			Vector4 positionOffset = { 0.0f, 0.0f, 0.0f, 0.0f };
+			Vector4 positionScale = { 1.0f, 1.0f, 1.0f, 1.0f };
+			if ((VertexAttributeEncoding::Snorm16 == positionEncoding) && (0 < part.m_VertexCount))
+			{
+				float const *first = &mesh.m_Data[part.m_VertexOffset * sourceStride];
+				Vector3 minimum = { first[0], first[1], first[2] };
+				Vector3 maximum = minimum;
+				for (uint32_t vertex = part.m_VertexOffset; vertex < part.m_VertexOffset + part.m_VertexCount; ++vertex)
+				{
+					float const *position = &mesh.m_Data[vertex * sourceStride];
+					for (int i = 0; i < 3; ++i)
+					{
+						minimum[i] = position[i] < minimum[i] ? position[i] : minimum[i];
+						maximum[i] = position[i] > maximum[i] ? position[i] : maximum[i];
+					}
+				}
+				for (int i = 0; i < 3; ++i)
+				{
+					positionOffset[i] = 0.5f * (minimum[i] + maximum[i]);
+					positionScale[i] = 0.5f * (maximum[i] - minimum[i]);
+					positionScale[i] = positionScale[i] > 0.0f ? positionScale[i] : 1.0f;
+				}
+			}
+
+			for (uint32_t vertex = part.m_VertexOffset; vertex < part.m_VertexOffset + part.m_VertexCount; ++vertex)
+			{
+				float const *source = &mesh.m_Data[vertex * sourceStride];
+				for (auto & attribute : attributes)
+				{
+					unsigned char *destination = streams[attribute.m_Stream] + vertex * streamStrides[attribute.m_Stream] + attribute.m_Offset;
+					EncodeAttribute(attribute, source + attribute.m_SourceOffset, positionOffset, positionScale, destination);
+				}
+			}
+			return { part.m_VertexOffset, part.m_VertexCount, positionOffset, positionScale };
+		}
+	}
+
+	uint32_t GetPositionStreamStride(VertexLayout const &layout)
+	{
+		uint32_t strides[2];
+		PrepareAttributeDescriptions(layout, layout, strides);
+		return strides[0];
+	}
+
+	uint32_t GetAttributeStreamStride(VertexLayout const &layout)
+	{
+		uint32_t strides[2];
+		PrepareAttributeDescriptions(layout, layout, strides);
+		return strides[1];
+	}
+
+	bool QuantizeMesh(Mesh const &mesh, VertexLayout const &layout, QuantizedMesh &quantizedMesh)
+	{
+		VertexLayout const &sourceLayout = mesh.m_Layout;
+		if ((layout.m_HasNormals && !sourceLayout.m_HasNormals) ||
+			(layout.m_HasTexcoords && !sourceLayout.m_HasTexcoords) ||
+			(layout.m_HasTangentSpace && !sourceLayout.m_HasTangentSpace))
+		{
+			std::cout << "Could not quantize a mesh. Mesh doesn't contain all attributes required by the vertex layout." << std::endl;
+			return false;
+		}
+		if (!IsEncodingSupported(layout.m_PositionEncoding, true, false) ||
+			(layout.m_HasNormals && !IsEncodingSupported(layout.m_NormalEncoding, false, true)) ||
+			(layout.m_HasTexcoords && !IsEncodingSupported(layout.m_TexcoordEncoding, false, false)) ||
+			(layout.m_HasTangentSpace && !IsEncodingSupported(layout.m_TangentSpaceEncoding, false, true)))
+		{
+			std::cout << "Could not quantize a mesh. Encoding is not supported for a given vertex attribute." << std::endl;
+			return false;
+		}
+
+		uint32_t sourceStride = GetSourceVertexStride(sourceLayout);
+		uint32_t streamStrides[2];
+		std::vector<AttributeDescription> attributes = PrepareAttributeDescriptions(sourceLayout, layout, streamStrides);
+		uint32_t texcoordSourceOffset = 3 + (sourceLayout.m_HasNormals ? 3 : 0);
+		size_t verticesCount = mesh.m_Data.size() / sourceStride;
+
+		if (layout.m_HasTexcoords && (VertexAttributeEncoding::Unorm16 == layout.m_TexcoordEncoding))
+		{
+			for (size_t vertex = 0; vertex < verticesCount; ++vertex)
+			{
+				float const *texcoord = &mesh.m_Data[vertex * sourceStride + texcoordSourceOffset];
+				if ((texcoord[0] < 0.0f) || (texcoord[0] > 1.0f) || (texcoord[1] < 0.0f) || (texcoord[1] > 1.0f))
+				{
+					std::cout << "Could not quantize a mesh. Texture coordinates outside of the [0, 1] range can't be encoded as Unorm16." << std::endl;
+					return false;
+				}
+			}
+		}
+
+		quantizedMesh = {};
+		quantizedMesh.m_Layout = layout;
+		quantizedMesh.m_PositionStream.resize(verticesCount * streamStrides[0]);
+		quantizedMesh.m_AttributeStream.resize(verticesCount * streamStrides[1]);
+
+		// Mesh without parts is treated as a single part
+		std::vector<Mesh::Part> parts = mesh.m_Parts;
+		if (parts.empty())
+		{
+			parts.push_back({ 0, static_cast<uint32_t>(verticesCount),
+				{ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 0.0f } });
+		}
+
+		unsigned char *streams[2] = { quantizedMesh.m_PositionStream.data(), quantizedMesh.m_AttributeStream.data() };
+		for (auto & part : parts)
+		{
+			quantizedMesh.m_Parts.push_back(QuantizePart(mesh, sourceStride, layout.m_PositionEncoding, attributes, streamStrides, streams, part));
+		}
+		for (auto & lod : mesh.m_Lods)
+		{
+			quantizedMesh.m_LodParts.emplace_back();
+			for (auto & part : lod.m_Parts)
+			{
+				quantizedMesh.m_LodParts.back().push_back(QuantizePart(mesh, sourceStride, layout.m_PositionEncoding, attributes, streamStrides, streams, part));
+			}
+		}
+		return true;
+	}
+
+	void SpecifyVertexLayoutInputState(VertexLayout const &layout, uint32_t firstBinding, uint32_t firstLocation,
+		std::vector<VkVertexInputBindingDescription> &bindingDescriptions, std::vector<VkVertexInputAttributeDescription> &attributeDescriptions)
+	{
+		uint32_t streamStrides[2];
+		std::vector<AttributeDescription> attributes = PrepareAttributeDescriptions(layout, layout, streamStrides);
+
+		for (uint32_t stream = 0; stream < 2; ++stream)
+		{
+			if (0 < streamStrides[stream])
+			{
+				bindingDescriptions.push_back({
+					firstBinding + stream,			// uint32_t                     binding
+					streamStrides[stream],			// uint32_t                     stride
+					VK_VERTEX_INPUT_RATE_VERTEX		// VkVertexInputRate            inputRate
+				});
+			}
+		}
+
+		for (uint32_t i = 0; i < static_cast<uint32_t>(attributes.size()); ++i)
+		{
+			attributeDescriptions.push_back({
+				firstLocation + i,																		// uint32_t     location
+				firstBinding + attributes[i].m_Stream,													// uint32_t     binding
+				GetEncodingProperties(attributes[i].m_Encoding, attributes[i].m_ComponentsCount).m_Format,	// VkFormat     format
+				attributes[i].m_Offset																	// uint32_t     offset
+			});
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "Tools.h"
+
+namespace VulkanSampleFramework
+{
+	// Quantized vertices are decoded by vertex input formats, except for:
+	//  - Snorm16 positions, which have to be transformed in a shader: position = offset + scale * input
+	//  - octahedral vectors, which have to be unfolded in a shader:
+	//      vec3 v = vec3(input.xy, 1.0 - abs(input.x) - abs(input.y));
+	//      float t = max(-v.z, 0.0);
+	//      v.xy += vec2(v.x >= 0.0 ? -t : t, v.y >= 0.0 ? -t : t);
+	//      v = normalize(v);
+	struct QuantizedMesh
+	{
+		struct Part
+		{
+			uint32_t	m_VertexOffset;
+			uint32_t	m_VertexCount;
+			Vector4		m_PositionOffset;	// Zero unless positions are encoded as Snorm16
+			Vector4		m_PositionScale;	// One unless positions are encoded as Snorm16
+		};
+
+		VertexLayout				m_Layout;
+		std::vector<unsigned char>	m_PositionStream;	// Contains all attributes when positions are not stored separately
+		std::vector<unsigned char>	m_AttributeStream;	// Empty when positions are not stored separately
+		std::vector<Part>			m_Parts;
+		std::vector<std::vector<Part>>	m_LodParts;		// Parts of each level of Mesh::m_Lods
+	};
+
+	uint32_t GetPositionStreamStride(VertexLayout const &layout);
+	uint32_t GetAttributeStreamStride(VertexLayout const &layout);
+	bool QuantizeMesh(Mesh const &mesh, VertexLayout const &layout, QuantizedMesh &quantizedMesh);
+	// Attributes get consecutive locations in the vertex order (position, normal, texture coordinates, tangent, bitangent),
+	// first binding sources positions and, if they are stored separately, the next one sources the remaining attributes
+	void SpecifyVertexLayoutInputState(VertexLayout const &layout, uint32_t firstBinding, uint32_t firstLocation,
+		std::vector<VkVertexInputBindingDescription> &bindingDescriptions, std::vector<VkVertexInputAttributeDescription> &attributeDescriptions);
+}
@@ -101,6 +101,11 @@ namespace VulkanSampleFramework
 		m_MouseState.Wheel.Distance = 0.0f;
 	}
 
+	void VulkanSampleBase::KeyPress(uint32_t key)
+	{
+		OnKeyEvent(key);
+	}
+
 	void VulkanSampleBase::UpdateTime()
 	{
 		m_TimerState.Update();
@@ -116,6 +121,11 @@ namespace VulkanSampleFramework
 		// Override this in a derived class to know when a mouse event occured
 	}
 
+	void VulkanSampleBase::OnKeyEvent(uint32_t key)
+	{
+		// Override this in a derived class to react to pressed keys (Windows virtual-key codes)
+	}
+
 	bool VulkanSample::InitializeVulkan(WindowParameters windowParameters, VkPhysicalDeviceFeatures *desiredDeviceFeatures,
 		VkImageUsageFlags swapchainImageUsage, bool useDepth, VkImageUsageFlags depthAttachmentUsage)
 	{
@@ -148,6 +158,14 @@ namespace VulkanSampleFramework
 #endif
 		);
 
+		// Needed to query memory budgets, which are then used only when the device supports VK_EXT_memory_budget
+		std::vector<VkExtensionProperties> availableInstanceExtensions;
+		if (CheckAvailableInstanceExtensions(availableInstanceExtensions) &&
+			IsExtensionSupported(availableInstanceExtensions, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+		{
+			instanceExtensions.emplace_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+		}
+
 		if (!CreateVulkanInstance(instanceExtensions, "Vulkan Sample", m_Instance))
 		{
 			return false;
@@ -203,17 +221,144 @@ namespace VulkanSampleFramework
 
 			std::vector<char const *> deviceExtensions;
 			deviceExtensions.emplace_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
-			if (!CreateLogicalDevice(physicalDevice, requestedQueues, deviceExtensions, desiredDeviceFeatures, m_LogicalDevice))
+
+			std::vector<VkExtensionProperties> availableDeviceExtensions;
+			if (!CheckAvailableDeviceExtensions(physicalDevice, availableDeviceExtensions))
+			{
+				continue;
+			}
+
+			bool memoryBudgetExtensionEnabled = (nullptr != vkGetPhysicalDeviceMemoryProperties2KHR) &&
+				IsExtensionSupported(availableDeviceExtensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+			if (memoryBudgetExtensionEnabled)
+			{
+				deviceExtensions.emplace_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+			}
+
+			// Lets GPU frustum culling draw only the commands it wrote, with the count read from the draw buffer
+			if (IsExtensionSupported(availableDeviceExtensions, VK_AMD_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+			{
+				deviceExtensions.emplace_back(VK_AMD_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+			}
+
+			// Synchronization2 lets barrier batchers keep separate stage masks for each barrier
+			VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features =
+			{
+				VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR,	// VkStructureType    sType
+				nullptr,															// void             * pNext
+				VK_FALSE															// VkBool32           synchronization2
+			};
+			if ((nullptr != vkGetPhysicalDeviceFeatures2KHR) &&
+				IsExtensionSupported(availableDeviceExtensions, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+			{
+				VkPhysicalDeviceFeatures2KHR features =
+				{
+					VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR,				// VkStructureType             sType
+					&synchronization2Features,										// void                      * pNext
+					{}																// VkPhysicalDeviceFeatures    features
+				};
+				vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features);
+			}
+
+			// Timeline semaphores replace fences used for frame pacing and uploads
+			VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures =
+			{
+				VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,	// VkStructureType    sType
+				nullptr,															// void             * pNext
+				VK_FALSE															// VkBool32           timelineSemaphore
+			};
+			if ((nullptr != vkGetPhysicalDeviceFeatures2KHR) &&
+				IsExtensionSupported(availableDeviceExtensions, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+			{
+				VkPhysicalDeviceFeatures2KHR features =
+				{
+					VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR,				// VkStructureType             sType
+					&timelineSemaphoreFeatures,										// void                      * pNext
+					{}																// VkPhysicalDeviceFeatures    features
+				};
+				vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features);
+			}
+
+			// Multi-draw indirect lets indirect draw batchers and GPU culling issue all their draws with a single call
+			VkPhysicalDeviceFeatures supportedDeviceFeatures;
+			vkGetPhysicalDeviceFeatures(physicalDevice, &supportedDeviceFeatures);
+			VkPhysicalDeviceFeatures enabledDeviceFeatures = {};
+			if (nullptr != desiredDeviceFeatures)
+			{
+				enabledDeviceFeatures = *desiredDeviceFeatures;
+			}
+			if (VK_TRUE == supportedDeviceFeatures.multiDrawIndirect)
+			{
+				enabledDeviceFeatures.multiDrawIndirect = VK_TRUE;
+			}
+			// Compute downsampling in mipmap generators writes to storage images without a declared format
+			if (VK_TRUE == supportedDeviceFeatures.shaderStorageImageWriteWithoutFormat)
+			{
+				enabledDeviceFeatures.shaderStorageImageWriteWithoutFormat = VK_TRUE;
+			}
+			// Block-compressed DDS and KTX2 textures, e.g. the streamed ones, can't be sampled without it
+			if (VK_TRUE == supportedDeviceFeatures.textureCompressionBC)
+			{
+				enabledDeviceFeatures.textureCompressionBC = VK_TRUE;
+			}
+
+			// Enabled features are chained together
+			void *enabledFeatures = nullptr;
+			bool synchronization2Enabled = (VK_TRUE == synchronization2Features.synchronization2);
+			if (synchronization2Enabled)
+			{
+				deviceExtensions.emplace_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+				synchronization2Features.pNext = enabledFeatures;
+				enabledFeatures = &synchronization2Features;
+			}
+
+			bool timelineSemaphoresEnabled = (VK_TRUE == timelineSemaphoreFeatures.timelineSemaphore);
+			if (timelineSemaphoresEnabled)
+			{
+				deviceExtensions.emplace_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+				timelineSemaphoreFeatures.pNext = enabledFeatures;
+				enabledFeatures = &timelineSemaphoreFeatures;
+			}
+
+			if (!CreateLogicalDevice(physicalDevice, requestedQueues, deviceExtensions, &enabledDeviceFeatures, m_LogicalDevice, enabledFeatures))
 			{
 				continue;
 			}
 			else
 			{
 				m_PhysicalDevice = physicalDevice;
+				m_EnabledDeviceFeatures = enabledDeviceFeatures;
+				m_Synchronization2Enabled = synchronization2Enabled;
+				m_TimelineSemaphoresEnabled = timelineSemaphoresEnabled;
+				m_MemoryBudget.Initialize(m_PhysicalDevice, memoryBudgetExtensionEnabled);
+				SetMemoryBudgetTracker(m_LogicalDevice, &m_MemoryBudget);
+				SetResourceStateTracker(m_LogicalDevice, &m_ResourceStates);
+				SetFencePool(m_LogicalDevice, &m_FencePool);
+				SetSemaphorePool(m_LogicalDevice, &m_SemaphorePool);
+				SetDeferredDestructionQueue(m_LogicalDevice, &m_DestructionQueue);
 				LoadDeviceLevelFunctions(m_LogicalDevice, deviceExtensions);
 				GetDeviceQueue(m_LogicalDevice, m_GraphicsQueue.m_FamilyIndex, 0, m_GraphicsQueue.m_Handle);
 				GetDeviceQueue(m_LogicalDevice, m_ComputeQueue.m_FamilyIndex, 0, m_ComputeQueue.m_Handle);
 				GetDeviceQueue(m_LogicalDevice, m_PresentQueue.m_FamilyIndex, 0, m_PresentQueue.m_Handle);
+
+				// Helpers submitting to these queues use their timelines when they are registered
+				if (m_TimelineSemaphoresEnabled)
+				{
+					if (!m_GraphicsQueueTimeline.Initialize(m_LogicalDevice, m_GraphicsQueue.m_Handle))
+					{
+						return false;
+					}
+					RegisterQueueTimeline(&m_GraphicsQueueTimeline);
+
+					if (m_ComputeQueue.m_Handle != m_GraphicsQueue.m_Handle)
+					{
+						if (!m_ComputeQueueTimeline.Initialize(m_LogicalDevice, m_ComputeQueue.m_Handle))
+						{
+							return false;
+						}
+						RegisterQueueTimeline(&m_ComputeQueueTimeline);
+					}
+				}
 				break;
 			}
 		}
@@ -233,10 +378,14 @@ namespace VulkanSampleFramework
 			return false;
 		}
 
-		for (uint32_t i = 0; i < m_FramesCount; ++i)
+		if (!m_StaticCommandBuffers.Initialize(m_LogicalDevice, m_GraphicsQueue.m_FamilyIndex))
 		{
-			m_FramesResources.emplace_back(FrameResources());
-			m_FramesResources.back().Initiallize(m_LogicalDevice, m_CommandPool);
+			return false;
+		}
+
+		if (!CreateFrameResources(m_FramesCount))
+		{
+			return false;
 		}
 
 		if (!CreateSwapchain(swapchainImageUsage, useDepth, depthAttachmentUsage)) 
@@ -249,14 +398,37 @@ namespace VulkanSampleFramework
 
 	bool VulkanSample::CreateSwapchain(VkImageUsageFlags swapchainImageUsage, bool useDepth, VkImageUsageFlags depthAttachmentUsage)
 	{
-		WaitForAllSubmittedCommandsToBeFinished(m_LogicalDevice);
+		// Replaced objects may still be used by frames in flight, so they are destroyed after these frames finish instead of waiting here
+		if (nullptr == GetDeferredDestructionQueue(m_LogicalDevice))
+		{
+			WaitForAllSubmittedCommandsToBeFinished(m_LogicalDevice);
+		}
 
 		m_Ready = false;
 
-		m_Swapchain.DestroyResources(m_LogicalDevice);
-
-		VkSwapchainKHR oldSwapchain = std::move(m_Swapchain.m_Handle);
-		if (!CreateSwapChainCustom(swapchainImageUsage, VK_FORMAT_R8G8B8A8_UNORM, VK_PRESENT_MODE_MAILBOX_KHR, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR, oldSwapchain))
+		for (auto &imageView : m_Swapchain.m_ImageViews)
+		{
+			VkImageView swapchainImageView = imageView;
+			DestroyWhenUnused(m_LogicalDevice, [swapchainImageView](VkDevice device) mutable
+			{
+				DestroyImageView(device, swapchainImageView);
+			});
+		}
+		m_Swapchain.m_ImageViews.clear();
+
+		// Old swapchain is retired by the new one and destroyed after its images are no longer presented
+		VkSwapchainKHR oldSwapchain = m_Swapchain.m_Handle;
+		m_Swapchain.m_Handle = VK_NULL_HANDLE;
+		bool swapchainCreated = CreateSwapChainCustom(swapchainImageUsage, VK_FORMAT_R8G8B8A8_UNORM, VK_PRESENT_MODE_MAILBOX_KHR,
+			VK_COLOR_SPACE_SRGB_NONLINEAR_KHR, oldSwapchain);
+		if (VK_NULL_HANDLE != oldSwapchain)
+		{
+			DestroyWhenUnused(m_LogicalDevice, [oldSwapchain](VkDevice device) mutable
+			{
+				DestroySwapchain(device, oldSwapchain);
+			});
+		}
+		if (!swapchainCreated)
 		{
 			return false;
 		}
@@ -277,38 +449,21 @@ namespace VulkanSampleFramework
 		}
 
 		// When we want to use depth buffering, we need to use a depth attachment
-		// It must have the same size as the swapchain, so we need to recreate it along with the swapchain
-		m_DepthImages.clear();
-		m_DepthImagesMemory.clear();
-
-		if (useDepth)
+		// Depth is only used inside render passes unless other usages are requested, so it may live in lazily allocated memory
+		VkImageUsageFlags transientUsages = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+		if (0 == (depthAttachmentUsage & ~transientUsages))
 		{
-			for (uint32_t i = 0; i < m_FramesCount; ++i) 
-			{
-				m_DepthImages.emplace_back(VkImage());
-				m_DepthImagesMemory.emplace_back(VkDeviceMemory());
-
-				if (!CreateImage(m_LogicalDevice, VK_IMAGE_TYPE_2D, m_DepthFormat, { m_Swapchain.m_Size.width, m_Swapchain.m_Size.height, 1 },
-					1, 1, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, false, m_DepthImages.back()))
-				{
-					return false;
-				}
-
-				if (!AllocateAndBindMemoryObjectToImage(m_LogicalDevice, m_DepthImages.back(), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-					m_PhysicalDeviceMemoryProperties, m_DepthImagesMemory.back()))
-				{
-					return false;
-				}
+			depthAttachmentUsage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+		}
 
-				if (!CreateImageView(m_LogicalDevice, m_DepthImages.back(), VK_IMAGE_VIEW_TYPE_2D, m_DepthFormat, VK_IMAGE_ASPECT_DEPTH_BIT,
-					m_FramesResources[i].m_DepthAttachment))
-				{
-					return false;
-				}
-			}
+		// Kept for frame resources recreated with a different number of frames
+		m_UseDepth = useDepth;
+		m_DepthAttachmentUsage = depthAttachmentUsage;
+		if (!CreateDepthAttachments())
+		{
+			return false;
 		}
 
-		DestroySwapchain(m_LogicalDevice, oldSwapchain);
 		m_Ready = true;
 		return true;
 	}
@@ -320,30 +475,145 @@ namespace VulkanSampleFramework
 		{
 			WaitForAllSubmittedCommandsToBeFinished(m_LogicalDevice);
 
-			for (int i = 0; i < m_FramesResources.size(); ++i)
+			// Nothing is in flight anymore, so remaining objects are destroyed right away
+			m_DestructionQueue.Flush(m_LogicalDevice);
+			SetDeferredDestructionQueue(m_LogicalDevice, nullptr);
+
+			DestroyFrameResources();
+
+			m_StaticCommandBuffers.Destroy(m_LogicalDevice);
+			DestroyCommandPool(m_LogicalDevice, m_CommandPool);
+
+			UnregisterQueueTimeline(&m_GraphicsQueueTimeline);
+			UnregisterQueueTimeline(&m_ComputeQueueTimeline);
+			m_GraphicsQueueTimeline.Destroy(m_LogicalDevice);
+			m_ComputeQueueTimeline.Destroy(m_LogicalDevice);
+			SetFencePool(m_LogicalDevice, nullptr);
+			SetSemaphorePool(m_LogicalDevice, nullptr);
+			m_FencePool.Destroy(m_LogicalDevice);
+			m_SemaphorePool.Destroy(m_LogicalDevice);
+			//m_Swapchain.DestroyResources(m_LogicalDevice);
+			SetMemoryBudgetTracker(m_LogicalDevice, nullptr);
+			SetResourceStateTracker(m_LogicalDevice, nullptr);
+			DestroyPresentationSurface(m_Instance, m_PresentationSurface);
+			DestroyLogicalDevice(m_LogicalDevice);
+			DestroyVulkanInstance(m_Instance);
+		}
+	}
+
+	bool VulkanSample::SetFramesInFlightCount(uint32_t framesCount)
+	{
+		if ((0 == framesCount) || (framesCount > m_MaxFramesCount))
+		{
+			std::cout << "Could not use " << framesCount << " frames in flight, from 1 to " << m_MaxFramesCount << " are supported." << std::endl;
+			return false;
+		}
+
+		if (framesCount == m_FramesCount)
+		{
+			return true;
+		}
+
+		// Before initialization resources are simply created for the new number of frames
+		if (!m_LogicalDevice)
+		{
+			m_FramesCount = framesCount;
+			return true;
+		}
+
+		if (!WaitForAllSubmittedCommandsToBeFinished(m_LogicalDevice))
+		{
+			return false;
+		}
+
+		// When the new resources can't be created, the previous number of frames is restored
+		DestroyFrameResources();
+		if (!CreateFrameResources(framesCount))
+		{
+			DestroyFrameResources();
+			if (CreateFrameResources(m_FramesCount) && m_Swapchain.m_Handle)
 			{
-				m_FramesResources[i].Destroy(m_LogicalDevice);
+				CreateDepthAttachments();
 			}
-			m_FramesResources.clear();
+			return false;
+		}
+		m_FramesCount = framesCount;
+
+		// Depth attachments are created together with the swapchain, whose size may be unknown yet
+		if (!m_Swapchain.m_Handle)
+		{
+			return true;
+		}
+		return CreateDepthAttachments();
+	}
+
+	VulkanSample::VulkanSample() :
+		m_LogicalDevice(VK_NULL_HANDLE),
+		m_EnabledDeviceFeatures(),
+		m_Synchronization2Enabled(false),
+		m_TimelineSemaphoresEnabled(false),
+		m_FramesCount(3),
+		m_FrameIndex(0),
+		m_UseDepth(true),
+		m_DepthAttachmentUsage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)
+	{
+	}
 
-			for (int i = 0; i < m_DepthImagesMemory.size(); ++i)
+	bool VulkanSample::CreateFrameResources(uint32_t framesCount)
+	{
+		if (!m_AttachmentPool.Initialize(m_PhysicalDeviceMemoryProperties, framesCount))
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < framesCount; ++i)
+		{
+			m_FramesResources.emplace_back(FrameResources());
+			if (!m_FramesResources.back().Initiallize(m_LogicalDevice, m_CommandPool))
 			{
-				FreeMemoryObject(m_LogicalDevice, m_DepthImagesMemory[i]);
+				return false;
 			}
-			m_DepthImagesMemory.clear();
+		}
+		m_FrameIndex = 0;
+		return true;
+	}
 
-			for (int i = 0; i < m_DepthImages.size(); ++i)
+	bool VulkanSample::CreateDepthAttachments()
+	{
+		// It must have the same size as the swapchain, so it is requested again along with the swapchain and recreated only when the size changed
+		AttachmentDescription depthAttachment =
+		{
+			m_DepthFormat,				// VkFormat                 Format
+			m_Swapchain.m_Size,			// VkExtent2D               Size
+			VK_SAMPLE_COUNT_1_BIT,		// VkSampleCountFlagBits    Samples
+			m_DepthAttachmentUsage,		// VkImageUsageFlags        Usage
+			VK_IMAGE_ASPECT_DEPTH_BIT	// VkImageAspectFlags       Aspect
+		};
+
+		for (uint32_t i = 0; i < static_cast<uint32_t>(m_FramesResources.size()); ++i)
+		{
+			m_AttachmentPool.BeginFrame(i);
+			uint32_t depthAttachmentIndex = m_UseDepth ? m_AttachmentPool.RequestAttachment(depthAttachment, 0, 0) : 0;
+			if (!m_AttachmentPool.EndFrame(m_LogicalDevice))
 			{
-				DestroyImage(m_LogicalDevice, m_DepthImages[i]);
+				return false;
 			}
-			m_DepthImages.clear();
+			m_FramesResources[i].m_DepthAttachment = m_UseDepth ? m_AttachmentPool.GetImageView(i, depthAttachmentIndex) : VK_NULL_HANDLE;
+		}
+		return true;
+	}
 
-			DestroyCommandPool(m_LogicalDevice, m_CommandPool);
-			//m_Swapchain.DestroyResources(m_LogicalDevice);
-			DestroyPresentationSurface(m_Instance, m_PresentationSurface);
-			DestroyLogicalDevice(m_LogicalDevice);
-			DestroyVulkanInstance(m_Instance);
+	void VulkanSample::DestroyFrameResources()
+	{
+		// Depth attachment views are owned by the pool
+		for (size_t i = 0; i < m_FramesResources.size(); ++i)
+		{
+			m_FramesResources[i].m_DepthAttachment = VK_NULL_HANDLE;
+			m_FramesResources[i].Destroy(m_LogicalDevice);
 		}
+		m_FramesResources.clear();
+
+		m_AttachmentPool.Destroy(m_LogicalDevice);
 	}
 
 	bool VulkanSample::CreateSwapChainCustom(VkImageUsageFlags swapchainImageUsage,	VkFormat desireFormat, VkPresentModeKHR desirePresentMode, VkColorSpaceKHR desireColorSpace,
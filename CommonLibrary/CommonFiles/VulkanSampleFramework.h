@@ -100,11 +100,13 @@ namespace VulkanSampleFramework
 		virtual void MouseMove(int x, int y) final;
 		virtual void MouseWheel(float distance) final;
 		virtual void MouseReset() final;
+		virtual void KeyPress(uint32_t key) final;
 		virtual void UpdateTime() final;
 		virtual bool IsReady() final;
 
 	protected:
 		virtual void OnMouseEvent();
+		virtual void OnKeyEvent(uint32_t key);
 
 		LIBRARY_TYPE m_VulkanLibrary;
 		bool m_Ready;
@@ -127,10 +129,22 @@ namespace VulkanSampleFramework
 		SwapchainParameters m_Swapchain;
 		VkCommandPool m_CommandPool;
 		VkPhysicalDeviceMemoryProperties m_PhysicalDeviceMemoryProperties;
-		std::vector<VkImage> m_DepthImages;
-		std::vector<VkDeviceMemory> m_DepthImagesMemory;
+		TransientAttachmentPool m_AttachmentPool;
 		std::vector<FrameResources> m_FramesResources;
-		static uint32_t const m_FramesCount = 3;
+		StaticCommandBufferCache m_StaticCommandBuffers;
+		MemoryBudgetTracker m_MemoryBudget;
+		ResourceStateTracker m_ResourceStates;	// Only resources registered by samples and helpers are tracked
+		VkPhysicalDeviceFeatures m_EnabledDeviceFeatures;	// Desired features and the optional ones used by helpers, e.g. multiDrawIndirect
+		bool m_Synchronization2Enabled;	// VK_KHR_synchronization2 with its feature, may be used by barrier batchers
+		bool m_TimelineSemaphoresEnabled;	// VK_KHR_timeline_semaphore with its feature, queue timelines below are created only with it
+		QueueTimeline m_GraphicsQueueTimeline;
+		QueueTimeline m_ComputeQueueTimeline;	// Only when the compute queue differs from the graphics one
+		FencePool m_FencePool;
+		SemaphorePool m_SemaphorePool;
+		DeferredDestructionQueue m_DestructionQueue;	// Completed frames are reported by the frame loop
+		uint32_t m_FramesCount;		// Frames in flight, changed with SetFramesInFlightCount()
+		uint32_t m_FrameIndex;		// Frame resources used by the next frame
+		static uint32_t const m_MaxFramesCount = 4;
 		static VkFormat const m_DepthFormat = VK_FORMAT_D16_UNORM;
 
 		virtual bool InitializeVulkan(WindowParameters windowParameters, VkPhysicalDeviceFeatures *desiredDeviceFeatures = nullptr,
@@ -139,8 +153,20 @@ namespace VulkanSampleFramework
 		virtual bool CreateSwapchain(VkImageUsageFlags swapchainImageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, bool useDepth = true,
 			VkImageUsageFlags depthAttachmentUsage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) final;
 		virtual void  Deinitialize();
+		// Fewer frames lower the latency, more of them let the CPU run further ahead of the GPU. After initialization waits until the device
+		// is idle and recreates frame resources together with their depth attachments.
+		bool SetFramesInFlightCount(uint32_t framesCount);
+
+		VulkanSample();
 
 	private:
+		bool CreateFrameResources(uint32_t framesCount);
+		bool CreateDepthAttachments();
+		void DestroyFrameResources();
+
+		bool m_UseDepth;
+		VkImageUsageFlags m_DepthAttachmentUsage;
+
 		bool CreateSwapChainCustom(VkImageUsageFlags swapchainImageUsage, VkFormat desireFormat, VkPresentModeKHR desirePresentMode, VkColorSpaceKHR desireColorSpace, 
 			VkSwapchainKHR &oldSwapchain);
 	};
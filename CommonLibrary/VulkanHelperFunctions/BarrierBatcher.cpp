@@ -0,0 +1,211 @@
+#include "BarrierBatcher.h"
+
+namespace VulkanSampleFramework
+{
+	BarrierBatcher::BarrierBatcher() :
+		m_UseSynchronization2(false),
+		m_Statistics()
+	{
+	}
+
+	void BarrierBatcher::Initialize(bool useSynchronization2)
+	{
+		m_UseSynchronization2 = useSynchronization2 && (nullptr != vkCmdPipelineBarrier2KHR);
+		Clear();
+	}
+
+	void BarrierBatcher::AddMemoryBarrier(VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages, VkAccessFlags currentAccess,
+		VkAccessFlags newAccess)
+	{
+		m_MemoryBarriers.push_back
+		(
+			{
+				VK_STRUCTURE_TYPE_MEMORY_BARRIER,			// VkStructureType    sType
+				nullptr,									// const void       * pNext
+				currentAccess,								// VkAccessFlags      srcAccessMask
+				newAccess									// VkAccessFlags      dstAccessMask
+			}
+		);
+		m_MemoryBarriersStages.push_back({ generatingStages, consumingStages });
+	}
+
+	void BarrierBatcher::AddBufferBarrier(VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages, BufferTransition const &bufferTransition,
+		VkDeviceSize offset, VkDeviceSize size)
+	{
+		m_BufferBarriers.push_back
+		(
+			{
+				VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,		// VkStructureType    sType
+				nullptr,										// const void       * pNext
+				bufferTransition.m_CurrentAccess,				// VkAccessFlags      srcAccessMask
+				bufferTransition.m_NewAccess,					// VkAccessFlags      dstAccessMask
+				bufferTransition.m_CurrentQueueFamily,			// uint32_t           srcQueueFamilyIndex
+				bufferTransition.m_NewQueueFamily,				// uint32_t           dstQueueFamilyIndex
+				bufferTransition.m_Buffer,						// VkBuffer           buffer
+				offset,											// VkDeviceSize       offset
+				size											// VkDeviceSize       size
+			}
+		);
+		m_BufferBarriersStages.push_back({ generatingStages, consumingStages });
+	}
+
+	void BarrierBatcher::AddImageBarrier(VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages, ImageTransition const &imageTransition)
+	{
+		AddImageBarrier(generatingStages, consumingStages, imageTransition, { imageTransition.m_Aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS });
+	}
+
+	void BarrierBatcher::AddImageBarrier(VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages, ImageTransition const &imageTransition,
+		VkImageSubresourceRange const &subresourceRange)
+	{
+		m_ImageBarriers.push_back
+		(
+			{
+				VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,		// VkStructureType            sType
+				nullptr,									// const void               * pNext
+				imageTransition.m_CurrentAccess,			// VkAccessFlags              srcAccessMask
+				imageTransition.m_NewAccess,				// VkAccessFlags              dstAccessMask
+				imageTransition.m_CurrentLayout,			// VkImageLayout              oldLayout
+				imageTransition.m_NewLayout,				// VkImageLayout              newLayout
+				imageTransition.m_CurrentQueueFamily,		// uint32_t                   srcQueueFamilyIndex
+				imageTransition.m_NewQueueFamily,			// uint32_t                   dstQueueFamilyIndex
+				imageTransition.m_Image,					// VkImage                    image
+				subresourceRange							// VkImageSubresourceRange    subresourceRange
+			}
+		);
+		m_ImageBarriersStages.push_back({ generatingStages, consumingStages });
+	}
+
+	void BarrierBatcher::Flush(VkCommandBuffer commandBuffer)
+	{
+		if (IsEmpty())
+		{
+			return;
+		}
+
+		if (m_UseSynchronization2)
+		{
+			std::vector<VkMemoryBarrier2KHR> memoryBarriers;
+			for (size_t i = 0; i < m_MemoryBarriers.size(); ++i)
+			{
+				VkMemoryBarrier const &barrier = m_MemoryBarriers[i];
+				memoryBarriers.push_back
+				(
+					{
+						VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR,					// VkStructureType             sType
+						nullptr,												// const void                * pNext
+						m_MemoryBarriersStages[i].m_GeneratingStages,			// VkPipelineStageFlags2KHR    srcStageMask
+						barrier.srcAccessMask,									// VkAccessFlags2KHR           srcAccessMask
+						m_MemoryBarriersStages[i].m_ConsumingStages,			// VkPipelineStageFlags2KHR    dstStageMask
+						barrier.dstAccessMask									// VkAccessFlags2KHR           dstAccessMask
+					}
+				);
+			}
+
+			std::vector<VkBufferMemoryBarrier2KHR> bufferBarriers;
+			for (size_t i = 0; i < m_BufferBarriers.size(); ++i)
+			{
+				VkBufferMemoryBarrier const &barrier = m_BufferBarriers[i];
+				bufferBarriers.push_back
+				(
+					{
+						VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR,			// VkStructureType             sType
+						nullptr,												// const void                * pNext
+						m_BufferBarriersStages[i].m_GeneratingStages,			// VkPipelineStageFlags2KHR    srcStageMask
+						barrier.srcAccessMask,									// VkAccessFlags2KHR           srcAccessMask
+						m_BufferBarriersStages[i].m_ConsumingStages,			// VkPipelineStageFlags2KHR    dstStageMask
+						barrier.dstAccessMask,									// VkAccessFlags2KHR           dstAccessMask
+						barrier.srcQueueFamilyIndex,							// uint32_t                    srcQueueFamilyIndex
+						barrier.dstQueueFamilyIndex,							// uint32_t                    dstQueueFamilyIndex
+						barrier.buffer,											// VkBuffer                    buffer
+						barrier.offset,											// VkDeviceSize                offset
+						barrier.size											// VkDeviceSize                size
+					}
+				);
+			}
+
+			std::vector<VkImageMemoryBarrier2KHR> imageBarriers;
+			for (size_t i = 0; i < m_ImageBarriers.size(); ++i)
+			{
+				VkImageMemoryBarrier const &barrier = m_ImageBarriers[i];
+				imageBarriers.push_back
+				(
+					{
+						VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR,			// VkStructureType             sType
+						nullptr,												// const void                * pNext
+						m_ImageBarriersStages[i].m_GeneratingStages,			// VkPipelineStageFlags2KHR    srcStageMask
+						barrier.srcAccessMask,									// VkAccessFlags2KHR           srcAccessMask
+						m_ImageBarriersStages[i].m_ConsumingStages,				// VkPipelineStageFlags2KHR    dstStageMask
+						barrier.dstAccessMask,									// VkAccessFlags2KHR           dstAccessMask
+						barrier.oldLayout,										// VkImageLayout               oldLayout
+						barrier.newLayout,										// VkImageLayout               newLayout
+						barrier.srcQueueFamilyIndex,							// uint32_t                    srcQueueFamilyIndex
+						barrier.dstQueueFamilyIndex,							// uint32_t                    dstQueueFamilyIndex
+						barrier.image,											// VkImage                     image
+						barrier.subresourceRange								// VkImageSubresourceRange     subresourceRange
+					}
+				);
+			}
+
+			VkDependencyInfoKHR dependencyInfo =
+			{
+				VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR,					// VkStructureType                     sType
+				nullptr,												// const void                        * pNext
+				0,														// VkDependencyFlags                   dependencyFlags
+				static_cast<uint32_t>(memoryBarriers.size()),			// uint32_t                            memoryBarrierCount
+				memoryBarriers.data(),									// const VkMemoryBarrier2KHR         * pMemoryBarriers
+				static_cast<uint32_t>(bufferBarriers.size()),			// uint32_t                            bufferMemoryBarrierCount
+				bufferBarriers.data(),									// const VkBufferMemoryBarrier2KHR   * pBufferMemoryBarriers
+				static_cast<uint32_t>(imageBarriers.size()),			// uint32_t                            imageMemoryBarrierCount
+				imageBarriers.data()									// const VkImageMemoryBarrier2KHR    * pImageMemoryBarriers
+			};
+			vkCmdPipelineBarrier2KHR(commandBuffer, &dependencyInfo);
+		}
+		else
+		{
+			VkPipelineStageFlags generatingStages = 0;
+			VkPipelineStageFlags consumingStages = 0;
+			for (auto stages : { &m_MemoryBarriersStages, &m_BufferBarriersStages, &m_ImageBarriersStages })
+			{
+				for (auto &stageMasks : *stages)
+				{
+					generatingStages |= stageMasks.m_GeneratingStages;
+					consumingStages |= stageMasks.m_ConsumingStages;
+				}
+			}
+
+			vkCmdPipelineBarrier(commandBuffer, generatingStages, consumingStages, 0, static_cast<uint32_t>(m_MemoryBarriers.size()), m_MemoryBarriers.data(),
+				static_cast<uint32_t>(m_BufferBarriers.size()), m_BufferBarriers.data(), static_cast<uint32_t>(m_ImageBarriers.size()), m_ImageBarriers.data());
+		}
+
+		++m_Statistics.m_PipelineBarriersCount;
+		m_Statistics.m_MemoryBarriersCount += static_cast<uint32_t>(m_MemoryBarriers.size());
+		m_Statistics.m_BufferBarriersCount += static_cast<uint32_t>(m_BufferBarriers.size());
+		m_Statistics.m_ImageBarriersCount += static_cast<uint32_t>(m_ImageBarriers.size());
+		Clear();
+	}
+
+	bool BarrierBatcher::IsEmpty() const
+	{
+		return m_MemoryBarriers.empty() && m_BufferBarriers.empty() && m_ImageBarriers.empty();
+	}
+
+	PipelineBarrierStatistics BarrierBatcher::GetStatistics() const
+	{
+		return m_Statistics;
+	}
+
+	void BarrierBatcher::ResetStatistics()
+	{
+		m_Statistics = {};
+	}
+
+	void BarrierBatcher::Clear()
+	{
+		m_MemoryBarriers.clear();
+		m_BufferBarriers.clear();
+		m_ImageBarriers.clear();
+		m_MemoryBarriersStages.clear();
+		m_BufferBarriersStages.clear();
+		m_ImageBarriersStages.clear();
+	}
+}
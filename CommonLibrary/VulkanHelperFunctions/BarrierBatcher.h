@@ -0,0 +1,60 @@
+#pragma once
+#include "../CommonFiles/Common.h"
+#include "ResourcesAndMemoryFunctions.h"
+
+namespace VulkanSampleFramework
+{
+	// Pipeline barriers flushed by a barrier batcher since its last statistics reset (e.g. at the beginning of a frame)
+	// Barriers recorded directly with vkCmdPipelineBarrier() (e.g. by SetImageMemoryBarrier()) bypass the batcher and are not counted
+	struct PipelineBarrierStatistics
+	{
+		uint32_t	m_PipelineBarriersCount;	// Recorded vkCmdPipelineBarrier() and vkCmdPipelineBarrier2KHR() commands
+		uint32_t	m_MemoryBarriersCount;
+		uint32_t	m_BufferBarriersCount;
+		uint32_t	m_ImageBarriersCount;
+	};
+
+	// Accumulates barriers and records all of them with a single pipeline barrier, so it must be flushed before the next action command
+	// (draw, dispatch, copy, render pass begin, ...) depending on them. Without synchronization2 all barriers of a flush share merged
+	// stage masks, with it every barrier keeps its own ones.
+	class BarrierBatcher
+	{
+	public:
+		// Synchronization2 may be used only when VK_KHR_synchronization2 and its feature were enabled on the device
+		void Initialize(bool useSynchronization2);
+
+		void AddMemoryBarrier(VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages, VkAccessFlags currentAccess, VkAccessFlags newAccess);
+		void AddBufferBarrier(VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages, BufferTransition const &bufferTransition,
+			VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+		// Without a subresource range all mipmap levels and layers are transitioned
+		void AddImageBarrier(VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages, ImageTransition const &imageTransition);
+		void AddImageBarrier(VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages, ImageTransition const &imageTransition,
+			VkImageSubresourceRange const &subresourceRange);
+		void Flush(VkCommandBuffer commandBuffer);
+		bool IsEmpty() const;
+
+		// Batchers used from several threads count their barriers separately
+		PipelineBarrierStatistics GetStatistics() const;
+		void ResetStatistics();
+
+		BarrierBatcher();
+
+	private:
+		struct StageMasks
+		{
+			VkPipelineStageFlags	m_GeneratingStages;
+			VkPipelineStageFlags	m_ConsumingStages;
+		};
+
+		void Clear();
+
+		bool								m_UseSynchronization2;
+		std::vector<VkMemoryBarrier>		m_MemoryBarriers;
+		std::vector<VkBufferMemoryBarrier>	m_BufferBarriers;
+		std::vector<VkImageMemoryBarrier>	m_ImageBarriers;
+		std::vector<StageMasks>				m_MemoryBarriersStages;
+		std::vector<StageMasks>				m_BufferBarriersStages;
+		std::vector<StageMasks>				m_ImageBarriersStages;
+		PipelineBarrierStatistics			m_Statistics;
+	};
+}
@@ -0,0 +1,124 @@
+#include "CommandBufferCache.h"
+#include "DeferredDestructionQueue.h"
+
+namespace VulkanSampleFramework
+{
+	StaticCommandBufferCache::StaticCommandBufferCache() :
+		m_CommandPool(VK_NULL_HANDLE),
+		m_Generation(0),
+		m_RecordedBuffersCount(0)
+	{
+	}
+
+	StaticCommandBufferCache::~StaticCommandBufferCache()
+	{
+	}
+
+	bool StaticCommandBufferCache::Initialize(VkDevice logicalDevice, uint32_t queueFamily)
+	{
+		// Buffers are freed one by one when they are invalidated
+		return CreateCommandPool(logicalDevice, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, queueFamily, m_CommandPool);
+	}
+
+	void StaticCommandBufferCache::Destroy(VkDevice logicalDevice)
+	{
+		m_Entries.clear();
+		DestroyCommandPool(logicalDevice, m_CommandPool);
+	}
+
+	bool StaticCommandBufferCache::GetOrRecord(VkDevice logicalDevice, VkRenderPass renderPass, uint32_t subpass, VkFramebuffer framebuffer, std::vector<uint64_t> const &dependencies,
+		std::function<bool(VkCommandBuffer)> const &recordingFunction, VkCommandBuffer &commandBuffer)
+	{
+		for (auto entry = m_Entries.begin(); entry != m_Entries.end(); ++entry)
+		{
+			if ((entry->m_RenderPass == renderPass) && (entry->m_Subpass == subpass) && (entry->m_Framebuffer == framebuffer) &&
+				(entry->m_Generation == m_Generation))
+			{
+				if (entry->m_Dependencies == dependencies)
+				{
+					commandBuffer = entry->m_CommandBuffer;
+					return true;
+				}
+
+				// Something the buffer references has changed, so it is replaced with a new recording
+				FreeWhenUnused(logicalDevice, { entry->m_CommandBuffer });
+				m_Entries.erase(entry);
+				break;
+			}
+		}
+
+		std::vector<VkCommandBuffer> commandBuffers;
+		if (!AllocateCommandBuffers(logicalDevice, m_CommandPool, VK_COMMAND_BUFFER_LEVEL_SECONDARY, 1, commandBuffers))
+		{
+			return false;
+		}
+
+		VkCommandBufferInheritanceInfo inheritanceInfo =
+		{
+			VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,	// VkStructureType                  sType
+			nullptr,											// const void                     * pNext
+			renderPass,											// VkRenderPass                     renderPass
+			subpass,											// uint32_t                         subpass
+			framebuffer,										// VkFramebuffer                    framebuffer
+			VK_FALSE,											// VkBool32                         occlusionQueryEnable
+			0,													// VkQueryControlFlags              queryFlags
+			0													// VkQueryPipelineStatisticFlags    pipelineStatistics
+		};
+
+		// The same buffer is executed by every frame in flight, so it may be pending in several primary command buffers at once
+		if (!BeginCommandBufferRecordingOperation(commandBuffers[0], VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+			&inheritanceInfo))
+		{
+			FreeCommandBuffers(logicalDevice, m_CommandPool, commandBuffers);
+			return false;
+		}
+
+		if (!recordingFunction(commandBuffers[0]) || !EndCommandBufferRecordingOperation(commandBuffers[0]))
+		{
+			FreeCommandBuffers(logicalDevice, m_CommandPool, commandBuffers);
+			return false;
+		}
+
+		m_Entries.push_back({ renderPass, subpass, framebuffer, dependencies, m_Generation, commandBuffers[0] });
+		++m_RecordedBuffersCount;
+		commandBuffer = commandBuffers[0];
+		return true;
+	}
+
+	void StaticCommandBufferCache::Invalidate(VkDevice logicalDevice)
+	{
+		++m_Generation;
+
+		std::vector<VkCommandBuffer> commandBuffers;
+		for (auto & entry : m_Entries)
+		{
+			commandBuffers.push_back(entry.m_CommandBuffer);
+		}
+		m_Entries.clear();
+
+		FreeWhenUnused(logicalDevice, commandBuffers);
+	}
+
+	void StaticCommandBufferCache::FreeWhenUnused(VkDevice logicalDevice, std::vector<VkCommandBuffer> commandBuffers)
+	{
+		// Buffers may still be executed by frames in flight
+		if ((VK_NULL_HANDLE != m_CommandPool) && !commandBuffers.empty())
+		{
+			VkCommandPool commandPool = m_CommandPool;
+			DestroyWhenUnused(logicalDevice, [commandPool, commandBuffers](VkDevice device) mutable
+			{
+				FreeCommandBuffers(device, commandPool, commandBuffers);
+			});
+		}
+	}
+
+	uint64_t StaticCommandBufferCache::GetGeneration() const
+	{
+		return m_Generation;
+	}
+
+	uint32_t StaticCommandBufferCache::GetRecordedBuffersCount() const
+	{
+		return m_RecordedBuffersCount;
+	}
+}
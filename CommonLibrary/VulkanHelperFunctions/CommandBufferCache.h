@@ -0,0 +1,76 @@
+#pragma once
+#include <cstring>
+#include "../CommonFiles/Common.h"
+#include "CommandBufferAndSyncFunctions.h"
+
+namespace VulkanSampleFramework
+{
+	// Values of handles and parameters recorded into static command buffers. Handles of non-dispatchable objects are pointers
+	// on 64-bit platforms and 64-bit integers on 32-bit ones.
+	inline uint64_t ToCommandDependency(uint64_t value)
+	{
+		return value;
+	}
+
+	inline uint64_t ToCommandDependency(uint32_t value)
+	{
+		return value;
+	}
+
+	template<typename Object>
+	uint64_t ToCommandDependency(Object *handle)
+	{
+		return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+	}
+
+	inline uint64_t ToCommandDependency(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	// Secondary command buffers for content that doesn't change between frames, recorded once and submitted again every frame.
+	// Each buffer is recorded together with the list of its dependencies - handles (descriptor sets, vertex buffers, pipelines) and
+	// values (viewport size, push constant data) used by the recorded commands. It is reused as long as the same list is provided
+	// and recorded again, with the stale buffer freed after frames in flight finish, as soon as any of them changes.
+	class StaticCommandBufferCache
+	{
+	public:
+		bool Initialize(VkDevice logicalDevice, uint32_t queueFamily);
+		void Destroy(VkDevice logicalDevice);
+
+		// Framebuffer may be VK_NULL_HANDLE when it is recreated every frame, the buffer is then compatible with any framebuffer of the render pass
+		bool GetOrRecord(VkDevice logicalDevice, VkRenderPass renderPass, uint32_t subpass, VkFramebuffer framebuffer, std::vector<uint64_t> const &dependencies,
+			std::function<bool(VkCommandBuffer)> const &recordingFunction, VkCommandBuffer &commandBuffer);
+
+		// Drops all buffers, e.g. when the contents of a referenced object changed while its handle stayed the same. Buffers are freed
+		// through DestroyWhenUnused() after frames in flight stop executing them, so data they read (e.g. indirect commands) must not be
+		// overwritten by the new recordings either.
+		void Invalidate(VkDevice logicalDevice);
+
+		uint64_t GetGeneration() const;
+		uint32_t GetRecordedBuffersCount() const;
+
+		StaticCommandBufferCache();
+		~StaticCommandBufferCache();
+
+	private:
+		struct Entry
+		{
+			VkRenderPass			m_RenderPass;
+			uint32_t				m_Subpass;
+			VkFramebuffer			m_Framebuffer;
+			std::vector<uint64_t>	m_Dependencies;
+			uint64_t				m_Generation;
+			VkCommandBuffer			m_CommandBuffer;
+		};
+
+		void FreeWhenUnused(VkDevice logicalDevice, std::vector<VkCommandBuffer> commandBuffers);
+
+		VkCommandPool		m_CommandPool;
+		std::vector<Entry>	m_Entries;
+		uint64_t			m_Generation;
+		uint32_t			m_RecordedBuffersCount;
+	};
+}
@@ -1,7 +1,74 @@
 #include "CommandRecordingAndDrawing.h"
+#include "DescriptorSetsFunctions.h"
+#include "GraphicsAndComputePipeFunctions.h"
+#include "DeferredDestructionQueue.h"
+#include "QueueTimeline.h"
 
 namespace VulkanSampleFramework
 {
+	namespace
+	{
+		// Below this number of draws per worker the cost of starting a thread is bigger than the recording itself
+		size_t const MinimalNumberOfDrawsPerWorker = 64;
+
+		bool RecordDrawItemsIntoSecondaryCommandBuffer(VkCommandBuffer commandBuffer, VkCommandBufferInheritanceInfo const &inheritanceInfo, VkRect2D renderArea,
+			SecondaryCommandBufferDrawItem const *drawItems, size_t drawItemsCount)
+		{
+			if (!BeginCommandBufferRecordingOperation(commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+				const_cast<VkCommandBufferInheritanceInfo *>(&inheritanceInfo)))
+			{
+				return false;
+			}
+
+			// Dynamic state is not inherited from the primary command buffer
+			VkViewport viewport =
+			{
+				static_cast<float>(renderArea.offset.x),			// float    x
+				static_cast<float>(renderArea.offset.y),			// float    y
+				static_cast<float>(renderArea.extent.width),		// float    width
+				static_cast<float>(renderArea.extent.height),		// float    height
+				0.0f,												// float    minDepth
+				1.0f												// float    maxDepth
+			};
+			SetViewportStateDynamically(commandBuffer, 0, { viewport });
+			SetScissorStateDynamically(commandBuffer, 0, { renderArea });
+
+			VkPipeline currentPipeline = VK_NULL_HANDLE;
+			VkDescriptorSet currentDescriptorSet = VK_NULL_HANDLE;
+			VkBuffer currentVertexBuffer = VK_NULL_HANDLE;
+			VkDeviceSize currentVertexBufferOffset = 0;
+
+			for (size_t i = 0; i < drawItemsCount; ++i)
+			{
+				SecondaryCommandBufferDrawItem const &drawItem = drawItems[i];
+
+				if (drawItem.m_Pipeline != currentPipeline)
+				{
+					BindPipelineObject(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, drawItem.m_Pipeline);
+					currentPipeline = drawItem.m_Pipeline;
+				}
+
+				if ((VK_NULL_HANDLE != drawItem.m_DescriptorSet) && (drawItem.m_DescriptorSet != currentDescriptorSet))
+				{
+					BindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, drawItem.m_PipelineLayout, 0, { drawItem.m_DescriptorSet }, {});
+					currentDescriptorSet = drawItem.m_DescriptorSet;
+				}
+
+				if ((VK_NULL_HANDLE != drawItem.m_VertexBuffer.m_Buffer) &&
+					((drawItem.m_VertexBuffer.m_Buffer != currentVertexBuffer) || (drawItem.m_VertexBuffer.m_MemoryOffset != currentVertexBufferOffset)))
+				{
+					vkCmdBindVertexBuffers(commandBuffer, 0, 1, &drawItem.m_VertexBuffer.m_Buffer, &drawItem.m_VertexBuffer.m_MemoryOffset);
+					currentVertexBuffer = drawItem.m_VertexBuffer.m_Buffer;
+					currentVertexBufferOffset = drawItem.m_VertexBuffer.m_MemoryOffset;
+				}
+
+				DrawGeometry(commandBuffer, drawItem.m_VertexCount, drawItem.m_InstanceCount, drawItem.m_FirstVertex, drawItem.m_FirstInstance);
+			}
+
+			return EndCommandBufferRecordingOperation(commandBuffer);
+		}
+	}
+
 	void ClearColorImage(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout imageLayout,
 		std::vector<VkImageSubresourceRange> const &imageSubresourceRanges, VkClearColorValue &clearColor)
 	{
@@ -82,6 +149,16 @@ namespace VulkanSampleFramework
 		vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
 	}
 
+	void DrawGeometryIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
+	{
+		vkCmdDrawIndirect(commandBuffer, buffer, offset, drawCount, stride);
+	}
+
+	void DrawIndexedGeometryIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
+	{
+		vkCmdDrawIndexedIndirect(commandBuffer, buffer, offset, drawCount, stride);
+	}
+
 	void DispatchComputeWork(VkCommandBuffer commandBuffer, uint32_t xSize, uint32_t ySize, uint32_t zSize)
 	{
 		vkCmdDispatch(commandBuffer, xSize, ySize, zSize);
@@ -114,11 +191,107 @@ namespace VulkanSampleFramework
 		return true;
 	}
 
+	bool RecordDrawsIntoSecondaryCommandBuffersOnMultipleThreads(VkDevice logicalDevice, VkRenderPass renderPass, uint32_t subpass, VkFramebuffer framebuffer,
+		VkRect2D renderArea, std::vector<SecondaryCommandBufferDrawItem> const &drawItems, SecondaryCommandBuffersResources &resources,
+		std::vector<VkCommandBuffer> &recordedCommandBuffers)
+	{
+		recordedCommandBuffers.clear();
+
+		size_t const workersCount = resources.m_CommandBuffers.size();
+		if (0 == workersCount)
+		{
+			std::cout << "No secondary command buffers were prepared for recording." << std::endl;
+			return false;
+		}
+
+		if (drawItems.empty())
+		{
+			return true;
+		}
+
+		// Split draws into contiguous chunks, so state changes between neighbouring items are still filtered inside each chunk
+		size_t usedWorkersCount = drawItems.size() / MinimalNumberOfDrawsPerWorker;
+		usedWorkersCount = usedWorkersCount > workersCount ? workersCount : (usedWorkersCount < 1 ? 1 : usedWorkersCount);
+		size_t const drawsPerWorker = (drawItems.size() + usedWorkersCount - 1) / usedWorkersCount;
+
+		VkCommandBufferInheritanceInfo inheritanceInfo =
+		{
+			VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,	// VkStructureType                  sType
+			nullptr,											// const void                     * pNext
+			renderPass,											// VkRenderPass                     renderPass
+			subpass,											// uint32_t                         subpass
+			framebuffer,										// VkFramebuffer                    framebuffer
+			VK_FALSE,											// VkBool32                         occlusionQueryEnable
+			0,													// VkQueryControlFlags              queryFlags
+			0													// VkQueryPipelineStatisticFlags    pipelineStatistics
+		};
+
+		// Buffers recorded previously from these pools must have finished execution, so releasing them all at once is cheaper than per buffer reset
+		for (size_t i = 0; i < usedWorkersCount; ++i)
+		{
+			if (!ResetCommandPool(logicalDevice, resources.m_CommandPools[i], false))
+			{
+				return false;
+			}
+		}
+
+		std::vector<char> results(usedWorkersCount, 0);
+		auto recordChunk = [&](size_t workerIndex)
+		{
+			size_t const first = workerIndex * drawsPerWorker;
+			size_t const last = first + drawsPerWorker < drawItems.size() ? first + drawsPerWorker : drawItems.size();
+			size_t const count = last > first ? last - first : 0;
+			results[workerIndex] = RecordDrawItemsIntoSecondaryCommandBuffer(resources.m_CommandBuffers[workerIndex], inheritanceInfo, renderArea,
+				drawItems.data() + first, count) ? 1 : 0;
+		};
+
+		// The calling thread records the first chunk itself instead of waiting idle
+		std::vector<std::thread> threads;
+		for (size_t i = 1; i < usedWorkersCount; ++i)
+		{
+			threads.emplace_back(recordChunk, i);
+		}
+		recordChunk(0);
+
+		for (auto & thread : threads)
+		{
+			thread.join();
+		}
+
+		for (size_t i = 0; i < usedWorkersCount; ++i)
+		{
+			if (!results[i])
+			{
+				return false;
+			}
+			recordedCommandBuffers.push_back(resources.m_CommandBuffers[i]);
+		}
+		return true;
+	}
+
+	bool RecordRenderPassWithSecondaryCommandBuffersOnMultipleThreads(VkDevice logicalDevice, VkCommandBuffer commandBuffer, VkRenderPass renderPass,
+		VkFramebuffer framebuffer, VkRect2D renderArea, std::vector<VkClearValue> const &clearValues, std::vector<SecondaryCommandBufferDrawItem> const &drawItems,
+		SecondaryCommandBuffersResources &resources)
+	{
+		std::vector<VkCommandBuffer> secondaryCommandBuffers;
+		if (!RecordDrawsIntoSecondaryCommandBuffersOnMultipleThreads(logicalDevice, renderPass, 0, framebuffer, renderArea, drawItems, resources,
+			secondaryCommandBuffers))
+		{
+			return false;
+		}
+
+		// Subpass recorded with secondary command buffers contents may only contain vkCmdExecuteCommands
+		BeginRenderPass(commandBuffer, renderPass, framebuffer, renderArea, clearValues, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+		ExecuteSecondaryCommandBufferInsidePrimaryCommandBuffer(commandBuffer, secondaryCommandBuffers);
+		EndRenderPass(commandBuffer);
+		return true;
+	}
+
 	bool PrepareSingleFrameOfAnimation(VkDevice logicalDevice, VkQueue graphicsQueue, VkQueue presentQueue, VkSwapchainKHR swapchain, VkExtent2D swapchainSize,
 		std::vector<VkImageView> const &swapchainImageViews, VkImageView depthAttachment, std::vector<WaitSemaphoreInfo> const &waitInfos,
 		VkSemaphore imageAcquiredSemaphore, VkSemaphore readyToPresentSemaphore, VkFence finishedDrawingFence,
 		std::function<bool(VkCommandBuffer, uint32_t, VkFramebuffer)> recordCommandBuffer, VkCommandBuffer commandBuffer, VkRenderPass renderPass,
-		VkFramebuffer &framebuffer)
+		VkFramebuffer &framebuffer, uint64_t *submittedTimelineValue)
 
 	{
 		uint32_t imageIndex;
@@ -133,6 +306,8 @@ namespace VulkanSampleFramework
 			attachments.push_back(depthAttachment);
 		}
 		
+		// Framebuffer of the previous use of these frame resources is no longer used, because they are reused only after that frame finished
+		DestroyFramebuffer(logicalDevice, framebuffer);
 		if (!CreateFramebuffer(logicalDevice, renderPass, attachments, swapchainSize.width, swapchainSize.height, 1, framebuffer))
 		{
 			return false;
@@ -152,7 +327,18 @@ namespace VulkanSampleFramework
 			}
 		);
 
-		if (!SubmitCommandBuffersToQueue(graphicsQueue, waitSemaphoreInfos, { commandBuffer }, { readyToPresentSemaphore }, finishedDrawingFence))
+		// Swapchain images are still synchronized with binary semaphores, the timeline only replaces the fence
+		QueueTimeline *timeline = FindQueueTimeline(graphicsQueue);
+		if ((nullptr != submittedTimelineValue) && (nullptr != timeline))
+		{
+			TimelinePoint signaledPoint;
+			if (!timeline->Submit({}, waitSemaphoreInfos, { commandBuffer }, { readyToPresentSemaphore }, signaledPoint))
+			{
+				return false;
+			}
+			*submittedTimelineValue = signaledPoint.m_Value;
+		}
+		else if (!SubmitCommandBuffersToQueue(graphicsQueue, waitSemaphoreInfos, { commandBuffer }, { readyToPresentSemaphore }, finishedDrawingFence))
 		{
 			return false;
 		}
@@ -174,29 +360,66 @@ namespace VulkanSampleFramework
 	bool IncreasePerformanceThroughIncreasingTheNumberOfSeparatelyRenderedFrames(VkDevice logicalDevice, VkQueue graphicsQueue, VkQueue presentQueue,
 		VkSwapchainKHR swapchain, VkExtent2D swapchainSize, std::vector<VkImageView> const &swapchainImageViews, VkRenderPass renderPass,
 		std::vector<WaitSemaphoreInfo> const &waitInfos, std::function<bool(VkCommandBuffer, uint32_t, VkFramebuffer)> recordCommandBuffer,
-		std::vector<FrameResources> &frameResources)
+		std::vector<FrameResources> &frameResources, uint32_t &frameIndex)
 	{
-		static uint32_t frameIndex = 0;
+		// Frame resources may have been recreated with fewer frames
+		frameIndex = frameIndex < frameResources.size() ? frameIndex : 0;
 		FrameResources & currentFrame = frameResources[frameIndex];
 
-		if (!WaitForFences(logicalDevice, {currentFrame.m_DrawingFinishedFence}, false, 2000000000))
+		DeferredDestructionQueue *destructionQueue = GetDeferredDestructionQueue(logicalDevice);
+		QueueTimeline *timeline = FindQueueTimeline(graphicsQueue);
+		if (nullptr != timeline)
 		{
-			return false;
-		}
+			// Frames which were never submitted wait for the initial value, which is already reached
+			if (!timeline->Wait(logicalDevice, currentFrame.m_TimelineValue, 2000000000))
+			{
+				return false;
+			}
+
+			if (nullptr != destructionQueue)
+			{
+				destructionQueue->FrameCompleted(currentFrame.m_FrameNumber);
+				destructionQueue->Collect(logicalDevice);
+			}
 
-		if (!ResetFences(logicalDevice, {currentFrame.m_DrawingFinishedFence}))
+			if (!PrepareSingleFrameOfAnimation(logicalDevice, graphicsQueue, presentQueue, swapchain, swapchainSize, swapchainImageViews,
+				currentFrame.m_DepthAttachment, waitInfos, currentFrame.m_ImageAcquiredSemaphore, currentFrame.m_ReadyToPresentSemaphore,
+				VK_NULL_HANDLE, recordCommandBuffer, currentFrame.m_CommandBuffer, renderPass, currentFrame.m_Framebuffer, &currentFrame.m_TimelineValue))
+			{
+				return false;
+			}
+		}
+		else
 		{
-			return false;
+			if (!WaitForFences(logicalDevice, {currentFrame.m_DrawingFinishedFence}, false, 2000000000))
+			{
+				return false;
+			}
+
+			if (!ResetFences(logicalDevice, {currentFrame.m_DrawingFinishedFence}))
+			{
+				return false;
+			}
+
+			if (nullptr != destructionQueue)
+			{
+				destructionQueue->FrameCompleted(currentFrame.m_FrameNumber);
+				destructionQueue->Collect(logicalDevice);
+			}
+
+			if (!PrepareSingleFrameOfAnimation(logicalDevice, graphicsQueue, presentQueue, swapchain, swapchainSize, swapchainImageViews,
+				currentFrame.m_DepthAttachment, waitInfos, currentFrame.m_ImageAcquiredSemaphore, currentFrame.m_ReadyToPresentSemaphore,
+				currentFrame.m_DrawingFinishedFence, recordCommandBuffer, currentFrame.m_CommandBuffer, renderPass, currentFrame.m_Framebuffer))
+			{
+				return false;
+			}
 		}
 
-		if (!PrepareSingleFrameOfAnimation(logicalDevice, graphicsQueue, presentQueue, swapchain, swapchainSize, swapchainImageViews,
-			currentFrame.m_DepthAttachment, waitInfos, currentFrame.m_ImageAcquiredSemaphore, currentFrame.m_ReadyToPresentSemaphore,
-			currentFrame.m_DrawingFinishedFence, recordCommandBuffer, currentFrame.m_CommandBuffer, renderPass, currentFrame.m_Framebuffer))
+		if (nullptr != destructionQueue)
 		{
-			return false;
+			currentFrame.m_FrameNumber = destructionQueue->FrameSubmitted();
 		}
-
-		frameIndex = (frameIndex + 1) % frameResources.size();
+		frameIndex = (frameIndex + 1) % static_cast<uint32_t>(frameResources.size());
 		return true;
 	}
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "ImagePresentFunctions.h"
 #include "RenderPassAndFramebufferFunctions.h"
 #include "ResourcesAndMemoryFunctions.h"
+#include "SyncObjectPools.h"
 
 namespace VulkanSampleFramework
 {
@@ -26,6 +27,8 @@ namespace VulkanSampleFramework
 		VkSemaphore					m_ImageAcquiredSemaphore;
 		VkSemaphore					m_ReadyToPresentSemaphore;
 		VkFence						m_DrawingFinishedFence;
+		uint64_t					m_TimelineValue;				// Signaled on the graphics queue timeline when drawing finishes, used instead of the fence
+		uint64_t					m_FrameNumber;					// Last submitted frame, reported to the deferred destruction queue when it finishes
 		VkImageView					m_DepthAttachment;
 		VkFramebuffer				m_Framebuffer;
 
@@ -49,6 +52,8 @@ namespace VulkanSampleFramework
 				m_ImageAcquiredSemaphore = std::move(other.m_ImageAcquiredSemaphore);
 				m_ReadyToPresentSemaphore = std::move(other.m_ReadyToPresentSemaphore);
 				m_DrawingFinishedFence = std::move(other.m_DrawingFinishedFence);
+				m_TimelineValue = other.m_TimelineValue;
+				m_FrameNumber = other.m_FrameNumber;
 				m_DepthAttachment = std::move(other.m_DepthAttachment);
 				m_Framebuffer = std::move(other.m_Framebuffer);
 			}
@@ -68,14 +73,18 @@ namespace VulkanSampleFramework
 			}
 			m_CommandBuffer = commandBuffers[0];
 
-			if (!CreateSemaphore(logicalDevice, m_ImageAcquiredSemaphore))
+			// Semaphores come from the pool of the device when one is registered, so frame resources recreated for a different number of
+			// frames in flight reuse them
+			m_ImageAcquiredSemaphore = VK_NULL_HANDLE;
+			m_ReadyToPresentSemaphore = VK_NULL_HANDLE;
+			SemaphorePool *semaphorePool = GetSemaphorePool(logicalDevice);
+			for (auto semaphore : { &m_ImageAcquiredSemaphore, &m_ReadyToPresentSemaphore })
 			{
-				return false;
-			}
-
-			if (!CreateSemaphore(logicalDevice, m_ReadyToPresentSemaphore))
-			{
-				return false;
+				bool acquired = (nullptr != semaphorePool) ? semaphorePool->AcquireSemaphore(logicalDevice, *semaphore) : CreateSemaphore(logicalDevice, *semaphore);
+				if (!acquired)
+				{
+					return false;
+				}
 			}
 
 			if (!CreateFence(logicalDevice, true, m_DrawingFinishedFence))
@@ -83,6 +92,8 @@ namespace VulkanSampleFramework
 				return false;
 			}
 
+			m_TimelineValue = 0;
+			m_FrameNumber = 0;
 			m_DepthAttachment = VK_NULL_HANDLE;
 			m_Framebuffer = VK_NULL_HANDLE;
 
@@ -93,14 +104,78 @@ namespace VulkanSampleFramework
 		void Destroy(VkDevice logicalDevice)
 		{
 			m_CommandBuffer = VK_NULL_HANDLE;
-			DestroySemaphore(logicalDevice, m_ImageAcquiredSemaphore);
-			DestroySemaphore(logicalDevice, m_ReadyToPresentSemaphore);
+
+			// Frame resources are destroyed only when their frames are finished, so nothing waits on the semaphores anymore
+			SemaphorePool *semaphorePool = GetSemaphorePool(logicalDevice);
+			for (auto semaphore : { &m_ImageAcquiredSemaphore, &m_ReadyToPresentSemaphore })
+			{
+				if ((nullptr != semaphorePool) && (VK_NULL_HANDLE != *semaphore))
+				{
+					semaphorePool->ReleaseSemaphore(*semaphore);
+				}
+				else
+				{
+					DestroySemaphore(logicalDevice, *semaphore);
+				}
+			}
 			DestroyFence(logicalDevice, m_DrawingFinishedFence);
 			DestroyImageView(logicalDevice, m_DepthAttachment);
 			DestroyFramebuffer(logicalDevice, m_Framebuffer);
 		}
 	};
 
+	// Single draw recorded into a secondary command buffer, state is only rebound when it differs from the previous item
+	struct SecondaryCommandBufferDrawItem
+	{
+		VkPipeline					m_Pipeline;
+		VkPipelineLayout			m_PipelineLayout;
+		VkDescriptorSet				m_DescriptorSet;
+		VertexBufferParameters		m_VertexBuffer;
+		uint32_t					m_VertexCount;
+		uint32_t					m_InstanceCount;
+		uint32_t					m_FirstVertex;
+		uint32_t					m_FirstInstance;
+	};
+
+	// Command pools are not thread safe, so every worker records into a buffer allocated from its own pool
+	// One set is needed per frame in flight, because the buffers are re-recorded every time the frame is prepared
+	struct SecondaryCommandBuffersResources
+	{
+		std::vector<VkCommandPool>		m_CommandPools;
+		std::vector<VkCommandBuffer>	m_CommandBuffers;
+
+		bool Initialize(VkDevice logicalDevice, uint32_t queueFamily, uint32_t workersCount)
+		{
+			for (uint32_t i = 0; i < workersCount; ++i)
+			{
+				m_CommandPools.emplace_back(VkCommandPool());
+				if (!CreateCommandPool(logicalDevice, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT, queueFamily, m_CommandPools.back()))
+				{
+					return false;
+				}
+
+				std::vector<VkCommandBuffer> commandBuffers;
+				if (!AllocateCommandBuffers(logicalDevice, m_CommandPools.back(), VK_COMMAND_BUFFER_LEVEL_SECONDARY, 1, commandBuffers))
+				{
+					return false;
+				}
+				m_CommandBuffers.push_back(commandBuffers[0]);
+			}
+			return true;
+		}
+
+		// Command buffers are freed together with their pools
+		void Destroy(VkDevice logicalDevice)
+		{
+			m_CommandBuffers.clear();
+			for (auto & commandPool : m_CommandPools)
+			{
+				DestroyCommandPool(logicalDevice, commandPool);
+			}
+			m_CommandPools.clear();
+		}
+	};
+
 
 	void ClearColorImage(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout imageLayout,
 		std::vector<VkImageSubresourceRange> const &image_subresource_ranges, VkClearColorValue &clearColor);
@@ -119,17 +194,28 @@ namespace VulkanSampleFramework
 	void DrawGeometry(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance);
 	void DrawIndexedGeometry(VkCommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, uint32_t vertexOffset,
 		uint32_t firstInstance);
+	void DrawGeometryIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride);
+	void DrawIndexedGeometryIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride);
 	void DispatchComputeWork(VkCommandBuffer commandBuffer, uint32_t xSize, uint32_t ySize, uint32_t zSize);
 	void ExecuteSecondaryCommandBufferInsidePrimaryCommandBuffer(VkCommandBuffer commandBuffer, std::vector<VkCommandBuffer> const &secondaryCommandBuffers);
 	bool RecordCommandBuffersOnMultipleThreads(std::vector<CommandBufferRecordingThreadParameters> const &threadsParameters, VkQueue queue,
 		std::vector<WaitSemaphoreInfo> waitSemaphoreInfos, std::vector<VkSemaphore> signalSemaphores, VkFence fence);
+	bool RecordDrawsIntoSecondaryCommandBuffersOnMultipleThreads(VkDevice logicalDevice, VkRenderPass renderPass, uint32_t subpass, VkFramebuffer framebuffer,
+		VkRect2D renderArea, std::vector<SecondaryCommandBufferDrawItem> const &drawItems, SecondaryCommandBuffersResources &resources,
+		std::vector<VkCommandBuffer> &recordedCommandBuffers);
+	bool RecordRenderPassWithSecondaryCommandBuffersOnMultipleThreads(VkDevice logicalDevice, VkCommandBuffer commandBuffer, VkRenderPass renderPass,
+		VkFramebuffer framebuffer, VkRect2D renderArea, std::vector<VkClearValue> const &clearValues, std::vector<SecondaryCommandBufferDrawItem> const &drawItems,
+		SecondaryCommandBuffersResources &resources);
 	bool PrepareSingleFrameOfAnimation(VkDevice logicalDevice, VkQueue graphicsQueue, VkQueue presentQueue, VkSwapchainKHR swapchain, VkExtent2D swapchainSize,
 		std::vector<VkImageView> const &swapchainImageViews, VkImageView depthAttachment, std::vector<WaitSemaphoreInfo> const &waitInfos,
 		VkSemaphore imageAcquiredSemaphore, VkSemaphore readyToPresentSemaphore, VkFence finishedDrawingFence,
 		std::function<bool(VkCommandBuffer, uint32_t, VkFramebuffer)> recordCommandBuffer, VkCommandBuffer commandBuffer, VkRenderPass renderPass,
-		VkFramebuffer &framebuffer);
+		VkFramebuffer &framebuffer, uint64_t *submittedTimelineValue = nullptr);
+	// Frames are paced with the timeline registered for the graphics queue when there is one, otherwise with fences of frame resources.
+	// Frame index selects the frame resources and is advanced after the frame is submitted, it is owned by the caller.
+	// Finished frames are reported to the current deferred destruction queue, which then destroys objects they could use.
 	bool IncreasePerformanceThroughIncreasingTheNumberOfSeparatelyRenderedFrames(VkDevice logicalDevice, VkQueue graphicsQueue, VkQueue presentQueue,
 		VkSwapchainKHR swapchain, VkExtent2D swapchainSize, std::vector<VkImageView> const &swapchainImageViews, VkRenderPass renderPass,
 		std::vector<WaitSemaphoreInfo> const &waitInfos, std::function<bool(VkCommandBuffer, uint32_t, VkFramebuffer)> recordCommandBuffer,
-		std::vector<FrameResources> &frameResources);
+		std::vector<FrameResources> &frameResources, uint32_t &frameIndex);
 }
\ No newline at end of file
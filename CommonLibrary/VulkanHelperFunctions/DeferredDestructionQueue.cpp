@@ -0,0 +1,126 @@
+#include "DeferredDestructionQueue.h"
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		DeviceRegistry<DeferredDestructionQueue> DeferredDestructionQueues;
+	}
+
+	DeferredDestructionQueue::DeferredDestructionQueue() :
+		m_SubmittedFrame(0),
+		m_CompletedFrame(0)
+	{
+	}
+
+	void DeferredDestructionQueue::Enqueue(DestroyFunction const &destroyFunction)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_PendingDestructions.push_back({ destroyFunction, false, m_SubmittedFrame + 1, { VK_NULL_HANDLE, 0 } });
+	}
+
+	void DeferredDestructionQueue::Enqueue(DestroyFunction const &destroyFunction, TimelinePoint const &lastUse)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_PendingDestructions.push_back({ destroyFunction, true, 0, lastUse });
+	}
+
+	uint64_t DeferredDestructionQueue::FrameSubmitted()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return ++m_SubmittedFrame;
+	}
+
+	void DeferredDestructionQueue::FrameCompleted(uint64_t frameNumber)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_CompletedFrame = frameNumber > m_CompletedFrame ? frameNumber : m_CompletedFrame;
+	}
+
+	bool DeferredDestructionQueue::Collect(VkDevice logicalDevice)
+	{
+		// Destroy functions are called without the lock, because they may enqueue other objects
+		std::vector<DestroyFunction> completedDestructions;
+		bool result = true;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (size_t i = 0; i < m_PendingDestructions.size();)
+			{
+				PendingDestruction &pendingDestruction = m_PendingDestructions[i];
+
+				bool completed = pendingDestruction.m_Frame <= m_CompletedFrame;
+				if (pendingDestruction.m_TimelineBased)
+				{
+					uint64_t reachedValue = 0;
+					if (VK_SUCCESS != vkGetSemaphoreCounterValueKHR(logicalDevice, pendingDestruction.m_LastUse.m_Semaphore, &reachedValue))
+					{
+						std::cout << "Could not get a value of a timeline semaphore." << std::endl;
+						result = false;
+						break;
+					}
+					completed = reachedValue >= pendingDestruction.m_LastUse.m_Value;
+				}
+
+				if (!completed)
+				{
+					++i;
+					continue;
+				}
+
+				// Objects are destroyed in the order they were enqueued
+				completedDestructions.push_back(std::move(pendingDestruction.m_Destroy));
+				m_PendingDestructions.erase(m_PendingDestructions.begin() + i);
+			}
+		}
+
+		for (auto &destroyFunction : completedDestructions)
+		{
+			destroyFunction(logicalDevice);
+		}
+		return result;
+	}
+
+	void DeferredDestructionQueue::Flush(VkDevice logicalDevice)
+	{
+		std::vector<PendingDestruction> pendingDestructions;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			pendingDestructions.swap(m_PendingDestructions);
+			m_CompletedFrame = m_SubmittedFrame;
+		}
+
+		for (auto &pendingDestruction : pendingDestructions)
+		{
+			pendingDestruction.m_Destroy(logicalDevice);
+		}
+	}
+
+	size_t DeferredDestructionQueue::GetPendingCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_PendingDestructions.size();
+	}
+
+	void SetDeferredDestructionQueue(VkDevice logicalDevice, DeferredDestructionQueue *queue)
+	{
+		DeferredDestructionQueues.Set(logicalDevice, queue);
+	}
+
+	DeferredDestructionQueue * GetDeferredDestructionQueue(VkDevice logicalDevice)
+	{
+		return DeferredDestructionQueues.Get(logicalDevice);
+	}
+
+	void DestroyWhenUnused(VkDevice logicalDevice, DestroyFunction const &destroyFunction)
+	{
+		DeferredDestructionQueue *queue = DeferredDestructionQueues.Get(logicalDevice);
+		if (nullptr != queue)
+		{
+			queue->Enqueue(destroyFunction);
+		}
+		else
+		{
+			destroyFunction(logicalDevice);
+		}
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <mutex>
+#include "../CommonFiles/Common.h"
+#include "QueueTimeline.h"
+#include "DeviceRegistry.h"
+
+namespace VulkanSampleFramework
+{
+	// Destroys or frees objects, e.g. by calling DestroyImage() or FreeMemoryObject() with handles captured by value
+	using DestroyFunction = std::function<void(VkDevice logicalDevice)>;
+
+	// Delays destruction of objects until the work which may still use them has finished, so replacing resources (e.g. when the swapchain
+	// is recreated) doesn't need to wait until the whole device is idle. Objects are tied either to frames, whose completion is reported by
+	// the frame loop, or to points on queue timelines.
+	class DeferredDestructionQueue
+	{
+	public:
+		// Objects may still be used by the frame being recorded, so they are destroyed after the next submitted frame finishes
+		void Enqueue(DestroyFunction const &destroyFunction);
+		void Enqueue(DestroyFunction const &destroyFunction, TimelinePoint const &lastUse);
+
+		// Returns the number of the submitted frame, numbers start with 1
+		uint64_t FrameSubmitted();
+		// Frames are finished in the submission order, so all earlier frames are finished too
+		void FrameCompleted(uint64_t frameNumber);
+		// Destroys objects whose frames or timeline points were reached
+		bool Collect(VkDevice logicalDevice);
+		// Destroys all objects, device must be idle
+		void Flush(VkDevice logicalDevice);
+
+		size_t GetPendingCount() const;
+
+		DeferredDestructionQueue();
+
+	private:
+		struct PendingDestruction
+		{
+			DestroyFunction		m_Destroy;
+			bool				m_TimelineBased;
+			uint64_t			m_Frame;
+			TimelinePoint		m_LastUse;
+		};
+
+		std::vector<PendingDestruction>		m_PendingDestructions;
+		uint64_t							m_SubmittedFrame;
+		uint64_t							m_CompletedFrame;
+		mutable std::mutex					m_Mutex;
+	};
+
+	// Queue used by the framework and helper functions replacing resources of the device at runtime, none by default
+	void SetDeferredDestructionQueue(VkDevice logicalDevice, DeferredDestructionQueue *queue);
+	DeferredDestructionQueue * GetDeferredDestructionQueue(VkDevice logicalDevice);
+
+	// Enqueues the destruction into the queue of the device, or destroys right away without it (the object must not be used then)
+	void DestroyWhenUnused(VkDevice logicalDevice, DestroyFunction const &destroyFunction);
+}
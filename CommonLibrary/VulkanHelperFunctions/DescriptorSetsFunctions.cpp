@@ -1,5 +1,6 @@
 #include "DescriptorSetsFunctions.h"
 #include "ResourcesAndMemoryFunctions.h"
+#include "ResourceStateTracker.h"
 
 namespace VulkanSampleFramework
 {
@@ -71,6 +72,71 @@ namespace VulkanSampleFramework
 		return true;
 	}
 
+	bool IsCompressedTextureFormatSupported(VkPhysicalDevice physicalDevice, VkFormat format, bool linearFiltering)
+	{
+		uint32_t blockWidth;
+		uint32_t blockHeight;
+		uint32_t blockSize;
+		if (!GetCompressedFormatBlockInfo(format, blockWidth, blockHeight, blockSize))
+		{
+			return false;
+		}
+
+		// ETC2 and ASTC formats are usually supported only by mobile devices, BC formats only by desktop ones
+		VkFormatProperties formatProperties;
+		vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &formatProperties);
+		VkFormatFeatureFlags requiredFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | (linearFiltering ? VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT : 0);
+		return requiredFeatures == (formatProperties.optimalTilingFeatures & requiredFeatures);
+	}
+
+	bool CreateSampledImageFromCompressedTexture(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, CompressedTexture const &texture, bool linearFiltering,
+		VkQueue queue, VkCommandBuffer commandBuffer, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties, VkImage &sampledImage,
+		VkDeviceMemory &memoryObject, VkImageView &sampledImageView)
+	{
+		if (!IsCompressedTextureFormatSupported(physicalDevice, texture.m_Format, linearFiltering))
+		{
+			std::cout << "Provided compressed texture format is not supported for a sampled image." << std::endl;
+			return false;
+		}
+
+		VkImageType imageType = texture.m_Size.depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
+		VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D;
+		if (texture.m_Size.depth > 1)
+		{
+			viewType = VK_IMAGE_VIEW_TYPE_3D;
+		}
+		else if (texture.m_Cubemap)
+		{
+			viewType = texture.m_LayersCount > 6 ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE;
+		}
+		else if (texture.m_LayersCount > 1)
+		{
+			viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+		}
+
+		if (!CreateSampledImage(physicalDevice, logicalDevice, imageType, texture.m_Format, texture.m_Size, texture.m_MipmapsCount, texture.m_LayersCount,
+			VK_IMAGE_USAGE_TRANSFER_DST_BIT, texture.m_Cubemap, viewType, VK_IMAGE_ASPECT_COLOR_BIT, linearFiltering, physicalDeviceMemoryProperties,
+			sampledImage, memoryObject, sampledImageView))
+		{
+			return false;
+		}
+
+		// New image has no contents yet, so transitions from the undefined layout discard nothing
+		ResourceStateTracker *stateTracker = GetResourceStateTracker(logicalDevice);
+		if (nullptr != stateTracker)
+		{
+			stateTracker->RegisterImage(sampledImage, VK_IMAGE_ASPECT_COLOR_BIT, texture.m_MipmapsCount, texture.m_LayersCount);
+		}
+
+		std::vector<VkBufferImageCopy> regions;
+		SpecifyCompressedTextureCopyRegions(texture, regions);
+
+		return UseStagingBufferToUpdateImageRegionsWithDeviceLocalMemoryBound(logicalDevice, texture.m_Data.size(),
+			const_cast<unsigned char *>(texture.m_Data.data()), sampledImage, regions, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			0, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			queue, commandBuffer, {}, physicalDeviceMemoryProperties);
+	}
+
 	bool CreateStorageImage(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkImageType type, VkFormat format, VkExtent3D size, uint32_t numMipmaps, uint32_t numLayers,
 		VkImageUsageFlags usage,VkImageViewType viewType, VkImageAspectFlags aspect, bool atomicOperations, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties, 
 		VkImage &storageImage, VkDeviceMemory &memoryObject, VkImageView &storageImageView)
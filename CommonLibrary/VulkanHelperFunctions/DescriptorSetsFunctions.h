@@ -1,5 +1,6 @@
 #pragma once
 #include "../CommonFiles/Common.h"
+#include "../CommonFiles/TextureContainers.h"
 
 namespace VulkanSampleFramework
 {
@@ -46,6 +47,11 @@ namespace VulkanSampleFramework
 	bool CreateSampledImage(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkImageType type, VkFormat format, VkExtent3D size, uint32_t numMipmaps, uint32_t numLayers,
 		VkImageUsageFlags usage, bool cubemap, VkImageViewType viewType, VkImageAspectFlags aspect, bool linearFiltering, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties,
 		VkImage &sampledImage, VkDeviceMemory &memoryObject, VkImageView &sampledImageView);
+	bool IsCompressedTextureFormatSupported(VkPhysicalDevice physicalDevice, VkFormat format, bool linearFiltering);
+	// Uploads all subresources of the texture and leaves the image in the shader read-only layout, submitting the command buffer and waiting for it
+	bool CreateSampledImageFromCompressedTexture(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, CompressedTexture const &texture, bool linearFiltering,
+		VkQueue queue, VkCommandBuffer commandBuffer, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties, VkImage &sampledImage,
+		VkDeviceMemory &memoryObject, VkImageView &sampledImageView);
 	bool CreateStorageImage(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkImageType type, VkFormat format, VkExtent3D size, uint32_t numMipmaps, uint32_t numLayers,
 		VkImageUsageFlags usage, VkImageViewType viewType, VkImageAspectFlags aspect, bool atomicOperations, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties, 
 		VkImage &storageImage, VkDeviceMemory &memoryObject, VkImageView &storageImageView);
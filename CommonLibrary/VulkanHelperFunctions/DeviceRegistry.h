@@ -0,0 +1,57 @@
+#pragma once
+#include <mutex>
+#include "../CommonFiles/Common.h"
+
+namespace VulkanSampleFramework
+{
+	// Associates objects (e.g. trackers and pools owned by a sample) with logical devices, so helper functions use the ones of the device
+	// they were called with and several devices may be used in one process
+	template<typename Type>
+	class DeviceRegistry
+	{
+	public:
+		// Null object removes the association
+		void Set(VkDevice logicalDevice, Type *object)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it)
+			{
+				if (logicalDevice == it->first)
+				{
+					if (nullptr == object)
+					{
+						m_Entries.erase(it);
+					}
+					else
+					{
+						it->second = object;
+					}
+					return;
+				}
+			}
+
+			if (nullptr != object)
+			{
+				m_Entries.push_back({ logicalDevice, object });
+			}
+		}
+
+		Type * Get(VkDevice logicalDevice) const
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (auto &entry : m_Entries)
+			{
+				if (logicalDevice == entry.first)
+				{
+					return entry.second;
+				}
+			}
+			return nullptr;
+		}
+
+	private:
+		// Only a few devices are expected
+		std::vector<std::pair<VkDevice, Type *>>	m_Entries;
+		mutable std::mutex							m_Mutex;
+	};
+}
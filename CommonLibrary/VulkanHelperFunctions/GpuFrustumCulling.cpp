@@ -0,0 +1,266 @@
+#include "GpuFrustumCulling.h"
+#include "CommandRecordingAndDrawing.h"
+#include "DescriptorSetsFunctions.h"
+#include "GraphicsAndComputePipeFunctions.h"
+#include "ResourcesAndMemoryFunctions.h"
+
+namespace VulkanSampleFramework
+{
+	GpuFrustumCulling::GpuFrustumCulling() :
+		m_InstanceBuffer(VK_NULL_HANDLE),
+		m_InstanceMemory(VK_NULL_HANDLE),
+		m_DrawBuffer(VK_NULL_HANDLE),
+		m_DrawMemory(VK_NULL_HANDLE),
+		m_DescriptorSetLayout(VK_NULL_HANDLE),
+		m_DescriptorPool(VK_NULL_HANDLE),
+		m_DescriptorSet(VK_NULL_HANDLE),
+		m_PipelineLayout(VK_NULL_HANDLE),
+		m_Pipeline(VK_NULL_HANDLE),
+		m_MultiDrawIndirect(false),
+		m_MaxDrawIndirectCount(1),
+		m_MaxInstancesCount(0),
+		m_InstancesCount(0)
+	{
+	}
+
+	GpuFrustumCulling::~GpuFrustumCulling()
+	{
+	}
+
+	bool GpuFrustumCulling::Initialize(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties,
+		VkPhysicalDeviceFeatures const *enabledFeatures, std::vector<unsigned char> const &computeShaderCode, uint32_t maxInstancesCount)
+	{
+		VkPhysicalDeviceProperties deviceProperties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+
+		m_MultiDrawIndirect = (nullptr != enabledFeatures) && (VK_TRUE == enabledFeatures->multiDrawIndirect);
+		m_MaxDrawIndirectCount = m_MultiDrawIndirect ? deviceProperties.limits.maxDrawIndirectCount : 1;
+		m_MaxInstancesCount = maxInstancesCount;
+
+		// Buffers
+		VkDeviceSize instanceBufferSize = maxInstancesCount * sizeof(CullingInstanceData);
+		VkDeviceSize drawBufferSize = DrawCommandsOffset + maxInstancesCount * sizeof(VkDrawIndirectCommand);
+
+		if (!CreateBuffer(logicalDevice, instanceBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, m_InstanceBuffer))
+		{
+			return false;
+		}
+		if (!AllocateAndBindMemoryObjectToBuffer(logicalDevice, m_InstanceBuffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, physicalDeviceMemoryProperties, m_InstanceMemory))
+		{
+			return false;
+		}
+
+		if (!CreateBuffer(logicalDevice, drawBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			m_DrawBuffer))
+		{
+			return false;
+		}
+		if (!AllocateAndBindMemoryObjectToBuffer(logicalDevice, m_DrawBuffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, physicalDeviceMemoryProperties, m_DrawMemory))
+		{
+			return false;
+		}
+
+		// Descriptor set
+		std::vector<VkDescriptorSetLayoutBinding> bindings =
+		{
+			{
+				0,										// uint32_t             binding
+				VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,		// VkDescriptorType     descriptorType
+				1,										// uint32_t             descriptorCount
+				VK_SHADER_STAGE_COMPUTE_BIT,			// VkShaderStageFlags   stageFlags
+				nullptr									// const VkSampler    * pImmutableSamplers
+			},
+			{
+				1,										// uint32_t             binding
+				VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,		// VkDescriptorType     descriptorType
+				1,										// uint32_t             descriptorCount
+				VK_SHADER_STAGE_COMPUTE_BIT,			// VkShaderStageFlags   stageFlags
+				nullptr									// const VkSampler    * pImmutableSamplers
+			}
+		};
+		if (!CreateDescriptorSetLayout(logicalDevice, bindings, m_DescriptorSetLayout))
+		{
+			return false;
+		}
+
+		if (!CreateDescriptorPool(logicalDevice, false, 1, { { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 } }, m_DescriptorPool))
+		{
+			return false;
+		}
+
+		std::vector<VkDescriptorSet> descriptorSets;
+		if (!AllocateDescriptorSets(logicalDevice, m_DescriptorPool, { m_DescriptorSetLayout }, descriptorSets))
+		{
+			return false;
+		}
+		m_DescriptorSet = descriptorSets[0];
+
+		std::vector<BufferDescriptorInfo> bufferDescriptorInfos =
+		{
+			{
+				m_DescriptorSet,						// VkDescriptorSet                      m_TargetDescriptorSet
+				0,										// uint32_t                             m_TargetDescriptorBinding
+				0,										// uint32_t                             m_TargetArrayElement
+				VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,		// VkDescriptorType                     m_TargetDescriptorType
+				{
+					{
+						m_InstanceBuffer,				// VkBuffer                             buffer
+						0,								// VkDeviceSize                         offset
+						VK_WHOLE_SIZE					// VkDeviceSize                         range
+					}
+				}
+			},
+			{
+				m_DescriptorSet,						// VkDescriptorSet                      m_TargetDescriptorSet
+				1,										// uint32_t                             m_TargetDescriptorBinding
+				0,										// uint32_t                             m_TargetArrayElement
+				VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,		// VkDescriptorType                     m_TargetDescriptorType
+				{
+					{
+						m_DrawBuffer,					// VkBuffer                             buffer
+						0,								// VkDeviceSize                         offset
+						VK_WHOLE_SIZE					// VkDeviceSize                         range
+					}
+				}
+			}
+		};
+		UpdateDescriptorSets(logicalDevice, {}, bufferDescriptorInfos, {}, {});
+
+		// Pipeline
+		std::vector<VkPushConstantRange> pushConstantRanges =
+		{
+			{
+				VK_SHADER_STAGE_COMPUTE_BIT,			// VkShaderStageFlags     stageFlags
+				0,										// uint32_t               offset
+				sizeof(CullingParameters)				// uint32_t               size
+			}
+		};
+		if (!CreatePipelineLayout(logicalDevice, { m_DescriptorSetLayout }, pushConstantRanges, m_PipelineLayout))
+		{
+			return false;
+		}
+
+		VkShaderModule computeShaderModule;
+		if (!CreateShaderModule(logicalDevice, computeShaderCode, computeShaderModule))
+		{
+			return false;
+		}
+
+		std::vector<VkPipelineShaderStageCreateInfo> shaderStageCreateInfos;
+		SpecifyPipelineShaderStages({ { VK_SHADER_STAGE_COMPUTE_BIT, computeShaderModule, "main", nullptr } }, shaderStageCreateInfos);
+
+		VkComputePipelineCreateInfo computePipelineCreateInfo;
+		CreateComputePiplineInfo(0, shaderStageCreateInfos[0], m_PipelineLayout, VK_NULL_HANDLE, -1, computePipelineCreateInfo);
+
+		bool result = CreateComputePipeline(logicalDevice, { computePipelineCreateInfo }, VK_NULL_HANDLE, m_Pipeline);
+		DestroyShaderModule(logicalDevice, computeShaderModule);
+		return result;
+	}
+
+	void GpuFrustumCulling::Destroy(VkDevice logicalDevice)
+	{
+		DestroyPipeline(logicalDevice, m_Pipeline);
+		DestroyPipelineLayout(logicalDevice, m_PipelineLayout);
+		// Set is freed together with its pool
+		m_DescriptorSet = VK_NULL_HANDLE;
+		DestroyDescriptorPool(logicalDevice, m_DescriptorPool);
+		DestroyDescriptorSetLayout(logicalDevice, m_DescriptorSetLayout);
+		FreeMemoryObject(logicalDevice, m_DrawMemory);
+		DestroyBuffer(logicalDevice, m_DrawBuffer);
+		FreeMemoryObject(logicalDevice, m_InstanceMemory);
+		DestroyBuffer(logicalDevice, m_InstanceBuffer);
+		m_InstancesCount = 0;
+	}
+
+	bool GpuFrustumCulling::UpdateInstances(VkDevice logicalDevice, std::vector<CullingInstanceData> const &instances, VkQueue queue, VkCommandBuffer commandBuffer,
+		VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties)
+	{
+		if (instances.size() > m_MaxInstancesCount)
+		{
+			std::cout << "Could not update culling instances, their number exceeds the size of the instance buffer." << std::endl;
+			return false;
+		}
+
+		m_InstancesCount = static_cast<uint32_t>(instances.size());
+		if (0 == m_InstancesCount)
+		{
+			return true;
+		}
+
+		return UseStagingBufferToUpdateBufferWithDeviceLocalMemoryBound(logicalDevice, m_InstancesCount * sizeof(CullingInstanceData),
+			const_cast<CullingInstanceData *>(instances.data()), m_InstanceBuffer, 0, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+			queue, commandBuffer, {}, physicalDeviceMemoryProperties);
+	}
+
+	void GpuFrustumCulling::RecordCulling(VkCommandBuffer commandBuffer, Matrix4x4 const &viewProjectionMatrix)
+	{
+		// Commands from the previous frame may still be read by indirect draws
+		SetBufferMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			{ { m_DrawBuffer, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED } });
+
+		// Zeroes the counter and the instance count of all slots, so the ones not written by the shader are empty draws
+		FillBuffer(commandBuffer, m_DrawBuffer, 0, VK_WHOLE_SIZE, 0);
+
+		SetBufferMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			{ { m_DrawBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED } });
+
+		if (m_InstancesCount > 0)
+		{
+			CullingParameters parameters =
+			{
+				ExtractFrustumPlanes(viewProjectionMatrix),
+				m_InstancesCount
+			};
+
+			BindPipelineObject(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+			BindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, { m_DescriptorSet }, {});
+			ProvideDataToShadersThroughPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullingParameters), &parameters);
+			DispatchComputeWork(commandBuffer, (m_InstancesCount + WorkgroupSize - 1) / WorkgroupSize, 1, 1);
+		}
+
+		SetBufferMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+			{ { m_DrawBuffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED } });
+	}
+
+	void GpuFrustumCulling::DrawVisibleInstances(VkCommandBuffer commandBuffer)
+	{
+		if (0 == m_InstancesCount)
+		{
+			return;
+		}
+
+		// Function pointer is loaded only when the extension was enabled during logical device creation
+		if (m_MultiDrawIndirect && (nullptr != vkCmdDrawIndirectCountAMD))
+		{
+			vkCmdDrawIndirectCountAMD(commandBuffer, m_DrawBuffer, DrawCommandsOffset, m_DrawBuffer, 0, m_InstancesCount, sizeof(VkDrawIndirectCommand));
+			return;
+		}
+
+		uint32_t issuedDrawsCount = 0;
+		while (issuedDrawsCount < m_InstancesCount)
+		{
+			uint32_t drawCount = m_InstancesCount - issuedDrawsCount;
+			drawCount = drawCount > m_MaxDrawIndirectCount ? m_MaxDrawIndirectCount : drawCount;
+
+			DrawGeometryIndirect(commandBuffer, m_DrawBuffer, DrawCommandsOffset + issuedDrawsCount * sizeof(VkDrawIndirectCommand), drawCount,
+				sizeof(VkDrawIndirectCommand));
+			issuedDrawsCount += drawCount;
+		}
+	}
+
+	VkBuffer GpuFrustumCulling::GetInstanceBuffer() const
+	{
+		return m_InstanceBuffer;
+	}
+
+	VkBuffer GpuFrustumCulling::GetDrawBuffer() const
+	{
+		return m_DrawBuffer;
+	}
+
+	uint32_t GpuFrustumCulling::GetInstancesCount() const
+	{
+		return m_InstancesCount;
+	}
+}
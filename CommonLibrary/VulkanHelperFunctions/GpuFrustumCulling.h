@@ -0,0 +1,71 @@
+#pragma once
+#include "../CommonFiles/Common.h"
+#include "../CommonFiles/Tools.h"
+
+namespace VulkanSampleFramework
+{
+	// Layout matches InstanceData structure from FrustumCulling.comp (std430)
+	struct CullingInstanceData
+	{
+		Matrix4x4	m_Transform;
+		Vector4		m_BoundingSphere;	// Center in model space and radius
+		uint32_t	m_VertexCount;
+		uint32_t	m_FirstVertex;
+		uint32_t	m_Padding[2];
+	};
+
+	// Tests bounding spheres of all instances against view frustum in a compute shader and compacts the visible ones into
+	// an indirect draw buffer, so the CPU doesn't have to know which instances survived. Draw buffer starts with the number
+	// of written commands (padded to 16 bytes), followed by one VkDrawIndirectCommand per visible instance. First instance
+	// of each command is the index of the source instance, which requires the drawIndirectFirstInstance feature.
+	class GpuFrustumCulling
+	{
+	public:
+		// Shader code is the SPIR-V compiled from CommonLibrary/Shaders/FrustumCulling.comp
+		bool Initialize(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties,
+			VkPhysicalDeviceFeatures const *enabledFeatures, std::vector<unsigned char> const &computeShaderCode, uint32_t maxInstancesCount);
+		void Destroy(VkDevice logicalDevice);
+
+		// Uploads instances through a staging buffer, command buffer is recorded and submitted by this call
+		bool UpdateInstances(VkDevice logicalDevice, std::vector<CullingInstanceData> const &instances, VkQueue queue, VkCommandBuffer commandBuffer,
+			VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties);
+
+		// Must be recorded outside of a render pass, before the draws that consume its results
+		void RecordCulling(VkCommandBuffer commandBuffer, Matrix4x4 const &viewProjectionMatrix);
+		// Uses the count written by the GPU when VK_AMD_draw_indirect_count was enabled, otherwise all slots are processed and
+		// the ones without a visible instance are skipped through their zero instance count
+		void DrawVisibleInstances(VkCommandBuffer commandBuffer);
+
+		// Instance buffer may also be bound as a storage buffer in vertex shaders, to fetch transformations through gl_InstanceIndex
+		VkBuffer GetInstanceBuffer() const;
+		VkBuffer GetDrawBuffer() const;
+		uint32_t GetInstancesCount() const;
+
+		GpuFrustumCulling();
+		~GpuFrustumCulling();
+
+	private:
+		static VkDeviceSize const	DrawCommandsOffset = 16;
+		static uint32_t const		WorkgroupSize = 64;
+
+		struct CullingParameters
+		{
+			std::array<Vector4, 6>	m_FrustumPlanes;
+			uint32_t				m_InstancesCount;
+		};
+
+		VkBuffer				m_InstanceBuffer;
+		VkDeviceMemory			m_InstanceMemory;
+		VkBuffer				m_DrawBuffer;
+		VkDeviceMemory			m_DrawMemory;
+		VkDescriptorSetLayout	m_DescriptorSetLayout;
+		VkDescriptorPool		m_DescriptorPool;
+		VkDescriptorSet			m_DescriptorSet;
+		VkPipelineLayout		m_PipelineLayout;
+		VkPipeline				m_Pipeline;
+		bool					m_MultiDrawIndirect;
+		uint32_t				m_MaxDrawIndirectCount;
+		uint32_t				m_MaxInstancesCount;
+		uint32_t				m_InstancesCount;
+	};
+}
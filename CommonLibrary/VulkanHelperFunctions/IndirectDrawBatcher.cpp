@@ -0,0 +1,178 @@
+#include "IndirectDrawBatcher.h"
+#include "CommandRecordingAndDrawing.h"
+#include "ResourcesAndMemoryFunctions.h"
+
+namespace VulkanSampleFramework
+{
+	IndirectDrawBatcher::IndirectDrawBatcher() :
+		m_Buffer(VK_NULL_HANDLE),
+		m_Memory(VK_NULL_HANDLE),
+		m_MappedData(nullptr),
+		m_MultiDrawIndirect(false),
+		m_MaxDrawIndirectCount(1),
+		m_MaxDrawsPerFrame(0),
+		m_FrameRegionSize(0),
+		m_FrameIndex(0),
+		m_DrawsCount(0),
+		m_FlushedDrawsCount(0),
+		m_IndexedDrawsCount(0),
+		m_FlushedIndexedDrawsCount(0),
+		m_IssuedDrawCallsCount(0)
+	{
+	}
+
+	IndirectDrawBatcher::~IndirectDrawBatcher()
+	{
+	}
+
+	bool IndirectDrawBatcher::Initialize(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties,
+		VkPhysicalDeviceFeatures const *enabledFeatures, uint32_t maxDrawsPerFrame, uint32_t framesCount)
+	{
+		VkPhysicalDeviceProperties deviceProperties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+
+		m_MultiDrawIndirect = (nullptr != enabledFeatures) && (VK_TRUE == enabledFeatures->multiDrawIndirect);
+		m_MaxDrawIndirectCount = m_MultiDrawIndirect ? deviceProperties.limits.maxDrawIndirectCount : 1;
+		m_MaxDrawsPerFrame = maxDrawsPerFrame;
+
+		// Non-indexed commands are followed by indexed ones inside every frame region
+		m_FrameRegionSize = maxDrawsPerFrame * (sizeof(VkDrawIndirectCommand) + sizeof(VkDrawIndexedIndirectCommand));
+
+		if (!CreateBuffer(logicalDevice, m_FrameRegionSize * framesCount, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, m_Buffer))
+		{
+			return false;
+		}
+
+		// Coherent memory, so commands written by the CPU don't have to be flushed explicitly
+		if (!AllocateAndBindMemoryObjectToBuffer(logicalDevice, m_Buffer,
+			static_cast<VkMemoryPropertyFlagBits>(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT), physicalDeviceMemoryProperties, m_Memory))
+		{
+			return false;
+		}
+
+		void *mappedData;
+		VkResult result = vkMapMemory(logicalDevice, m_Memory, 0, VK_WHOLE_SIZE, 0, &mappedData);
+		if (VK_SUCCESS != result)
+		{
+			std::cout << "Could not map memory of an indirect draw buffer." << std::endl;
+			return false;
+		}
+		m_MappedData = static_cast<unsigned char *>(mappedData);
+
+		return true;
+	}
+
+	void IndirectDrawBatcher::Destroy(VkDevice logicalDevice)
+	{
+		if (nullptr != m_MappedData)
+		{
+			vkUnmapMemory(logicalDevice, m_Memory);
+			m_MappedData = nullptr;
+		}
+		FreeMemoryObject(logicalDevice, m_Memory);
+		DestroyBuffer(logicalDevice, m_Buffer);
+	}
+
+	void IndirectDrawBatcher::Reset(uint32_t frameIndex)
+	{
+		m_FrameIndex = frameIndex;
+		m_DrawsCount = 0;
+		m_FlushedDrawsCount = 0;
+		m_IndexedDrawsCount = 0;
+		m_FlushedIndexedDrawsCount = 0;
+		m_IssuedDrawCallsCount = 0;
+	}
+
+	bool IndirectDrawBatcher::AddDraw(VkDrawIndirectCommand const &drawCommand)
+	{
+		if (m_DrawsCount >= m_MaxDrawsPerFrame)
+		{
+			std::cout << "Indirect draw buffer is full." << std::endl;
+			return false;
+		}
+
+		std::memcpy(m_MappedData + GetDrawsOffset() + m_DrawsCount * sizeof(VkDrawIndirectCommand), &drawCommand, sizeof(VkDrawIndirectCommand));
+		++m_DrawsCount;
+		return true;
+	}
+
+	bool IndirectDrawBatcher::AddIndexedDraw(VkDrawIndexedIndirectCommand const &drawCommand)
+	{
+		if (m_IndexedDrawsCount >= m_MaxDrawsPerFrame)
+		{
+			std::cout << "Indirect draw buffer is full." << std::endl;
+			return false;
+		}
+
+		std::memcpy(m_MappedData + GetIndexedDrawsOffset() + m_IndexedDrawsCount * sizeof(VkDrawIndexedIndirectCommand), &drawCommand,
+			sizeof(VkDrawIndexedIndirectCommand));
+		++m_IndexedDrawsCount;
+		return true;
+	}
+
+	bool IndirectDrawBatcher::AddMeshParts(Mesh const &mesh, uint32_t instanceCount, uint32_t firstInstance)
+	{
+		for (auto & part : mesh.m_Parts)
+		{
+			VkDrawIndirectCommand drawCommand =
+			{
+				part.m_VertexCount,		// uint32_t    vertexCount
+				instanceCount,			// uint32_t    instanceCount
+				part.m_VertexOffset,	// uint32_t    firstVertex
+				firstInstance			// uint32_t    firstInstance
+			};
+
+			if (!AddDraw(drawCommand))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void IndirectDrawBatcher::Flush(VkCommandBuffer commandBuffer)
+	{
+		// Without multiDrawIndirect the draw count is limited to 1, so the commands are still read from the buffer but one call at a time
+		while (m_FlushedDrawsCount < m_DrawsCount)
+		{
+			uint32_t drawCount = m_DrawsCount - m_FlushedDrawsCount;
+			drawCount = drawCount > m_MaxDrawIndirectCount ? m_MaxDrawIndirectCount : drawCount;
+
+			DrawGeometryIndirect(commandBuffer, m_Buffer, GetDrawsOffset() + m_FlushedDrawsCount * sizeof(VkDrawIndirectCommand), drawCount,
+				sizeof(VkDrawIndirectCommand));
+			m_FlushedDrawsCount += drawCount;
+			++m_IssuedDrawCallsCount;
+		}
+
+		while (m_FlushedIndexedDrawsCount < m_IndexedDrawsCount)
+		{
+			uint32_t drawCount = m_IndexedDrawsCount - m_FlushedIndexedDrawsCount;
+			drawCount = drawCount > m_MaxDrawIndirectCount ? m_MaxDrawIndirectCount : drawCount;
+
+			DrawIndexedGeometryIndirect(commandBuffer, m_Buffer, GetIndexedDrawsOffset() + m_FlushedIndexedDrawsCount * sizeof(VkDrawIndexedIndirectCommand), drawCount,
+				sizeof(VkDrawIndexedIndirectCommand));
+			m_FlushedIndexedDrawsCount += drawCount;
+			++m_IssuedDrawCallsCount;
+		}
+	}
+
+	VkBuffer IndirectDrawBatcher::GetBuffer() const
+	{
+		return m_Buffer;
+	}
+
+	uint32_t IndirectDrawBatcher::GetIssuedDrawCallsCount() const
+	{
+		return m_IssuedDrawCallsCount;
+	}
+
+	VkDeviceSize IndirectDrawBatcher::GetDrawsOffset() const
+	{
+		return m_FrameIndex * m_FrameRegionSize;
+	}
+
+	VkDeviceSize IndirectDrawBatcher::GetIndexedDrawsOffset() const
+	{
+		return GetDrawsOffset() + m_MaxDrawsPerFrame * sizeof(VkDrawIndirectCommand);
+	}
+}
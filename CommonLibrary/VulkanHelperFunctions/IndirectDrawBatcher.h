@@ -0,0 +1,51 @@
+#pragma once
+#include "../CommonFiles/Common.h"
+#include "../CommonFiles/Tools.h"
+
+namespace VulkanSampleFramework
+{
+	// Packs draws sharing the same pipeline and descriptor state into a host visible indirect buffer, so they are issued with a single
+	// vkCmdDrawIndirect/vkCmdDrawIndexedIndirect call. Buffer is split into one region per frame in flight.
+	class IndirectDrawBatcher
+	{
+	public:
+		// Enabled features are the ones passed during logical device creation, drawing falls back to one indirect call per draw
+		// when multiDrawIndirect wasn't enabled
+		bool Initialize(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties,
+			VkPhysicalDeviceFeatures const *enabledFeatures, uint32_t maxDrawsPerFrame, uint32_t framesCount);
+		void Destroy(VkDevice logicalDevice);
+
+		// Region of the given frame may only be reused after commands that read from it have finished
+		void Reset(uint32_t frameIndex);
+		bool AddDraw(VkDrawIndirectCommand const &drawCommand);
+		bool AddIndexedDraw(VkDrawIndexedIndirectCommand const &drawCommand);
+		bool AddMeshParts(Mesh const &mesh, uint32_t instanceCount, uint32_t firstInstance);
+
+		// Issues all draws added since the previous flush, call it before pipeline or descriptor state changes
+		void Flush(VkCommandBuffer commandBuffer);
+
+		VkBuffer GetBuffer() const;
+		uint32_t GetIssuedDrawCallsCount() const;
+
+		IndirectDrawBatcher();
+		~IndirectDrawBatcher();
+
+	private:
+		VkDeviceSize GetDrawsOffset() const;
+		VkDeviceSize GetIndexedDrawsOffset() const;
+
+		VkBuffer			m_Buffer;
+		VkDeviceMemory		m_Memory;
+		unsigned char		*m_MappedData;
+		bool				m_MultiDrawIndirect;
+		uint32_t			m_MaxDrawIndirectCount;
+		uint32_t			m_MaxDrawsPerFrame;
+		VkDeviceSize		m_FrameRegionSize;
+		uint32_t			m_FrameIndex;
+		uint32_t			m_DrawsCount;
+		uint32_t			m_FlushedDrawsCount;
+		uint32_t			m_IndexedDrawsCount;
+		uint32_t			m_FlushedIndexedDrawsCount;
+		uint32_t			m_IssuedDrawCallsCount;
+	};
+}
@@ -253,7 +253,7 @@ namespace VulkanSampleFramework
 	}
 
 	bool CreateLogicalDevice(VkPhysicalDevice physicalDevice, std::vector<QueueInfo> queueInfos, std::vector<char const *> const &desiredExtennsions,
-		VkPhysicalDeviceFeatures *desiredFeatures, VkDevice &logicalDeevice)
+		VkPhysicalDeviceFeatures *desiredFeatures, VkDevice &logicalDeevice, void const *next)
 	{
 		std::vector<VkExtensionProperties> availableExtensions;
 		if (!CheckAvailableDeviceExtensions(physicalDevice, availableExtensions))
@@ -290,7 +290,7 @@ namespace VulkanSampleFramework
 		VkDeviceCreateInfo deviceCreateInfo =
 		{
 			VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,               // VkStructureType                  sType
-			nullptr,                                            // const void						*pNext
+			next,                                               // const void						*pNext
 			0,                                                  // VkDeviceCreateFlags              flags
 			static_cast<uint32_t>(queueCreateInfos.size()),		// uint32_t                         queueCreateInfoCount
 			queueCreateInfos.data(),							// const VkDeviceQueueCreateInfo	*pQueueCreateInfos
@@ -23,7 +23,7 @@ namespace VulkanSampleFramework
 	bool SelectIndexOfQueueFamilyWithDesiredCapabilities(VkPhysicalDevice physicalDevice, VkQueueFlags desiredCapabilities,
 		std::vector<VkQueueFamilyProperties> &queueFamiliesProperties, uint32_t &queueFamilyIndex);
 	bool CreateLogicalDevice(VkPhysicalDevice physicalDevice, std::vector<QueueInfo> queueInfos, std::vector<char const *> const &desiredExtennsions,
-		VkPhysicalDeviceFeatures *desiredFeatures, VkDevice &logicalDeevice);
+		VkPhysicalDeviceFeatures *desiredFeatures, VkDevice &logicalDeevice, void const *next = nullptr);
 	bool LoadDeviceLevelFunctions(VkDevice logicalDevice, std::vector<char const *> const &enabledExtensions);
 	void GetDeviceQueue(VkDevice logicalDevice, uint32_t queueFamilyIndex, uint32_t queueIndex, VkQueue &queue);
 	void DestroyLogicalDevice(VkDevice &logicalDevice);
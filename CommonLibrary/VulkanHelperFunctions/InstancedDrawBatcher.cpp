@@ -0,0 +1,201 @@
+#include "InstancedDrawBatcher.h"
+#include "CommandRecordingAndDrawing.h"
+#include "ResourcesAndMemoryFunctions.h"
+
+namespace VulkanSampleFramework
+{
+	void SpecifyInstanceAttributesInputState(uint32_t binding, uint32_t firstLocation, std::vector<VkVertexInputBindingDescription> &bindingDescriptions,
+		std::vector<VkVertexInputAttributeDescription> &attributeDescriptions)
+	{
+		bindingDescriptions.push_back(
+		{
+			binding,								// uint32_t                     binding
+			sizeof(InstanceAttributes),				// uint32_t                     stride
+			VK_VERTEX_INPUT_RATE_INSTANCE			// VkVertexInputRate            inputRate
+		});
+
+		for (uint32_t column = 0; column < 4; ++column)
+		{
+			attributeDescriptions.push_back(
+			{
+				firstLocation + column,							// uint32_t     location
+				binding,										// uint32_t     binding
+				VK_FORMAT_R32G32B32A32_SFLOAT,					// VkFormat     format
+				column * 4 * static_cast<uint32_t>(sizeof(float))	// uint32_t     offset
+			});
+		}
+
+		attributeDescriptions.push_back(
+		{
+			firstLocation + 4,														// uint32_t     location
+			binding,																// uint32_t     binding
+			VK_FORMAT_R32_UINT,														// VkFormat     format
+			static_cast<uint32_t>(offsetof(InstanceAttributes, m_MaterialId))		// uint32_t     offset
+		});
+	}
+
+	bool InstancedDrawBatcher::GroupKey::operator == (GroupKey const &other) const
+	{
+		return (m_VertexBuffer == other.m_VertexBuffer) && (m_FirstVertex == other.m_FirstVertex) && (m_VertexCount == other.m_VertexCount);
+	}
+
+	size_t InstancedDrawBatcher::GroupKeyHash::operator () (GroupKey const &key) const
+	{
+		size_t hash = std::hash<VkBuffer>()(key.m_VertexBuffer);
+		hash ^= std::hash<uint64_t>()((static_cast<uint64_t>(key.m_FirstVertex) << 32) | key.m_VertexCount) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		return hash;
+	}
+
+	InstancedDrawBatcher::InstancedDrawBatcher() :
+		m_Buffer(VK_NULL_HANDLE),
+		m_Memory(VK_NULL_HANDLE),
+		m_MappedData(nullptr),
+		m_MaxInstancesPerFrame(0),
+		m_FrameIndex(0),
+		m_InstancesCount(0),
+		m_WrittenInstancesCount(0),
+		m_IssuedDrawCallsCount(0)
+	{
+	}
+
+	InstancedDrawBatcher::~InstancedDrawBatcher()
+	{
+	}
+
+	bool InstancedDrawBatcher::Initialize(VkDevice logicalDevice, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties, uint32_t maxInstancesPerFrame,
+		uint32_t framesCount)
+	{
+		m_MaxInstancesPerFrame = maxInstancesPerFrame;
+
+		if (!CreateBuffer(logicalDevice, maxInstancesPerFrame * framesCount * sizeof(InstanceAttributes), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_Buffer))
+		{
+			return false;
+		}
+
+		// Coherent memory, so instance data written by the CPU doesn't have to be flushed explicitly
+		if (!AllocateAndBindMemoryObjectToBuffer(logicalDevice, m_Buffer,
+			static_cast<VkMemoryPropertyFlagBits>(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT), physicalDeviceMemoryProperties, m_Memory))
+		{
+			return false;
+		}
+
+		void *mappedData;
+		VkResult result = vkMapMemory(logicalDevice, m_Memory, 0, VK_WHOLE_SIZE, 0, &mappedData);
+		if (VK_SUCCESS != result)
+		{
+			std::cout << "Could not map memory of an instance data buffer." << std::endl;
+			return false;
+		}
+		m_MappedData = static_cast<unsigned char *>(mappedData);
+
+		return true;
+	}
+
+	void InstancedDrawBatcher::Destroy(VkDevice logicalDevice)
+	{
+		if (nullptr != m_MappedData)
+		{
+			vkUnmapMemory(logicalDevice, m_Memory);
+			m_MappedData = nullptr;
+		}
+		FreeMemoryObject(logicalDevice, m_Memory);
+		DestroyBuffer(logicalDevice, m_Buffer);
+		m_Groups.clear();
+		m_GroupIndices.clear();
+	}
+
+	void InstancedDrawBatcher::Reset(uint32_t frameIndex)
+	{
+		m_FrameIndex = frameIndex;
+		m_InstancesCount = 0;
+		m_WrittenInstancesCount = 0;
+		m_IssuedDrawCallsCount = 0;
+
+		// Groups are kept, so their storage is reused when the same parts are drawn in the next frames
+		for (auto & group : m_Groups)
+		{
+			group.m_Instances.clear();
+		}
+	}
+
+	bool InstancedDrawBatcher::AddInstance(VkBuffer vertexBuffer, Mesh const &mesh, uint32_t partIndex, InstanceAttributes const &attributes)
+	{
+		if (partIndex >= mesh.m_Parts.size())
+		{
+			std::cout << "Could not add instance, mesh doesn't contain part number " << partIndex << "." << std::endl;
+			return false;
+		}
+		return AddInstance(vertexBuffer, mesh.m_Parts[partIndex].m_VertexOffset, mesh.m_Parts[partIndex].m_VertexCount, attributes);
+	}
+
+	bool InstancedDrawBatcher::AddInstance(VkBuffer vertexBuffer, uint32_t firstVertex, uint32_t vertexCount, InstanceAttributes const &attributes)
+	{
+		if (m_WrittenInstancesCount + m_InstancesCount >= m_MaxInstancesPerFrame)
+		{
+			std::cout << "Could not add instance, instance data buffer is full." << std::endl;
+			return false;
+		}
+
+		// The same vertex range of different buffers contains different geometry
+		GroupKey key = { vertexBuffer, firstVertex, vertexCount };
+		auto groupIndex = m_GroupIndices.find(key);
+		if (m_GroupIndices.end() == groupIndex)
+		{
+			groupIndex = m_GroupIndices.insert({ key, m_Groups.size() }).first;
+			m_Groups.push_back({ vertexBuffer, firstVertex, vertexCount, {} });
+		}
+
+		m_Groups[groupIndex->second].m_Instances.push_back(attributes);
+		++m_InstancesCount;
+		return true;
+	}
+
+	void InstancedDrawBatcher::Draw(VkCommandBuffer commandBuffer, uint32_t vertexBinding, uint32_t instanceBinding)
+	{
+		if (0 == m_InstancesCount)
+		{
+			return;
+		}
+
+		VkDeviceSize regionOffset = m_FrameIndex * m_MaxInstancesPerFrame * sizeof(InstanceAttributes);
+		BindVertexBuffers(commandBuffer, instanceBinding, { { m_Buffer, regionOffset } });
+
+		// Instances of each group are stored contiguously, so a group is addressed through the first instance of its draw
+		InstanceAttributes *instanceData = reinterpret_cast<InstanceAttributes *>(m_MappedData + regionOffset);
+		uint32_t firstInstance = m_WrittenInstancesCount;
+		VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+		for (auto & group : m_Groups)
+		{
+			uint32_t instanceCount = static_cast<uint32_t>(group.m_Instances.size());
+			if (0 == instanceCount)
+			{
+				continue;
+			}
+
+			if (boundVertexBuffer != group.m_VertexBuffer)
+			{
+				BindVertexBuffers(commandBuffer, vertexBinding, { { group.m_VertexBuffer, 0 } });
+				boundVertexBuffer = group.m_VertexBuffer;
+			}
+
+			std::memcpy(instanceData + firstInstance, group.m_Instances.data(), instanceCount * sizeof(InstanceAttributes));
+			DrawGeometry(commandBuffer, group.m_VertexCount, instanceCount, group.m_FirstVertex, firstInstance);
+			firstInstance += instanceCount;
+			++m_IssuedDrawCallsCount;
+
+			group.m_Instances.clear();
+		}
+		m_WrittenInstancesCount = firstInstance;
+		m_InstancesCount = 0;
+	}
+
+	uint32_t InstancedDrawBatcher::GetInstancesCount() const
+	{
+		return m_InstancesCount;
+	}
+
+	uint32_t InstancedDrawBatcher::GetIssuedDrawCallsCount() const
+	{
+		return m_IssuedDrawCallsCount;
+	}
+}
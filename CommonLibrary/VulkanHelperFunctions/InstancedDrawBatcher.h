@@ -0,0 +1,78 @@
+#pragma once
+#include <unordered_map>
+#include "../CommonFiles/Common.h"
+#include "../CommonFiles/Tools.h"
+
+namespace VulkanSampleFramework
+{
+	// Contents of the per-instance vertex stream
+	struct InstanceAttributes
+	{
+		Matrix4x4	m_Transform;
+		uint32_t	m_MaterialId;
+	};
+
+	// Appends binding with VK_VERTEX_INPUT_RATE_INSTANCE and attributes of the InstanceAttributes structure: transform occupies four
+	// consecutive locations starting at firstLocation (one per column), material ID is read from the location that follows them
+	void SpecifyInstanceAttributesInputState(uint32_t binding, uint32_t firstLocation, std::vector<VkVertexInputBindingDescription> &bindingDescriptions,
+		std::vector<VkVertexInputAttributeDescription> &attributeDescriptions);
+
+	// Groups instances of the same mesh part of the same vertex buffer into a single instanced draw. Instance data is written into a persistently mapped,
+	// host visible ring with one region per frame in flight, so the CPU can fill the next frame while previous ones are rendered.
+	class InstancedDrawBatcher
+	{
+	public:
+		bool Initialize(VkDevice logicalDevice, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties, uint32_t maxInstancesPerFrame,
+			uint32_t framesCount);
+		void Destroy(VkDevice logicalDevice);
+
+		// Region of the given frame may only be reused after commands that read from it have finished
+		void Reset(uint32_t frameIndex);
+		bool AddInstance(VkBuffer vertexBuffer, Mesh const &mesh, uint32_t partIndex, InstanceAttributes const &attributes);
+		bool AddInstance(VkBuffer vertexBuffer, uint32_t firstVertex, uint32_t vertexCount, InstanceAttributes const &attributes);
+
+		// Copies instances added since the previous draw into the frame region, binds it as the given instance binding
+		// and issues one draw per mesh part. Vertex buffer of each part is bound (at offset 0) to the given vertex binding.
+		void Draw(VkCommandBuffer commandBuffer, uint32_t vertexBinding, uint32_t instanceBinding);
+
+		uint32_t GetInstancesCount() const;
+		uint32_t GetIssuedDrawCallsCount() const;
+
+		InstancedDrawBatcher();
+		~InstancedDrawBatcher();
+
+	private:
+		struct GroupKey
+		{
+			VkBuffer	m_VertexBuffer;
+			uint32_t	m_FirstVertex;
+			uint32_t	m_VertexCount;
+
+			bool operator == (GroupKey const &other) const;
+		};
+
+		struct GroupKeyHash
+		{
+			size_t operator () (GroupKey const &key) const;
+		};
+
+		struct Group
+		{
+			VkBuffer						m_VertexBuffer;
+			uint32_t						m_FirstVertex;
+			uint32_t						m_VertexCount;
+			std::vector<InstanceAttributes>	m_Instances;
+		};
+
+		VkBuffer							m_Buffer;
+		VkDeviceMemory						m_Memory;
+		unsigned char						*m_MappedData;
+		uint32_t							m_MaxInstancesPerFrame;
+		uint32_t							m_FrameIndex;
+		uint32_t							m_InstancesCount;
+		uint32_t							m_WrittenInstancesCount;
+		uint32_t							m_IssuedDrawCallsCount;
+		std::vector<Group>					m_Groups;
+		std::unordered_map<GroupKey, size_t, GroupKeyHash>	m_GroupIndices;
+	};
+}
@@ -0,0 +1,202 @@
+#include "MemoryBudget.h"
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		DeviceRegistry<MemoryBudgetTracker> MemoryBudgetTrackers;
+	}
+
+	MemoryBudgetTracker::MemoryBudgetTracker() :
+		m_PhysicalDevice(VK_NULL_HANDLE),
+		m_MemoryProperties(),
+		m_MemoryBudgetExtensionEnabled(false),
+		m_HeapUsages(),
+		m_MemoryTypeUsages(),
+		m_HeapUntrackedUsages(),
+		m_HeapBudgets(),
+		m_NextCallbackId(0)
+	{
+	}
+
+	void MemoryBudgetTracker::Initialize(VkPhysicalDevice physicalDevice, bool memoryBudgetExtensionEnabled)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_PhysicalDevice = physicalDevice;
+			m_MemoryBudgetExtensionEnabled = memoryBudgetExtensionEnabled;
+			vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_MemoryProperties);
+		}
+		UpdateBudgets();
+	}
+
+	void MemoryBudgetTracker::UpdateBudgets()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// Function pointer is loaded only when VK_KHR_get_physical_device_properties2 was enabled during instance creation
+		if (m_MemoryBudgetExtensionEnabled && (nullptr != vkGetPhysicalDeviceMemoryProperties2KHR))
+		{
+			VkPhysicalDeviceMemoryBudgetPropertiesEXT memoryBudgetProperties = {};
+			memoryBudgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+			VkPhysicalDeviceMemoryProperties2KHR memoryProperties = {};
+			memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2_KHR;
+			memoryProperties.pNext = &memoryBudgetProperties;
+			vkGetPhysicalDeviceMemoryProperties2KHR(m_PhysicalDevice, &memoryProperties);
+
+			// Driver reports usage of the whole process, including allocations not made through the tracker
+			for (uint32_t i = 0; i < m_MemoryProperties.memoryHeapCount; ++i)
+			{
+				m_HeapBudgets[i] = memoryBudgetProperties.heapBudget[i];
+				m_HeapUntrackedUsages[i] = memoryBudgetProperties.heapUsage[i] > m_HeapUsages[i] ? memoryBudgetProperties.heapUsage[i] - m_HeapUsages[i] : 0;
+			}
+			return;
+		}
+
+		for (uint32_t i = 0; i < m_MemoryProperties.memoryHeapCount; ++i)
+		{
+			m_HeapBudgets[i] = m_MemoryProperties.memoryHeaps[i].size;
+			m_HeapUntrackedUsages[i] = 0;
+		}
+	}
+
+	uint32_t MemoryBudgetTracker::RegisterEvictionCallback(EvictionCallback const &callback)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_EvictionCallbacks.push_back(std::make_pair(m_NextCallbackId, callback));
+		return m_NextCallbackId++;
+	}
+
+	void MemoryBudgetTracker::UnregisterEvictionCallback(uint32_t callbackId)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (auto callback = m_EvictionCallbacks.begin(); callback != m_EvictionCallbacks.end(); ++callback)
+		{
+			if (callbackId == callback->first)
+			{
+				m_EvictionCallbacks.erase(callback);
+				return;
+			}
+		}
+	}
+
+	bool MemoryBudgetTracker::ReserveAllocation(uint32_t memoryType, VkDeviceSize size)
+	{
+		uint32_t heapIndex = m_MemoryProperties.memoryTypes[memoryType].heapIndex;
+
+		VkDeviceSize previousUsage = 0;
+		for (uint32_t round = 0; ; ++round)
+		{
+			VkDeviceSize requiredSize;
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				VkDeviceSize usage = m_HeapUsages[heapIndex] + m_HeapUntrackedUsages[heapIndex];
+				if (usage + size <= m_HeapBudgets[heapIndex])
+				{
+					return true;
+				}
+
+				// Usage is read again after each round, as callbacks may report memory which is released only frames later
+				if ((MaxEvictionRounds == round) || ((round > 0) && (usage >= previousUsage)))
+				{
+					return false;
+				}
+				previousUsage = usage;
+				requiredSize = usage + size - m_HeapBudgets[heapIndex];
+			}
+
+			// Callbacks free memory through FreeMemoryObject(), so they are called without the lock
+			if (0 == FireEvictionCallbacks(heapIndex, requiredSize))
+			{
+				return false;
+			}
+		}
+	}
+
+	bool MemoryBudgetTracker::EvictAfterFailedAllocation(uint32_t memoryType, VkDeviceSize size)
+	{
+		return FireEvictionCallbacks(m_MemoryProperties.memoryTypes[memoryType].heapIndex, size) > 0;
+	}
+
+	void MemoryBudgetTracker::RecordAllocation(VkDeviceMemory memoryObject, uint32_t memoryType, VkDeviceSize size)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Allocations[memoryObject] = { memoryType, size };
+		m_MemoryTypeUsages[memoryType] += size;
+		m_HeapUsages[m_MemoryProperties.memoryTypes[memoryType].heapIndex] += size;
+	}
+
+	void MemoryBudgetTracker::RecordFree(VkDeviceMemory memoryObject)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto allocation = m_Allocations.find(memoryObject);
+		if (m_Allocations.end() == allocation)
+		{
+			return;
+		}
+
+		m_MemoryTypeUsages[allocation->second.m_MemoryType] -= allocation->second.m_Size;
+		m_HeapUsages[m_MemoryProperties.memoryTypes[allocation->second.m_MemoryType].heapIndex] -= allocation->second.m_Size;
+		m_Allocations.erase(allocation);
+	}
+
+	uint32_t MemoryBudgetTracker::GetHeapsCount() const
+	{
+		return m_MemoryProperties.memoryHeapCount;
+	}
+
+	VkDeviceSize MemoryBudgetTracker::GetHeapUsage(uint32_t heapIndex) const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_HeapUsages[heapIndex];
+	}
+
+	VkDeviceSize MemoryBudgetTracker::GetMemoryTypeUsage(uint32_t memoryType) const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_MemoryTypeUsages[memoryType];
+	}
+
+	VkDeviceSize MemoryBudgetTracker::GetHeapProcessUsage(uint32_t heapIndex) const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_HeapUsages[heapIndex] + m_HeapUntrackedUsages[heapIndex];
+	}
+
+	VkDeviceSize MemoryBudgetTracker::GetHeapBudget(uint32_t heapIndex) const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_HeapBudgets[heapIndex];
+	}
+
+	VkDeviceSize MemoryBudgetTracker::FireEvictionCallbacks(uint32_t heapIndex, VkDeviceSize requiredSize)
+	{
+		std::vector<std::pair<uint32_t, EvictionCallback>> evictionCallbacks;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			evictionCallbacks = m_EvictionCallbacks;
+		}
+
+		VkDeviceSize freedSize = 0;
+		for (auto &callback : evictionCallbacks)
+		{
+			freedSize += callback.second(heapIndex, requiredSize - freedSize);
+			if (freedSize >= requiredSize)
+			{
+				break;
+			}
+		}
+		return freedSize;
+	}
+
+	void SetMemoryBudgetTracker(VkDevice logicalDevice, MemoryBudgetTracker *tracker)
+	{
+		MemoryBudgetTrackers.Set(logicalDevice, tracker);
+	}
+
+	MemoryBudgetTracker * GetMemoryBudgetTracker(VkDevice logicalDevice)
+	{
+		return MemoryBudgetTrackers.Get(logicalDevice);
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <mutex>
+#include <unordered_map>
+#include "../CommonFiles/Common.h"
+#include "DeviceRegistry.h"
+
+namespace VulkanSampleFramework
+{
+	// Called before an allocation from the given heap would exceed its budget (or after it failed), should free memory
+	// (e.g. evict cached resources) and return the number of freed bytes. Memory which is released only later, e.g. after
+	// frames in flight finish, is not freed yet.
+	using EvictionCallback = std::function<VkDeviceSize(uint32_t heapIndex, VkDeviceSize requiredSize)>;
+
+	// Accounts all memory objects allocated and freed through AllocateMemoryObject() and FreeMemoryObject(), per heap and memory type.
+	// Budgets come from VK_EXT_memory_budget when the extension was enabled on the device (together with VK_KHR_get_physical_device_properties2
+	// on the instance), otherwise from heap sizes. Budgets may change at runtime, so they should be updated e.g. once per frame.
+	class MemoryBudgetTracker
+	{
+	public:
+		// Memory freed by callbacks may be released only after frames in flight finish (e.g. through DestroyWhenUnused()),
+		// so callbacks are fired a limited number of times per allocation
+		static uint32_t const	MaxEvictionRounds = 4;
+
+		void Initialize(VkPhysicalDevice physicalDevice, bool memoryBudgetExtensionEnabled);
+		void UpdateBudgets();
+
+		uint32_t RegisterEvictionCallback(EvictionCallback const &callback);
+		void UnregisterEvictionCallback(uint32_t callbackId);
+
+		// Fires eviction callbacks while the allocation would exceed the budget of its heap and the usage drops after each round,
+		// returns false when it still would. AllocateMemoryObject() treats the result as advisory and allocates anyway.
+		bool ReserveAllocation(uint32_t memoryType, VkDeviceSize size);
+		// Fires eviction callbacks after an allocation failed, returns whether any memory was freed
+		bool EvictAfterFailedAllocation(uint32_t memoryType, VkDeviceSize size);
+		void RecordAllocation(VkDeviceMemory memoryObject, uint32_t memoryType, VkDeviceSize size);
+		void RecordFree(VkDeviceMemory memoryObject);
+
+		uint32_t GetHeapsCount() const;
+		// Memory allocated by this tracker
+		VkDeviceSize GetHeapUsage(uint32_t heapIndex) const;
+		VkDeviceSize GetMemoryTypeUsage(uint32_t memoryType) const;
+		// Usage of the whole process as reported by the driver, equal to the tracked usage without the extension
+		VkDeviceSize GetHeapProcessUsage(uint32_t heapIndex) const;
+		VkDeviceSize GetHeapBudget(uint32_t heapIndex) const;
+
+		MemoryBudgetTracker();
+
+	private:
+		struct Allocation
+		{
+			uint32_t		m_MemoryType;
+			VkDeviceSize	m_Size;
+		};
+
+		VkDeviceSize FireEvictionCallbacks(uint32_t heapIndex, VkDeviceSize requiredSize);
+
+		VkPhysicalDevice									m_PhysicalDevice;
+		VkPhysicalDeviceMemoryProperties					m_MemoryProperties;
+		bool												m_MemoryBudgetExtensionEnabled;
+		std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS>		m_HeapUsages;
+		std::array<VkDeviceSize, VK_MAX_MEMORY_TYPES>		m_MemoryTypeUsages;
+		std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS>		m_HeapUntrackedUsages;	// Process usage reported by the driver minus tracked usage
+		std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS>		m_HeapBudgets;
+		std::unordered_map<VkDeviceMemory, Allocation>		m_Allocations;
+		std::vector<std::pair<uint32_t, EvictionCallback>>	m_EvictionCallbacks;
+		uint32_t											m_NextCallbackId;
+		mutable std::mutex									m_Mutex;
+	};
+
+	// Tracker used by AllocateMemoryObject() and FreeMemoryObject() called for the device, none by default
+	void SetMemoryBudgetTracker(VkDevice logicalDevice, MemoryBudgetTracker *tracker);
+	MemoryBudgetTracker * GetMemoryBudgetTracker(VkDevice logicalDevice);
+}
@@ -0,0 +1,459 @@
+#include "MipmapGenerator.h"
+#include "CommandBufferAndSyncFunctions.h"
+#include "CommandRecordingAndDrawing.h"
+#include "DescriptorSetsFunctions.h"
+#include "GraphicsAndComputePipeFunctions.h"
+#include "QueueTimeline.h"
+#include "ResourcesAndMemoryFunctions.h"
+#include "ResourceStateTracker.h"
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		uint32_t GetLevelDimension(uint32_t dimension, uint32_t level)
+		{
+			dimension >>= level;
+			return dimension > 0 ? dimension : 1;
+		}
+
+		VkImageMemoryBarrier SpecifyLevelsBarrier(VkImage image, uint32_t baseLevel, uint32_t levelsCount, uint32_t layersCount,
+			VkAccessFlags currentAccess, VkAccessFlags newAccess, VkImageLayout currentLayout, VkImageLayout newLayout)
+		{
+			VkImageMemoryBarrier imageMemoryBarrier =
+			{
+				VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,		// VkStructureType            sType
+				nullptr,									// const void               * pNext
+				currentAccess,								// VkAccessFlags              srcAccessMask
+				newAccess,									// VkAccessFlags              dstAccessMask
+				currentLayout,								// VkImageLayout              oldLayout
+				newLayout,									// VkImageLayout              newLayout
+				VK_QUEUE_FAMILY_IGNORED,					// uint32_t                   srcQueueFamilyIndex
+				VK_QUEUE_FAMILY_IGNORED,					// uint32_t                   dstQueueFamilyIndex
+				image,										// VkImage                    image
+				{											// VkImageSubresourceRange    subresourceRange
+					VK_IMAGE_ASPECT_COLOR_BIT,				// VkImageAspectFlags         aspectMask
+					baseLevel,								// uint32_t                   baseMipLevel
+					levelsCount,							// uint32_t                   levelCount
+					0,										// uint32_t                   baseArrayLayer
+					layersCount								// uint32_t                   layerCount
+				}
+			};
+			return imageMemoryBarrier;
+		}
+
+		void SetLevelsBarriers(VkCommandBuffer commandBuffer, VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages,
+			std::vector<VkImageMemoryBarrier> const &imageMemoryBarriers)
+		{
+			vkCmdPipelineBarrier(commandBuffer, generatingStages, consumingStages, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(imageMemoryBarriers.size()),
+				imageMemoryBarriers.data());
+		}
+	}
+
+	uint32_t CalculateMipmapsCount(VkExtent3D size)
+	{
+		uint32_t largestDimension = size.width > size.height ? size.width : size.height;
+		largestDimension = largestDimension > size.depth ? largestDimension : size.depth;
+
+		uint32_t mipmapsCount = 1;
+		while (largestDimension > 1)
+		{
+			largestDimension >>= 1;
+			++mipmapsCount;
+		}
+		return mipmapsCount;
+	}
+
+	MipmapGenerator::MipmapGenerator() :
+		m_PhysicalDevice(VK_NULL_HANDLE),
+		m_Sampler(VK_NULL_HANDLE),
+		m_DescriptorSetLayout(VK_NULL_HANDLE),
+		m_DescriptorPool(VK_NULL_HANDLE),
+		m_PipelineLayout(VK_NULL_HANDLE),
+		m_Pipeline(VK_NULL_HANDLE),
+		m_StorageImageWriteWithoutFormat(false),
+		m_PreferDownsampling(false)
+	{
+	}
+
+	MipmapGenerator::~MipmapGenerator()
+	{
+	}
+
+	bool MipmapGenerator::Initialize(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkPhysicalDeviceFeatures const *enabledFeatures,
+		std::vector<unsigned char> const &computeShaderCode, bool preferDownsampling)
+	{
+		m_PhysicalDevice = physicalDevice;
+		m_StorageImageWriteWithoutFormat = (nullptr != enabledFeatures) && (VK_TRUE == enabledFeatures->shaderStorageImageWriteWithoutFormat);
+		m_PreferDownsampling = preferDownsampling;
+
+		// Compute fallback is unavailable without the shader
+		if (computeShaderCode.empty())
+		{
+			return true;
+		}
+
+		// Source levels are read with texelFetch(), so filtering doesn't matter
+		if (!CreateSampler(logicalDevice, VK_FILTER_NEAREST, VK_FILTER_NEAREST, VK_SAMPLER_MIPMAP_MODE_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, 0.0f, false, 1.0f, false, VK_COMPARE_OP_ALWAYS, 0.0f, 0.0f,
+			VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK, false, m_Sampler))
+		{
+			return false;
+		}
+
+		// Descriptor sets, one per generated level
+		std::vector<VkDescriptorSetLayoutBinding> bindings =
+		{
+			{
+				0,											// uint32_t             binding
+				VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,	// VkDescriptorType     descriptorType
+				1,											// uint32_t             descriptorCount
+				VK_SHADER_STAGE_COMPUTE_BIT,				// VkShaderStageFlags   stageFlags
+				nullptr										// const VkSampler    * pImmutableSamplers
+			},
+			{
+				1,											// uint32_t             binding
+				VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,			// VkDescriptorType     descriptorType
+				1,											// uint32_t             descriptorCount
+				VK_SHADER_STAGE_COMPUTE_BIT,				// VkShaderStageFlags   stageFlags
+				nullptr										// const VkSampler    * pImmutableSamplers
+			}
+		};
+		if (!CreateDescriptorSetLayout(logicalDevice, bindings, m_DescriptorSetLayout))
+		{
+			return false;
+		}
+
+		if (!CreateDescriptorPool(logicalDevice, false, MaxMipmapsCount - 1,
+			{ { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MaxMipmapsCount - 1 }, { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, MaxMipmapsCount - 1 } }, m_DescriptorPool))
+		{
+			return false;
+		}
+
+		// Pipeline
+		std::vector<VkPushConstantRange> pushConstantRanges =
+		{
+			{
+				VK_SHADER_STAGE_COMPUTE_BIT,				// VkShaderStageFlags     stageFlags
+				0,											// uint32_t               offset
+				sizeof(DownsampleParameters)				// uint32_t               size
+			}
+		};
+		if (!CreatePipelineLayout(logicalDevice, { m_DescriptorSetLayout }, pushConstantRanges, m_PipelineLayout))
+		{
+			return false;
+		}
+
+		VkShaderModule computeShaderModule;
+		if (!CreateShaderModule(logicalDevice, computeShaderCode, computeShaderModule))
+		{
+			return false;
+		}
+
+		std::vector<VkPipelineShaderStageCreateInfo> shaderStageCreateInfos;
+		SpecifyPipelineShaderStages({ { VK_SHADER_STAGE_COMPUTE_BIT, computeShaderModule, "main", nullptr } }, shaderStageCreateInfos);
+
+		VkComputePipelineCreateInfo computePipelineCreateInfo;
+		CreateComputePiplineInfo(0, shaderStageCreateInfos[0], m_PipelineLayout, VK_NULL_HANDLE, -1, computePipelineCreateInfo);
+
+		bool result = CreateComputePipeline(logicalDevice, { computePipelineCreateInfo }, VK_NULL_HANDLE, m_Pipeline);
+		DestroyShaderModule(logicalDevice, computeShaderModule);
+		return result;
+	}
+
+	void MipmapGenerator::Destroy(VkDevice logicalDevice)
+	{
+		DestroyLevelViews(logicalDevice);
+		DestroyPipeline(logicalDevice, m_Pipeline);
+		DestroyPipelineLayout(logicalDevice, m_PipelineLayout);
+		DestroyDescriptorPool(logicalDevice, m_DescriptorPool);
+		DestroyDescriptorSetLayout(logicalDevice, m_DescriptorSetLayout);
+		DestroySampler(logicalDevice, m_Sampler);
+	}
+
+	bool MipmapGenerator::IsFormatSupported(VkFormat format) const
+	{
+		return IsLinearBlitSupported(format) || IsDownsampleSupported(format);
+	}
+
+	bool MipmapGenerator::RecordMipmapsGeneration(VkDevice logicalDevice, VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkExtent3D size,
+		uint32_t mipmapsCount, uint32_t layersCount, VkImageLayout currentLayout, VkAccessFlags currentAccess, VkPipelineStageFlags generatingStages,
+		VkImageLayout newLayout, VkAccessFlags newAccess, VkPipelineStageFlags consumingStages)
+	{
+		if ((0 == mipmapsCount) || (mipmapsCount > CalculateMipmapsCount(size)))
+		{
+			std::cout << "Could not generate mipmaps, number of levels doesn't match the image size." << std::endl;
+			return false;
+		}
+
+		ResourceStateTracker *stateTracker = GetResourceStateTracker(logicalDevice);
+#ifdef _DEBUG
+		if (nullptr != stateTracker)
+		{
+			stateTracker->ValidateImageState(image, { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, layersCount }, currentLayout, currentAccess);
+		}
+#endif
+
+		bool recorded = true;
+		bool downsampleSupported = (1 == size.depth) && IsDownsampleSupported(format);
+		if (1 == mipmapsCount)
+		{
+			SetLevelsBarriers(commandBuffer, generatingStages, consumingStages,
+				{ SpecifyLevelsBarrier(image, 0, 1, layersCount, currentAccess, newAccess, currentLayout, newLayout) });
+		}
+		else if (IsLinearBlitSupported(format) && !(m_PreferDownsampling && downsampleSupported))
+		{
+			RecordBlits(commandBuffer, image, size, mipmapsCount, layersCount, currentLayout, currentAccess, generatingStages, newLayout, newAccess,
+				consumingStages);
+		}
+		else if (downsampleSupported)
+		{
+			recorded = RecordDownsampling(logicalDevice, commandBuffer, image, format, size, mipmapsCount, layersCount, currentLayout, currentAccess,
+				generatingStages, newLayout, newAccess, consumingStages);
+		}
+		else
+		{
+			std::cout << "Could not generate mipmaps, provided format supports neither linear blits nor compute downsampling." << std::endl;
+			return false;
+		}
+
+		// All levels were already transitioned to the new layout by the generation's own barriers
+		if (recorded && (nullptr != stateTracker))
+		{
+			stateTracker->SetImageState(image, { VK_IMAGE_ASPECT_COLOR_BIT, 0, mipmapsCount, 0, layersCount }, newLayout, newAccess, consumingStages);
+		}
+		return recorded;
+	}
+
+	bool MipmapGenerator::GenerateMipmaps(VkDevice logicalDevice, VkQueue queue, VkCommandBuffer commandBuffer, VkImage image, VkFormat format,
+		VkExtent3D size, uint32_t mipmapsCount, uint32_t layersCount, VkImageLayout currentLayout, VkAccessFlags currentAccess,
+		VkPipelineStageFlags generatingStages, VkImageLayout newLayout, VkAccessFlags newAccess, VkPipelineStageFlags consumingStages)
+	{
+		if (!BeginCommandBufferRecordingOperation(commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr))
+		{
+			return false;
+		}
+
+		if (!RecordMipmapsGeneration(logicalDevice, commandBuffer, image, format, size, mipmapsCount, layersCount, currentLayout, currentAccess,
+			generatingStages, newLayout, newAccess, consumingStages))
+		{
+			EndCommandBufferRecordingOperation(commandBuffer);
+			return false;
+		}
+
+		if (!EndCommandBufferRecordingOperation(commandBuffer))
+		{
+			return false;
+		}
+
+		return SubmitCommandBuffersAndWait(logicalDevice, queue, { commandBuffer }, {}, 500000000);
+	}
+
+	bool MipmapGenerator::IsLinearBlitSupported(VkFormat format) const
+	{
+		VkFormatProperties formatProperties;
+		vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &formatProperties);
+
+		VkFormatFeatureFlags requiredFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+			VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+		return requiredFeatures == (formatProperties.optimalTilingFeatures & requiredFeatures);
+	}
+
+	bool MipmapGenerator::IsDownsampleSupported(VkFormat format) const
+	{
+		if ((VK_NULL_HANDLE == m_Pipeline) || !m_StorageImageWriteWithoutFormat)
+		{
+			return false;
+		}
+
+		VkFormatProperties formatProperties;
+		vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &formatProperties);
+
+		VkFormatFeatureFlags requiredFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT;
+		return requiredFeatures == (formatProperties.optimalTilingFeatures & requiredFeatures);
+	}
+
+	void MipmapGenerator::RecordBlits(VkCommandBuffer commandBuffer, VkImage image, VkExtent3D size, uint32_t mipmapsCount, uint32_t layersCount,
+		VkImageLayout currentLayout, VkAccessFlags currentAccess, VkPipelineStageFlags generatingStages, VkImageLayout newLayout,
+		VkAccessFlags newAccess, VkPipelineStageFlags consumingStages)
+	{
+		SetLevelsBarriers(commandBuffer, generatingStages, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			{
+				SpecifyLevelsBarrier(image, 0, 1, layersCount, currentAccess, VK_ACCESS_TRANSFER_READ_BIT, currentLayout,
+					VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL),
+				SpecifyLevelsBarrier(image, 1, mipmapsCount - 1, layersCount, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+			});
+
+		for (uint32_t level = 1; level < mipmapsCount; ++level)
+		{
+			VkImageBlit imageBlit =
+			{
+				{											// VkImageSubresourceLayers   srcSubresource
+					VK_IMAGE_ASPECT_COLOR_BIT,				// VkImageAspectFlags         aspectMask
+					level - 1,								// uint32_t                   mipLevel
+					0,										// uint32_t                   baseArrayLayer
+					layersCount								// uint32_t                   layerCount
+				},
+				{											// VkOffset3D                 srcOffsets[2]
+					{ 0, 0, 0 },
+					{
+						static_cast<int32_t>(GetLevelDimension(size.width, level - 1)),
+						static_cast<int32_t>(GetLevelDimension(size.height, level - 1)),
+						static_cast<int32_t>(GetLevelDimension(size.depth, level - 1))
+					}
+				},
+				{											// VkImageSubresourceLayers   dstSubresource
+					VK_IMAGE_ASPECT_COLOR_BIT,				// VkImageAspectFlags         aspectMask
+					level,									// uint32_t                   mipLevel
+					0,										// uint32_t                   baseArrayLayer
+					layersCount								// uint32_t                   layerCount
+				},
+				{											// VkOffset3D                 dstOffsets[2]
+					{ 0, 0, 0 },
+					{
+						static_cast<int32_t>(GetLevelDimension(size.width, level)),
+						static_cast<int32_t>(GetLevelDimension(size.height, level)),
+						static_cast<int32_t>(GetLevelDimension(size.depth, level))
+					}
+				}
+			};
+			vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageBlit,
+				VK_FILTER_LINEAR);
+
+			// Written level becomes the source of the next one
+			if (level + 1 < mipmapsCount)
+			{
+				SetLevelsBarriers(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+					{
+						SpecifyLevelsBarrier(image, level, 1, layersCount, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+							VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+					});
+			}
+		}
+
+		SetLevelsBarriers(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, consumingStages,
+			{
+				SpecifyLevelsBarrier(image, 0, mipmapsCount - 1, layersCount, VK_ACCESS_TRANSFER_READ_BIT, newAccess,
+					VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, newLayout),
+				SpecifyLevelsBarrier(image, mipmapsCount - 1, 1, layersCount, VK_ACCESS_TRANSFER_WRITE_BIT, newAccess,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, newLayout)
+			});
+	}
+
+	bool MipmapGenerator::RecordDownsampling(VkDevice logicalDevice, VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkExtent3D size,
+		uint32_t mipmapsCount, uint32_t layersCount, VkImageLayout currentLayout, VkAccessFlags currentAccess, VkPipelineStageFlags generatingStages,
+		VkImageLayout newLayout, VkAccessFlags newAccess, VkPipelineStageFlags consumingStages)
+	{
+		if (mipmapsCount > MaxMipmapsCount)
+		{
+			std::cout << "Could not downsample mipmaps, number of levels exceeds the size of the descriptor pool." << std::endl;
+			return false;
+		}
+
+		// Resources of the previous generation are no longer used by the GPU
+		DestroyLevelViews(logicalDevice);
+		if (!ResetDescriptorPool(logicalDevice, m_DescriptorPool))
+		{
+			return false;
+		}
+
+		// Array views also cover cubemaps, as the shader treats faces as layers
+		m_LevelViews.resize(mipmapsCount, VK_NULL_HANDLE);
+		for (uint32_t level = 0; level < mipmapsCount; ++level)
+		{
+			VkImageViewCreateInfo imageViewCreateInfo =
+			{
+				VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,	// VkStructureType            sType
+				nullptr,									// const void               * pNext
+				0,											// VkImageViewCreateFlags     flags
+				image,										// VkImage                    image
+				VK_IMAGE_VIEW_TYPE_2D_ARRAY,				// VkImageViewType            viewType
+				format,										// VkFormat                   format
+				{											// VkComponentMapping         components
+					VK_COMPONENT_SWIZZLE_IDENTITY,			// VkComponentSwizzle         r
+					VK_COMPONENT_SWIZZLE_IDENTITY,			// VkComponentSwizzle         g
+					VK_COMPONENT_SWIZZLE_IDENTITY,			// VkComponentSwizzle         b
+					VK_COMPONENT_SWIZZLE_IDENTITY			// VkComponentSwizzle         a
+				},
+				{											// VkImageSubresourceRange    subresourceRange
+					VK_IMAGE_ASPECT_COLOR_BIT,				// VkImageAspectFlags         aspectMask
+					level,									// uint32_t                   baseMipLevel
+					1,										// uint32_t                   levelCount
+					0,										// uint32_t                   baseArrayLayer
+					layersCount								// uint32_t                   layerCount
+				}
+			};
+
+			VkResult result = vkCreateImageView(logicalDevice, &imageViewCreateInfo, nullptr, &m_LevelViews[level]);
+			if (VK_SUCCESS != result)
+			{
+				std::cout << "Could not create an image view of a mipmap level." << std::endl;
+				return false;
+			}
+		}
+
+		std::vector<VkDescriptorSet> descriptorSets;
+		if (!AllocateDescriptorSets(logicalDevice, m_DescriptorPool, std::vector<VkDescriptorSetLayout>(mipmapsCount - 1, m_DescriptorSetLayout),
+			descriptorSets))
+		{
+			return false;
+		}
+
+		std::vector<ImageDescriptorInfo> imageDescriptorInfos;
+		for (uint32_t level = 1; level < mipmapsCount; ++level)
+		{
+			imageDescriptorInfos.push_back({ descriptorSets[level - 1], 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+				{ { m_Sampler, m_LevelViews[level - 1], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL } } });
+			imageDescriptorInfos.push_back({ descriptorSets[level - 1], 1, 0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+				{ { VK_NULL_HANDLE, m_LevelViews[level], VK_IMAGE_LAYOUT_GENERAL } } });
+		}
+		UpdateDescriptorSets(logicalDevice, imageDescriptorInfos, {}, {}, {});
+
+		SetLevelsBarriers(commandBuffer, generatingStages, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			{
+				SpecifyLevelsBarrier(image, 0, 1, layersCount, currentAccess, VK_ACCESS_SHADER_READ_BIT, currentLayout,
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL),
+				SpecifyLevelsBarrier(image, 1, mipmapsCount - 1, layersCount, 0, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+					VK_IMAGE_LAYOUT_GENERAL)
+			});
+
+		BindPipelineObject(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+		for (uint32_t level = 1; level < mipmapsCount; ++level)
+		{
+			DownsampleParameters parameters =
+			{
+				{ static_cast<int32_t>(GetLevelDimension(size.width, level - 1)), static_cast<int32_t>(GetLevelDimension(size.height, level - 1)) },
+				{ static_cast<int32_t>(GetLevelDimension(size.width, level)), static_cast<int32_t>(GetLevelDimension(size.height, level)) }
+			};
+
+			BindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, { descriptorSets[level - 1] }, {});
+			ProvideDataToShadersThroughPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(DownsampleParameters), &parameters);
+			DispatchComputeWork(commandBuffer, (parameters.m_DestinationSize[0] + WorkgroupSize - 1) / WorkgroupSize,
+				(parameters.m_DestinationSize[1] + WorkgroupSize - 1) / WorkgroupSize, layersCount);
+
+			SetLevelsBarriers(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				{
+					SpecifyLevelsBarrier(image, level, 1, layersCount, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL,
+						VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+				});
+		}
+
+		// All levels are now in the same state
+		SetLevelsBarriers(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, consumingStages,
+			{
+				SpecifyLevelsBarrier(image, 0, mipmapsCount, layersCount, VK_ACCESS_SHADER_READ_BIT, newAccess,
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, newLayout)
+			});
+		return true;
+	}
+
+	void MipmapGenerator::DestroyLevelViews(VkDevice logicalDevice)
+	{
+		for (auto &levelView : m_LevelViews)
+		{
+			DestroyImageView(logicalDevice, levelView);
+		}
+		m_LevelViews.clear();
+	}
+}
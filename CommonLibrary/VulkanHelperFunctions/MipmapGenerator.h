@@ -0,0 +1,68 @@
+#pragma once
+#include "../CommonFiles/Common.h"
+
+namespace VulkanSampleFramework
+{
+	// Number of levels of a full mipmap chain, down to 1x1x1
+	uint32_t CalculateMipmapsCount(VkExtent3D size);
+
+	// Builds mipmap chains of color images from their most detailed level, all levels are recorded into a single command buffer.
+	// Levels are blitted with linear filtering when the format supports it, which requires images created with both transfer
+	// usages. Otherwise each level is downsampled from the previous one in a compute shader, which requires the storage usage,
+	// the shaderStorageImageWriteWithoutFormat feature and a format supporting storage images. Compute path handles 2D images,
+	// including arrays and cubemaps, while blits also handle 3D images.
+	class MipmapGenerator
+	{
+	public:
+		// Shader code is the SPIR-V compiled from CommonLibrary/Shaders/Downsample.comp, it may be empty when only formats supporting linear
+		// blits are used. Preferring downsampling uses the compute path also for formats which could be blitted, e.g. to verify the fallback.
+		bool Initialize(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkPhysicalDeviceFeatures const *enabledFeatures,
+			std::vector<unsigned char> const &computeShaderCode, bool preferDownsampling);
+		void Destroy(VkDevice logicalDevice);
+
+		bool IsFormatSupported(VkFormat format) const;
+
+		// Most detailed level must be in the current layout, content of the remaining levels is discarded. All levels end in the new layout.
+		// Compute path reuses its image views and descriptor sets, so the command buffer must finish before the next generation is recorded.
+		bool RecordMipmapsGeneration(VkDevice logicalDevice, VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkExtent3D size,
+			uint32_t mipmapsCount, uint32_t layersCount, VkImageLayout currentLayout, VkAccessFlags currentAccess, VkPipelineStageFlags generatingStages,
+			VkImageLayout newLayout, VkAccessFlags newAccess, VkPipelineStageFlags consumingStages);
+		// Records, submits and waits for the generation, e.g. right after UseStagingBufferToUpdateImageWithDeviceLocalMemoryBound()
+		bool GenerateMipmaps(VkDevice logicalDevice, VkQueue queue, VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkExtent3D size,
+			uint32_t mipmapsCount, uint32_t layersCount, VkImageLayout currentLayout, VkAccessFlags currentAccess, VkPipelineStageFlags generatingStages,
+			VkImageLayout newLayout, VkAccessFlags newAccess, VkPipelineStageFlags consumingStages);
+
+		MipmapGenerator();
+		~MipmapGenerator();
+
+	private:
+		static uint32_t const	MaxMipmapsCount = 16;
+		static uint32_t const	WorkgroupSize = 8;
+
+		struct DownsampleParameters
+		{
+			int32_t	m_SourceSize[2];
+			int32_t	m_DestinationSize[2];
+		};
+
+		bool IsLinearBlitSupported(VkFormat format) const;
+		bool IsDownsampleSupported(VkFormat format) const;
+		void RecordBlits(VkCommandBuffer commandBuffer, VkImage image, VkExtent3D size, uint32_t mipmapsCount, uint32_t layersCount,
+			VkImageLayout currentLayout, VkAccessFlags currentAccess, VkPipelineStageFlags generatingStages, VkImageLayout newLayout,
+			VkAccessFlags newAccess, VkPipelineStageFlags consumingStages);
+		bool RecordDownsampling(VkDevice logicalDevice, VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkExtent3D size,
+			uint32_t mipmapsCount, uint32_t layersCount, VkImageLayout currentLayout, VkAccessFlags currentAccess, VkPipelineStageFlags generatingStages,
+			VkImageLayout newLayout, VkAccessFlags newAccess, VkPipelineStageFlags consumingStages);
+		void DestroyLevelViews(VkDevice logicalDevice);
+
+		VkPhysicalDevice			m_PhysicalDevice;
+		VkSampler					m_Sampler;
+		VkDescriptorSetLayout		m_DescriptorSetLayout;
+		VkDescriptorPool			m_DescriptorPool;
+		VkPipelineLayout			m_PipelineLayout;
+		VkPipeline					m_Pipeline;
+		std::vector<VkImageView>	m_LevelViews;
+		bool						m_StorageImageWriteWithoutFormat;
+		bool						m_PreferDownsampling;
+	};
+}
@@ -0,0 +1,284 @@
+#include "QueueTimeline.h"
+#include "SyncObjectPools.h"
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		std::vector<QueueTimeline *> RegisteredQueueTimelines;
+		std::mutex RegisteredQueueTimelinesMutex;
+	}
+
+	QueueTimeline::QueueTimeline() :
+		m_Queue(VK_NULL_HANDLE),
+		m_Semaphore(VK_NULL_HANDLE),
+		m_LastSubmittedValue(0),
+		m_CompletedValue(0)
+	{
+	}
+
+	bool QueueTimeline::Initialize(VkDevice logicalDevice, VkQueue queue)
+	{
+		if (nullptr == vkWaitSemaphoresKHR)
+		{
+			std::cout << "Could not create a timeline semaphore, " << VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME << " was not enabled." << std::endl;
+			return false;
+		}
+
+		VkSemaphoreTypeCreateInfoKHR semaphoreTypeCreateInfo =
+		{
+			VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR,	// VkStructureType       sType
+			nullptr,											// const void          * pNext
+			VK_SEMAPHORE_TYPE_TIMELINE_KHR,						// VkSemaphoreTypeKHR    semaphoreType
+			0													// uint64_t              initialValue
+		};
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo =
+		{
+			VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,			// VkStructureType            sType
+			&semaphoreTypeCreateInfo,							// const void               * pNext
+			0													// VkSemaphoreCreateFlags     flags
+		};
+
+		VkResult result = vkCreateSemaphore(logicalDevice, &semaphoreCreateInfo, nullptr, &m_Semaphore);
+		if (VK_SUCCESS != result)
+		{
+			std::cout << "Could not create a timeline semaphore." << std::endl;
+			return false;
+		}
+
+		m_Queue = queue;
+		m_LastSubmittedValue = 0;
+		m_CompletedValue = 0;
+		return true;
+	}
+
+	void QueueTimeline::Destroy(VkDevice logicalDevice)
+	{
+		DestroySemaphore(logicalDevice, m_Semaphore);
+		m_Queue = VK_NULL_HANDLE;
+		m_LastSubmittedValue = 0;
+		m_CompletedValue = 0;
+	}
+
+	bool QueueTimeline::Submit(std::vector<TimelineWaitInfo> const &timelineWaits, std::vector<WaitSemaphoreInfo> const &waitSemaphoreInfos,
+		std::vector<VkCommandBuffer> const &commandBuffers, std::vector<VkSemaphore> const &signalSemaphores, TimelinePoint &signaledPoint)
+	{
+		// Values of binary semaphores are ignored, but there must be one for each semaphore
+		std::vector<VkSemaphore>			waitSemaphoreHandles;
+		std::vector<VkPipelineStageFlags>	waitSemaphoreStages;
+		std::vector<uint64_t>				waitSemaphoreValues;
+		for (auto &timelineWait : timelineWaits)
+		{
+			waitSemaphoreHandles.push_back(timelineWait.m_Point.m_Semaphore);
+			waitSemaphoreStages.push_back(timelineWait.m_WaitingStages);
+			waitSemaphoreValues.push_back(timelineWait.m_Point.m_Value);
+		}
+		for (auto &waitSemaphoreInfo : waitSemaphoreInfos)
+		{
+			waitSemaphoreHandles.push_back(waitSemaphoreInfo.m_Semaphore);
+			waitSemaphoreStages.push_back(waitSemaphoreInfo.m_WaitingStage);
+			waitSemaphoreValues.push_back(0);
+		}
+
+		// Values must increase in the submission order, so they are assigned under the lock held until the submission
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		uint64_t signaledValue = m_LastSubmittedValue + 1;
+
+		std::vector<VkSemaphore> signalSemaphoreHandles = { m_Semaphore };
+		std::vector<uint64_t> signalSemaphoreValues = { signaledValue };
+		for (auto &signalSemaphore : signalSemaphores)
+		{
+			signalSemaphoreHandles.push_back(signalSemaphore);
+			signalSemaphoreValues.push_back(0);
+		}
+
+		VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfo =
+		{
+			VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,		// VkStructureType     sType
+			nullptr,													// const void        * pNext
+			static_cast<uint32_t>(waitSemaphoreValues.size()),			// uint32_t            waitSemaphoreValueCount
+			waitSemaphoreValues.data(),									// const uint64_t    * pWaitSemaphoreValues
+			static_cast<uint32_t>(signalSemaphoreValues.size()),		// uint32_t            signalSemaphoreValueCount
+			signalSemaphoreValues.data()								// const uint64_t    * pSignalSemaphoreValues
+		};
+
+		VkSubmitInfo submitInfo =
+		{
+			VK_STRUCTURE_TYPE_SUBMIT_INFO,								// VkStructureType                sType
+			&timelineSubmitInfo,										// const void                   * pNext
+			static_cast<uint32_t>(waitSemaphoreHandles.size()),			// uint32_t                       waitSemaphoreCount
+			waitSemaphoreHandles.data(),								// const VkSemaphore            * pWaitSemaphores
+			waitSemaphoreStages.data(),									// const VkPipelineStageFlags   * pWaitDstStageMask
+			static_cast<uint32_t>(commandBuffers.size()),				// uint32_t                       commandBufferCount
+			commandBuffers.data(),										// const VkCommandBuffer        * pCommandBuffers
+			static_cast<uint32_t>(signalSemaphoreHandles.size()),		// uint32_t                       signalSemaphoreCount
+			signalSemaphoreHandles.data()								// const VkSemaphore            * pSignalSemaphores
+		};
+
+		VkResult result = vkQueueSubmit(m_Queue, 1, &submitInfo, VK_NULL_HANDLE);
+		if (VK_SUCCESS != result)
+		{
+			std::cout << "Error occurred during command buffer submission." << std::endl;
+			return false;
+		}
+
+		m_LastSubmittedValue = signaledValue;
+		signaledPoint = { m_Semaphore, signaledValue };
+		return true;
+	}
+
+	bool QueueTimeline::IsCompleted(VkDevice logicalDevice, uint64_t value)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (value <= m_CompletedValue)
+		{
+			return true;
+		}
+
+		uint64_t completedValue;
+		VkResult result = vkGetSemaphoreCounterValueKHR(logicalDevice, m_Semaphore, &completedValue);
+		if (VK_SUCCESS != result)
+		{
+			std::cout << "Could not get a value of a timeline semaphore." << std::endl;
+			return false;
+		}
+		m_CompletedValue = completedValue;
+		return value <= m_CompletedValue;
+	}
+
+	bool QueueTimeline::Wait(VkDevice logicalDevice, uint64_t value, uint64_t timeout /*nanosecond*/)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (value <= m_CompletedValue)
+			{
+				return true;
+			}
+		}
+
+		VkSemaphoreWaitInfoKHR waitInfo =
+		{
+			VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR,		// VkStructureType            sType
+			nullptr,										// const void               * pNext
+			0,												// VkSemaphoreWaitFlagsKHR    flags
+			1,												// uint32_t                   semaphoreCount
+			&m_Semaphore,									// const VkSemaphore        * pSemaphores
+			&value											// const uint64_t           * pValues
+		};
+
+		// Other threads may submit while this one waits
+		VkResult result = vkWaitSemaphoresKHR(logicalDevice, &waitInfo, timeout);
+		if (VK_SUCCESS != result)
+		{
+			std::cout << "Waiting on a timeline semaphore failed." << std::endl;
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_CompletedValue = value > m_CompletedValue ? value : m_CompletedValue;
+		return true;
+	}
+
+	uint64_t QueueTimeline::GetCompletedValue() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_CompletedValue;
+	}
+
+	uint64_t QueueTimeline::GetLastSubmittedValue() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_LastSubmittedValue;
+	}
+
+	VkQueue QueueTimeline::GetQueue() const
+	{
+		return m_Queue;
+	}
+
+	VkSemaphore QueueTimeline::GetSemaphore() const
+	{
+		return m_Semaphore;
+	}
+
+	void RegisterQueueTimeline(QueueTimeline *timeline)
+	{
+		std::lock_guard<std::mutex> lock(RegisteredQueueTimelinesMutex);
+		RegisteredQueueTimelines.push_back(timeline);
+	}
+
+	void UnregisterQueueTimeline(QueueTimeline *timeline)
+	{
+		std::lock_guard<std::mutex> lock(RegisteredQueueTimelinesMutex);
+		for (auto it = RegisteredQueueTimelines.begin(); it != RegisteredQueueTimelines.end(); ++it)
+		{
+			if (timeline == *it)
+			{
+				RegisteredQueueTimelines.erase(it);
+				return;
+			}
+		}
+	}
+
+	QueueTimeline * FindQueueTimeline(VkQueue queue)
+	{
+		std::lock_guard<std::mutex> lock(RegisteredQueueTimelinesMutex);
+		for (auto timeline : RegisteredQueueTimelines)
+		{
+			if (queue == timeline->GetQueue())
+			{
+				return timeline;
+			}
+		}
+		return nullptr;
+	}
+
+	bool SubmitCommandBuffersAndWait(VkDevice logicalDevice, VkQueue queue, std::vector<VkCommandBuffer> const &commandBuffers,
+		std::vector<VkSemaphore> const &signalSemaphores, uint64_t timeout /*nanosecond*/)
+	{
+		QueueTimeline *timeline = FindQueueTimeline(queue);
+		if (nullptr != timeline)
+		{
+			TimelinePoint signaledPoint;
+			return timeline->Submit({}, {}, commandBuffers, signalSemaphores, signaledPoint) &&
+				timeline->Wait(logicalDevice, signaledPoint.m_Value, timeout);
+		}
+
+		FencePool *fencePool = GetFencePool(logicalDevice);
+		if (nullptr == fencePool)
+		{
+			VkFence fence;
+			if (!CreateFence(logicalDevice, false, fence))
+			{
+				return false;
+			}
+
+			bool result = SubmitCommandBuffersToQueue(queue, {}, commandBuffers, signalSemaphores, fence) &&
+				WaitForFences(logicalDevice, { fence }, VK_FALSE, timeout);
+			DestroyFence(logicalDevice, fence);
+			return result;
+		}
+
+		VkFence fence;
+		if (!fencePool->AcquireFence(logicalDevice, fence))
+		{
+			return false;
+		}
+
+		if (!SubmitCommandBuffersToQueue(queue, {}, commandBuffers, signalSemaphores, fence))
+		{
+			// Nothing was submitted, so the fence may be returned right away
+			fencePool->ReleaseFence(logicalDevice, fence);
+			return false;
+		}
+
+		// After a timeout the submitted work may still signal the fence
+		if (!WaitForFences(logicalDevice, { fence }, VK_FALSE, timeout))
+		{
+			fencePool->ReleaseFenceWhenSignaled(fence);
+			return false;
+		}
+		return fencePool->ReleaseFence(logicalDevice, fence);
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <mutex>
+#include "../CommonFiles/Common.h"
+#include "CommandBufferAndSyncFunctions.h"
+
+namespace VulkanSampleFramework
+{
+	// Point on a timeline of a queue, reached when all work submitted up to it has finished
+	struct TimelinePoint
+	{
+		VkSemaphore		m_Semaphore;
+		uint64_t		m_Value;
+	};
+
+	struct TimelineWaitInfo
+	{
+		TimelinePoint			m_Point;
+		VkPipelineStageFlags	m_WaitingStages;
+	};
+
+	// Single timeline semaphore of a queue (VK_KHR_timeline_semaphore) whose value is incremented with every submission made through it.
+	// Frames and uploads are tracked as values on the timeline, so CPU waits, recycling of resources used by them and dependencies between
+	// queues don't need their own fences and semaphores. Submissions made through the timeline must not be mixed with other submissions
+	// to the same queue waiting on its semaphore.
+	class QueueTimeline
+	{
+	public:
+		// Requires VK_KHR_timeline_semaphore and its feature enabled on the device
+		bool Initialize(VkDevice logicalDevice, VkQueue queue);
+		void Destroy(VkDevice logicalDevice);
+
+		// Binary wait and signal semaphores may be used together with timeline points (e.g. for swapchain images),
+		// returns the point signaled when the submitted command buffers finish
+		bool Submit(std::vector<TimelineWaitInfo> const &timelineWaits, std::vector<WaitSemaphoreInfo> const &waitSemaphoreInfos,
+			std::vector<VkCommandBuffer> const &commandBuffers, std::vector<VkSemaphore> const &signalSemaphores, TimelinePoint &signaledPoint);
+		bool IsCompleted(VkDevice logicalDevice, uint64_t value);
+		bool Wait(VkDevice logicalDevice, uint64_t value, uint64_t timeout /*nanosecond*/);
+
+		// Last value read from the semaphore, may be behind the device
+		uint64_t GetCompletedValue() const;
+		uint64_t GetLastSubmittedValue() const;
+		VkQueue GetQueue() const;
+		VkSemaphore GetSemaphore() const;
+
+		QueueTimeline();
+
+	private:
+		VkQueue					m_Queue;
+		VkSemaphore				m_Semaphore;
+		uint64_t				m_LastSubmittedValue;
+		uint64_t				m_CompletedValue;
+		mutable std::mutex		m_Mutex;
+	};
+
+	// Timelines used by the helper functions submitting to their queues, none by default
+	void RegisterQueueTimeline(QueueTimeline *timeline);
+	void UnregisterQueueTimeline(QueueTimeline *timeline);
+	QueueTimeline * FindQueueTimeline(VkQueue queue);
+
+	// Submits command buffers and waits until they finish, on a registered timeline of the queue or with a fence from the current pool
+	// (or a temporary one) without it
+	bool SubmitCommandBuffersAndWait(VkDevice logicalDevice, VkQueue queue, std::vector<VkCommandBuffer> const &commandBuffers,
+		std::vector<VkSemaphore> const &signalSemaphores, uint64_t timeout /*nanosecond*/);
+}
@@ -0,0 +1,585 @@
+#include "RenderGraph.h"
+#include "ResourceStateTracker.h"
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		uint32_t const InvalidIndex = 0xFFFFFFFF;
+
+		// Simulated state of a resource while barriers are placed
+		struct ResourceState
+		{
+			VkImageLayout			m_Layout;
+			uint32_t				m_QueueFamily;
+			VkPipelineStageFlags	m_WriteStages;
+			VkAccessFlags			m_WriteAccess;
+			VkPipelineStageFlags	m_ReadStages;		// Reads since the last write
+			VkPipelineStageFlags	m_VisibleStages;	// Stages and accesses already synchronized with the last write
+			VkAccessFlags			m_VisibleAccess;
+			uint32_t				m_LastBatch;
+		};
+	}
+
+	RenderGraph::RenderGraph()
+	{
+	}
+
+	uint32_t RenderGraph::ImportBuffer(VkBuffer buffer, VkAccessFlags currentAccess, VkPipelineStageFlags currentStages, uint32_t currentQueueFamily,
+		uint32_t finalQueueFamily, bool output)
+	{
+		Resource resource = {};
+		resource.m_Output = output;
+		resource.m_Buffer = buffer;
+		resource.m_CurrentAccess = currentAccess;
+		resource.m_CurrentStages = currentStages;
+		resource.m_CurrentQueueFamily = currentQueueFamily;
+		resource.m_FinalQueueFamily = finalQueueFamily;
+		m_Resources.push_back(resource);
+		return static_cast<uint32_t>(m_Resources.size() - 1);
+	}
+
+	uint32_t RenderGraph::ImportImage(VkImage image, VkImageAspectFlags aspect, VkImageLayout currentLayout, VkAccessFlags currentAccess,
+		VkPipelineStageFlags currentStages, uint32_t currentQueueFamily, VkImageLayout finalLayout, uint32_t finalQueueFamily, bool output)
+	{
+		Resource resource = {};
+		resource.m_IsImage = true;
+		resource.m_Output = output;
+		resource.m_Image = image;
+		resource.m_Aspect = aspect;
+		resource.m_CurrentLayout = currentLayout;
+		resource.m_CurrentAccess = currentAccess;
+		resource.m_CurrentStages = currentStages;
+		resource.m_CurrentQueueFamily = currentQueueFamily;
+		resource.m_FinalLayout = finalLayout;
+		resource.m_FinalQueueFamily = finalQueueFamily;
+		m_Resources.push_back(resource);
+		return static_cast<uint32_t>(m_Resources.size() - 1);
+	}
+
+	uint32_t RenderGraph::CreateImage(AttachmentDescription const &description)
+	{
+		Resource resource = {};
+		resource.m_IsImage = true;
+		resource.m_Transient = true;
+		resource.m_Aspect = description.m_Aspect;
+		resource.m_Description = description;
+		resource.m_CurrentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		resource.m_CurrentQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+		resource.m_FinalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		resource.m_FinalQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+		m_Resources.push_back(resource);
+		return static_cast<uint32_t>(m_Resources.size() - 1);
+	}
+
+	uint32_t RenderGraph::AddPass(char const *name, uint32_t queueFamily, std::function<bool(VkCommandBuffer)> recordFunction)
+	{
+		m_Passes.push_back({ name, queueFamily, recordFunction, {}, false });
+		return static_cast<uint32_t>(m_Passes.size() - 1);
+	}
+
+	void RenderGraph::ReadBuffer(uint32_t pass, uint32_t buffer, VkAccessFlags access, VkPipelineStageFlags stages)
+	{
+		AddAccess(pass, { buffer, false, access, stages, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_UNDEFINED });
+	}
+
+	void RenderGraph::WriteBuffer(uint32_t pass, uint32_t buffer, VkAccessFlags access, VkPipelineStageFlags stages)
+	{
+		AddAccess(pass, { buffer, true, access, stages, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_UNDEFINED });
+	}
+
+	void RenderGraph::ReadImage(uint32_t pass, uint32_t image, VkImageLayout layout, VkAccessFlags access, VkPipelineStageFlags stages)
+	{
+		AddAccess(pass, { image, false, access, stages, layout, layout });
+	}
+
+	void RenderGraph::WriteImage(uint32_t pass, uint32_t image, VkImageLayout layout, VkAccessFlags access, VkPipelineStageFlags stages)
+	{
+		AddAccess(pass, { image, true, access, stages, layout, layout });
+	}
+
+	void RenderGraph::WriteRenderPassAttachment(uint32_t pass, uint32_t image, VkImageLayout initialLayout, VkImageLayout finalLayout,
+		VkAccessFlags access, VkPipelineStageFlags stages)
+	{
+		AddAccess(pass, { image, true, access, stages, initialLayout, finalLayout });
+	}
+
+	bool RenderGraph::Compile(VkDevice logicalDevice, TransientAttachmentPool *attachmentPool, uint32_t frameIndex)
+	{
+		CullPasses();
+		OrderPasses();
+
+		m_Batches.clear();
+		for (auto &resource : m_Resources)
+		{
+			resource.m_FirstUse = InvalidIndex;
+			resource.m_LastUse = InvalidIndex;
+		}
+
+		for (uint32_t position = 0; position < m_ExecutionOrder.size(); ++position)
+		{
+			Pass const &pass = m_Passes[m_ExecutionOrder[position]];
+			if (m_Batches.empty() || (m_Batches.back().m_QueueFamily != pass.m_QueueFamily))
+			{
+				m_Batches.push_back({ pass.m_QueueFamily, position, 0, 0, Barriers() });
+			}
+			++m_Batches.back().m_PassesCount;
+
+			for (auto &access : pass.m_Accesses)
+			{
+				Resource &resource = m_Resources[access.m_Resource];
+				if (InvalidIndex == resource.m_FirstUse)
+				{
+					resource.m_FirstUse = position;
+				}
+				resource.m_LastUse = position;
+			}
+		}
+
+		if (!AllocateTransientImages(logicalDevice, attachmentPool, frameIndex))
+		{
+			return false;
+		}
+
+		PlaceBarriers();
+		return true;
+	}
+
+	uint32_t RenderGraph::GetBatchesCount() const
+	{
+		return static_cast<uint32_t>(m_Batches.size());
+	}
+
+	uint32_t RenderGraph::GetBatchQueueFamily(uint32_t batch) const
+	{
+		return m_Batches[batch].m_QueueFamily;
+	}
+
+	VkPipelineStageFlags RenderGraph::GetBatchWaitStages(uint32_t batch) const
+	{
+		return m_Batches[batch].m_WaitStages;
+	}
+
+	bool RenderGraph::RecordBatch(uint32_t batch, VkCommandBuffer commandBuffer, BarrierBatcher &barrierBatcher) const
+	{
+		Batch const &currentBatch = m_Batches[batch];
+		for (uint32_t position = currentBatch.m_FirstPass; position < currentBatch.m_FirstPass + currentBatch.m_PassesCount; ++position)
+		{
+			RecordBarriers(barrierBatcher, m_PassBarriers[position]);
+			barrierBatcher.Flush(commandBuffer);
+
+			Pass const &pass = m_Passes[m_ExecutionOrder[position]];
+			if (!pass.m_RecordFunction(commandBuffer))
+			{
+				std::cout << "Could not record render graph pass '" << pass.m_Name << "'." << std::endl;
+				return false;
+			}
+		}
+
+		RecordBarriers(barrierBatcher, currentBatch.m_FinalBarriers);
+		barrierBatcher.Flush(commandBuffer);
+		return true;
+	}
+
+	bool RenderGraph::IsPassCulled(uint32_t pass) const
+	{
+		return m_Passes[pass].m_Culled;
+	}
+
+	VkImage RenderGraph::GetImage(uint32_t image) const
+	{
+		return m_Resources[image].m_Image;
+	}
+
+	VkImageView RenderGraph::GetImageView(uint32_t image) const
+	{
+		return m_Resources[image].m_ImageView;
+	}
+
+	void RenderGraph::Reset()
+	{
+		m_Resources.clear();
+		m_Passes.clear();
+		m_ExecutionOrder.clear();
+		m_PassBarriers.clear();
+		m_Batches.clear();
+	}
+
+	void RenderGraph::AddAccess(uint32_t pass, Access const &access)
+	{
+		// Pass accessing a resource in several ways needs it in a single layout, so accesses are merged
+		for (auto &existingAccess : m_Passes[pass].m_Accesses)
+		{
+			if (access.m_Resource == existingAccess.m_Resource)
+			{
+				existingAccess.m_Write = existingAccess.m_Write || access.m_Write;
+				existingAccess.m_Access |= access.m_Access;
+				existingAccess.m_Stages |= access.m_Stages;
+				existingAccess.m_Layout = access.m_Layout;
+				existingAccess.m_LayoutAfterPass = access.m_LayoutAfterPass;
+				return;
+			}
+		}
+		m_Passes[pass].m_Accesses.push_back(access);
+	}
+
+	void RenderGraph::CullPasses()
+	{
+		// Walking backwards, a pass is needed when it writes a resource read by a later needed pass or an output.
+		// Writes may be partial, so resources stay needed for earlier writers too.
+		std::vector<bool> neededResources(m_Resources.size());
+		for (size_t i = 0; i < m_Resources.size(); ++i)
+		{
+			neededResources[i] = m_Resources[i].m_Output;
+		}
+
+		for (size_t i = m_Passes.size(); i > 0; --i)
+		{
+			Pass &pass = m_Passes[i - 1];
+			pass.m_Culled = true;
+			for (auto &access : pass.m_Accesses)
+			{
+				if (access.m_Write && neededResources[access.m_Resource])
+				{
+					pass.m_Culled = false;
+					break;
+				}
+			}
+
+			if (!pass.m_Culled)
+			{
+				for (auto &access : pass.m_Accesses)
+				{
+					neededResources[access.m_Resource] = true;
+				}
+			}
+		}
+	}
+
+	void RenderGraph::OrderPasses()
+	{
+		// Dependencies follow the declaration order: reads after the last write, writes after the last write and all reads since it
+		std::vector<std::vector<uint32_t>> successors(m_Passes.size());
+		std::vector<uint32_t> predecessorsCount(m_Passes.size(), 0);
+		std::vector<uint32_t> lastWriters(m_Resources.size(), InvalidIndex);
+		std::vector<std::vector<uint32_t>> readersSinceWrite(m_Resources.size());
+
+		auto addDependency = [&](uint32_t from, uint32_t to)
+		{
+			if ((InvalidIndex != from) && (from != to))
+			{
+				successors[from].push_back(to);
+				++predecessorsCount[to];
+			}
+		};
+
+		for (uint32_t pass = 0; pass < m_Passes.size(); ++pass)
+		{
+			if (m_Passes[pass].m_Culled)
+			{
+				continue;
+			}
+
+			for (auto &access : m_Passes[pass].m_Accesses)
+			{
+				addDependency(lastWriters[access.m_Resource], pass);
+				if (access.m_Write)
+				{
+					for (auto reader : readersSinceWrite[access.m_Resource])
+					{
+						addDependency(reader, pass);
+					}
+					readersSinceWrite[access.m_Resource].clear();
+					lastWriters[access.m_Resource] = pass;
+				}
+				else
+				{
+					readersSinceWrite[access.m_Resource].push_back(pass);
+				}
+			}
+		}
+
+		// Among ready passes the ones executed on the queue family of the previous pass are preferred, to form fewer batches
+		std::vector<bool> scheduled(m_Passes.size(), false);
+		m_ExecutionOrder.clear();
+		uint32_t currentQueueFamily = InvalidIndex;
+		while (true)
+		{
+			uint32_t selectedPass = InvalidIndex;
+			for (uint32_t pass = 0; pass < m_Passes.size(); ++pass)
+			{
+				if (m_Passes[pass].m_Culled || scheduled[pass] || (0 != predecessorsCount[pass]))
+				{
+					continue;
+				}
+
+				if (InvalidIndex == selectedPass)
+				{
+					selectedPass = pass;
+				}
+				if (m_Passes[pass].m_QueueFamily == currentQueueFamily)
+				{
+					selectedPass = pass;
+					break;
+				}
+			}
+
+			if (InvalidIndex == selectedPass)
+			{
+				break;
+			}
+
+			scheduled[selectedPass] = true;
+			currentQueueFamily = m_Passes[selectedPass].m_QueueFamily;
+			m_ExecutionOrder.push_back(selectedPass);
+			for (auto successor : successors[selectedPass])
+			{
+				--predecessorsCount[successor];
+			}
+		}
+	}
+
+	bool RenderGraph::AllocateTransientImages(VkDevice logicalDevice, TransientAttachmentPool *attachmentPool, uint32_t frameIndex)
+	{
+		std::vector<uint32_t> attachmentIndices(m_Resources.size(), InvalidIndex);
+		if (nullptr != attachmentPool)
+		{
+			attachmentPool->BeginFrame(frameIndex);
+		}
+
+		for (uint32_t i = 0; i < m_Resources.size(); ++i)
+		{
+			Resource const &resource = m_Resources[i];
+			if (!resource.m_Transient || (InvalidIndex == resource.m_FirstUse))
+			{
+				continue;
+			}
+
+			if (nullptr == attachmentPool)
+			{
+				std::cout << "Could not allocate transient images of a render graph without an attachment pool." << std::endl;
+				return false;
+			}
+			attachmentIndices[i] = attachmentPool->RequestAttachment(resource.m_Description, resource.m_FirstUse, resource.m_LastUse);
+		}
+
+		if (nullptr == attachmentPool)
+		{
+			return true;
+		}
+
+		if (!attachmentPool->EndFrame(logicalDevice))
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < m_Resources.size(); ++i)
+		{
+			if (InvalidIndex != attachmentIndices[i])
+			{
+				m_Resources[i].m_Image = attachmentPool->GetImage(frameIndex, attachmentIndices[i]);
+				m_Resources[i].m_ImageView = attachmentPool->GetImageView(frameIndex, attachmentIndices[i]);
+			}
+		}
+		return true;
+	}
+
+	void RenderGraph::PlaceBarriers()
+	{
+		std::vector<ResourceState> states(m_Resources.size());
+		for (size_t i = 0; i < m_Resources.size(); ++i)
+		{
+			Resource const &resource = m_Resources[i];
+			bool written = IsWriteAccess(resource.m_CurrentAccess);
+			states[i] =
+			{
+				resource.m_CurrentLayout,
+				resource.m_CurrentQueueFamily,
+				written ? resource.m_CurrentStages : 0,
+				written ? resource.m_CurrentAccess : 0,
+				written ? 0 : resource.m_CurrentStages,
+				0,
+				0,
+				InvalidIndex
+			};
+		}
+
+		auto addTransition = [](Barriers &barriers, Resource const &resource, VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages,
+			VkAccessFlags currentAccess, VkAccessFlags newAccess, VkImageLayout currentLayout, VkImageLayout newLayout, uint32_t currentQueueFamily,
+			uint32_t newQueueFamily)
+		{
+			if (0 == generatingStages)
+			{
+				generatingStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			}
+
+			if (resource.m_IsImage)
+			{
+				barriers.m_ImageBarriers.push_back({ generatingStages, consumingStages, { resource.m_Image, currentAccess, newAccess, currentLayout, newLayout,
+					currentQueueFamily, newQueueFamily, resource.m_Aspect } });
+			}
+			else
+			{
+				barriers.m_BufferBarriers.push_back({ generatingStages, consumingStages, { resource.m_Buffer, currentAccess, newAccess, currentQueueFamily,
+					newQueueFamily } });
+			}
+		};
+
+		m_PassBarriers.assign(m_ExecutionOrder.size(), Barriers());
+		for (uint32_t batchIndex = 0; batchIndex < m_Batches.size(); ++batchIndex)
+		{
+			Batch &batch = m_Batches[batchIndex];
+
+			// Transient images which are no longer used, their memory may be reused by images used for the first time
+			VkPipelineStageFlags retiredStages = 0;
+			VkAccessFlags retiredAccess = 0;
+
+			for (uint32_t position = batch.m_FirstPass; position < batch.m_FirstPass + batch.m_PassesCount; ++position)
+			{
+				Pass const &pass = m_Passes[m_ExecutionOrder[position]];
+				Barriers &barriers = m_PassBarriers[position];
+
+				for (auto &access : pass.m_Accesses)
+				{
+					Resource const &resource = m_Resources[access.m_Resource];
+					ResourceState &state = states[access.m_Resource];
+					batch.m_WaitStages |= access.m_Stages;
+
+					// Render passes starting from the undefined layout accept any layout, so a barrier only needs some defined one
+					bool discard = resource.m_IsImage && (VK_IMAGE_LAYOUT_UNDEFINED == access.m_Layout);
+					VkImageLayout currentLayout = discard ? VK_IMAGE_LAYOUT_UNDEFINED : state.m_Layout;
+					VkImageLayout newLayout = discard ? access.m_LayoutAfterPass : access.m_Layout;
+					bool layoutChange = resource.m_IsImage && !discard && (access.m_Layout != state.m_Layout);
+					// Ownership of undefined contents doesn't need to be transferred
+					bool queueFamilyChange = !discard && (!resource.m_IsImage || (VK_IMAGE_LAYOUT_UNDEFINED != state.m_Layout)) &&
+						(VK_QUEUE_FAMILY_IGNORED != state.m_QueueFamily) && (pass.m_QueueFamily != state.m_QueueFamily);
+					VkPipelineStageFlags previousStages = state.m_WriteStages | state.m_ReadStages;
+					bool barrier = false;
+
+					if (queueFamilyChange)
+					{
+						// Released at the end of the batch which used the resource last, acquired before this pass
+						if (InvalidIndex != state.m_LastBatch)
+						{
+							addTransition(m_Batches[state.m_LastBatch].m_FinalBarriers, resource, previousStages, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+								state.m_WriteAccess, 0, currentLayout, newLayout, state.m_QueueFamily, pass.m_QueueFamily);
+						}
+
+						addTransition(barriers, resource, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, access.m_Stages, 0, access.m_Access, currentLayout, newLayout,
+							state.m_QueueFamily, pass.m_QueueFamily);
+					}
+					else
+					{
+						VkPipelineStageFlags generatingStages = 0;
+						VkAccessFlags currentAccess = 0;
+						if (layoutChange || (access.m_Write && (0 != previousStages)))
+						{
+							barrier = true;
+							generatingStages = previousStages;
+							currentAccess = state.m_WriteAccess;
+						}
+						else if (!access.m_Write && (0 != state.m_WriteStages) &&
+							((0 != (access.m_Stages & ~state.m_VisibleStages)) || (0 != (access.m_Access & ~state.m_VisibleAccess))))
+						{
+							barrier = true;
+							generatingStages = state.m_WriteStages;
+							currentAccess = state.m_WriteAccess;
+						}
+
+						if (resource.m_Transient && (position == resource.m_FirstUse) && (0 != retiredStages))
+						{
+							barrier = true;
+							generatingStages |= retiredStages;
+							currentAccess |= retiredAccess;
+						}
+
+						if (barrier)
+						{
+							addTransition(barriers, resource, generatingStages, access.m_Stages, currentAccess, access.m_Access, currentLayout, newLayout,
+								VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED);
+						}
+					}
+
+					if (access.m_Write)
+					{
+						state.m_WriteStages = access.m_Stages;
+						state.m_WriteAccess = access.m_Access;
+						state.m_ReadStages = 0;
+						state.m_VisibleStages = 0;
+						state.m_VisibleAccess = 0;
+					}
+					else if (layoutChange || queueFamilyChange)
+					{
+						// Later accesses must wait for the transition, which is already visible to this one
+						state.m_WriteStages = access.m_Stages;
+						state.m_WriteAccess = 0;
+						state.m_ReadStages = access.m_Stages;
+						state.m_VisibleStages = access.m_Stages;
+						state.m_VisibleAccess = access.m_Access;
+					}
+					else
+					{
+						state.m_ReadStages |= access.m_Stages;
+						if (barrier)
+						{
+							state.m_VisibleStages |= access.m_Stages;
+							state.m_VisibleAccess |= access.m_Access;
+						}
+					}
+
+					if (resource.m_IsImage)
+					{
+						state.m_Layout = access.m_LayoutAfterPass;
+					}
+					state.m_QueueFamily = pass.m_QueueFamily;
+					state.m_LastBatch = batchIndex;
+				}
+
+				for (auto &access : pass.m_Accesses)
+				{
+					Resource const &resource = m_Resources[access.m_Resource];
+					if (resource.m_Transient && (position == resource.m_LastUse))
+					{
+						retiredStages |= states[access.m_Resource].m_WriteStages | states[access.m_Resource].m_ReadStages;
+						retiredAccess |= states[access.m_Resource].m_WriteAccess;
+					}
+				}
+			}
+		}
+
+		for (size_t i = 0; i < m_Resources.size(); ++i)
+		{
+			Resource const &resource = m_Resources[i];
+			ResourceState const &state = states[i];
+			if (resource.m_Transient || (InvalidIndex == state.m_LastBatch))
+			{
+				continue;
+			}
+
+			VkImageLayout finalLayout = (resource.m_IsImage && (VK_IMAGE_LAYOUT_UNDEFINED != resource.m_FinalLayout)) ? resource.m_FinalLayout : state.m_Layout;
+			bool queueFamilyChange = (VK_QUEUE_FAMILY_IGNORED != resource.m_FinalQueueFamily) && (VK_QUEUE_FAMILY_IGNORED != state.m_QueueFamily) &&
+				(resource.m_FinalQueueFamily != state.m_QueueFamily);
+			if ((finalLayout == state.m_Layout) && !queueFamilyChange)
+			{
+				continue;
+			}
+
+			addTransition(m_Batches[state.m_LastBatch].m_FinalBarriers, resource, state.m_WriteStages | state.m_ReadStages, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+				state.m_WriteAccess, 0, state.m_Layout, finalLayout, queueFamilyChange ? state.m_QueueFamily : VK_QUEUE_FAMILY_IGNORED,
+				queueFamilyChange ? resource.m_FinalQueueFamily : VK_QUEUE_FAMILY_IGNORED);
+		}
+	}
+
+	void RenderGraph::RecordBarriers(BarrierBatcher &barrierBatcher, Barriers const &barriers) const
+	{
+		for (auto &bufferBarrier : barriers.m_BufferBarriers)
+		{
+			barrierBatcher.AddBufferBarrier(bufferBarrier.m_GeneratingStages, bufferBarrier.m_ConsumingStages, bufferBarrier.m_Transition);
+		}
+
+		for (auto &imageBarrier : barriers.m_ImageBarriers)
+		{
+			barrierBatcher.AddImageBarrier(imageBarrier.m_GeneratingStages, imageBarrier.m_ConsumingStages, imageBarrier.m_Transition);
+		}
+	}
+}
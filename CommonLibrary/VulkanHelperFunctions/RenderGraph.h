@@ -0,0 +1,139 @@
+#pragma once
+#include "../CommonFiles/Common.h"
+#include "ResourcesAndMemoryFunctions.h"
+#include "TransientAttachmentPool.h"
+#include "BarrierBatcher.h"
+
+namespace VulkanSampleFramework
+{
+	// Frame described as passes declaring how they access buffers and images. Compilation culls passes which don't contribute to output
+	// resources, orders the remaining ones (keeping passes of the same queue family together) and derives all barriers between them:
+	// memory dependencies, layout transitions and queue family ownership transfers. Transient images live only between their first and
+	// last pass, so they are allocated from a transient attachment pool and may share memory.
+	// Consecutive passes of the same queue family form a batch, which is recorded into a single command buffer. Batches must be submitted
+	// in order, each one waiting (in its wait stages) for a semaphore signaled by the previous one when they are executed on different queues.
+	// The graph is meant to be built again every frame.
+	class RenderGraph
+	{
+	public:
+		// Current state describes the last access before the graph, final layout and queue family (VK_IMAGE_LAYOUT_UNDEFINED and
+		// VK_QUEUE_FAMILY_IGNORED keep the last ones) are set at the end of the batch which used the resource last. Only output resources
+		// keep their writers alive. Ownership of resources imported in a different queue family must have been released by its owner.
+		uint32_t ImportBuffer(VkBuffer buffer, VkAccessFlags currentAccess, VkPipelineStageFlags currentStages, uint32_t currentQueueFamily,
+			uint32_t finalQueueFamily, bool output);
+		uint32_t ImportImage(VkImage image, VkImageAspectFlags aspect, VkImageLayout currentLayout, VkAccessFlags currentAccess, VkPipelineStageFlags currentStages,
+			uint32_t currentQueueFamily, VkImageLayout finalLayout, uint32_t finalQueueFamily, bool output);
+		// Contents are undefined before the first pass using the image
+		uint32_t CreateImage(AttachmentDescription const &description);
+
+		// Record function is called only for passes which weren't culled, after all barriers preceding the pass are recorded
+		uint32_t AddPass(char const *name, uint32_t queueFamily, std::function<bool(VkCommandBuffer)> recordFunction);
+		void ReadBuffer(uint32_t pass, uint32_t buffer, VkAccessFlags access, VkPipelineStageFlags stages);
+		void WriteBuffer(uint32_t pass, uint32_t buffer, VkAccessFlags access, VkPipelineStageFlags stages);
+		void ReadImage(uint32_t pass, uint32_t image, VkImageLayout layout, VkAccessFlags access, VkPipelineStageFlags stages);
+		void WriteImage(uint32_t pass, uint32_t image, VkImageLayout layout, VkAccessFlags access, VkPipelineStageFlags stages);
+		// Render passes transition their attachments themselves, from the initial layout of the attachment description (undefined one
+		// discards previous contents, so no transition is needed before the pass) to its final layout
+		void WriteRenderPassAttachment(uint32_t pass, uint32_t image, VkImageLayout initialLayout, VkImageLayout finalLayout, VkAccessFlags access,
+			VkPipelineStageFlags stages);
+
+		// Attachment pool is needed only for transient images, it must not be used for other attachments of the same frame
+		bool Compile(VkDevice logicalDevice, TransientAttachmentPool *attachmentPool, uint32_t frameIndex);
+		uint32_t GetBatchesCount() const;
+		uint32_t GetBatchQueueFamily(uint32_t batch) const;
+		VkPipelineStageFlags GetBatchWaitStages(uint32_t batch) const;
+		// Barriers preceding each pass are flushed through the batcher as a single pipeline barrier
+		bool RecordBatch(uint32_t batch, VkCommandBuffer commandBuffer, BarrierBatcher &barrierBatcher) const;
+
+		bool IsPassCulled(uint32_t pass) const;
+		VkImage GetImage(uint32_t image) const;
+		// Available only for transient images
+		VkImageView GetImageView(uint32_t image) const;
+
+		void Reset();
+
+		RenderGraph();
+
+	private:
+		struct Resource
+		{
+			bool					m_IsImage;
+			bool					m_Transient;
+			bool					m_Output;
+			VkBuffer				m_Buffer;
+			VkImage					m_Image;
+			VkImageView				m_ImageView;
+			VkImageAspectFlags		m_Aspect;
+			AttachmentDescription	m_Description;
+			VkImageLayout			m_CurrentLayout;
+			VkAccessFlags			m_CurrentAccess;
+			VkPipelineStageFlags	m_CurrentStages;
+			uint32_t				m_CurrentQueueFamily;
+			VkImageLayout			m_FinalLayout;
+			uint32_t				m_FinalQueueFamily;
+			uint32_t				m_FirstUse;			// Positions in the execution order
+			uint32_t				m_LastUse;
+		};
+
+		struct Access
+		{
+			uint32_t				m_Resource;
+			bool					m_Write;
+			VkAccessFlags			m_Access;
+			VkPipelineStageFlags	m_Stages;
+			VkImageLayout			m_Layout;			// Undefined one means that contents are discarded and no transition is needed
+			VkImageLayout			m_LayoutAfterPass;
+		};
+
+		struct Pass
+		{
+			std::string								m_Name;
+			uint32_t								m_QueueFamily;
+			std::function<bool(VkCommandBuffer)>	m_RecordFunction;
+			std::vector<Access>						m_Accesses;
+			bool									m_Culled;
+		};
+
+		struct BufferBarrier
+		{
+			VkPipelineStageFlags	m_GeneratingStages;
+			VkPipelineStageFlags	m_ConsumingStages;
+			BufferTransition		m_Transition;
+		};
+
+		struct ImageBarrier
+		{
+			VkPipelineStageFlags	m_GeneratingStages;
+			VkPipelineStageFlags	m_ConsumingStages;
+			ImageTransition			m_Transition;
+		};
+
+		struct Barriers
+		{
+			std::vector<BufferBarrier>	m_BufferBarriers;
+			std::vector<ImageBarrier>	m_ImageBarriers;
+		};
+
+		struct Batch
+		{
+			uint32_t				m_QueueFamily;
+			uint32_t				m_FirstPass;		// Index into the execution order
+			uint32_t				m_PassesCount;
+			VkPipelineStageFlags	m_WaitStages;
+			Barriers				m_FinalBarriers;	// Ownership releases and final layouts of resources last used in the batch
+		};
+
+		void AddAccess(uint32_t pass, Access const &access);
+		void CullPasses();
+		void OrderPasses();
+		bool AllocateTransientImages(VkDevice logicalDevice, TransientAttachmentPool *attachmentPool, uint32_t frameIndex);
+		void PlaceBarriers();
+		void RecordBarriers(BarrierBatcher &barrierBatcher, Barriers const &barriers) const;
+
+		std::vector<Resource>	m_Resources;
+		std::vector<Pass>		m_Passes;
+		std::vector<uint32_t>	m_ExecutionOrder;
+		std::vector<Barriers>	m_PassBarriers;		// Recorded before the pass at the same position of the execution order
+		std::vector<Batch>		m_Batches;
+	};
+}
@@ -0,0 +1,436 @@
+#include "ResourceStateTracker.h"
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		VkAccessFlags const WriteAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+			VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+		DeviceRegistry<ResourceStateTracker> ResourceStateTrackers;
+	}
+
+	bool IsWriteAccess(VkAccessFlags access)
+	{
+		return 0 != (access & WriteAccessMask);
+	}
+
+	bool IsReadAccess(VkAccessFlags access)
+	{
+		return 0 != (access & ~WriteAccessMask);
+	}
+
+	bool ResourceStateTracker::State::operator==(State const &other) const
+	{
+		return (m_Layout == other.m_Layout) && (m_QueueFamily == other.m_QueueFamily) && (m_WriteStages == other.m_WriteStages) &&
+			(m_WriteAccess == other.m_WriteAccess) && (m_ReadStages == other.m_ReadStages) && (m_VisibleStages == other.m_VisibleStages) &&
+			(m_VisibleAccess == other.m_VisibleAccess);
+	}
+
+	bool ResourceStateTracker::Dependency::operator==(Dependency const &other) const
+	{
+		return (m_Needed == other.m_Needed) && (m_GeneratingStages == other.m_GeneratingStages) && (m_CurrentAccess == other.m_CurrentAccess) &&
+			(m_CurrentLayout == other.m_CurrentLayout) && (m_CurrentQueueFamily == other.m_CurrentQueueFamily) && (m_NewQueueFamily == other.m_NewQueueFamily);
+	}
+
+	ResourceStateTracker::ResourceStateTracker()
+	{
+	}
+
+	void ResourceStateTracker::RegisterImage(VkImage image, VkImageAspectFlags aspect, uint32_t mipmapsCount, uint32_t layersCount, VkImageLayout layout,
+		uint32_t queueFamily)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		State state = { layout, queueFamily, 0, 0, 0, 0, 0 };
+		m_Images[image] = { aspect, mipmapsCount, layersCount, std::vector<State>(mipmapsCount * layersCount, state) };
+	}
+
+	void ResourceStateTracker::RegisterBuffer(VkBuffer buffer, VkDeviceSize size, uint32_t queueFamily)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		State state = { VK_IMAGE_LAYOUT_UNDEFINED, queueFamily, 0, 0, 0, 0, 0 };
+		m_Buffers[buffer] = { size, { { 0, size, state } } };
+	}
+
+	void ResourceStateTracker::UnregisterImage(VkImage image)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Images.erase(image);
+	}
+
+	void ResourceStateTracker::UnregisterBuffer(VkBuffer buffer)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Buffers.erase(buffer);
+	}
+
+	bool ResourceStateTracker::IsImageTracked(VkImage image) const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Images.end() != m_Images.find(image);
+	}
+
+	bool ResourceStateTracker::IsBufferTracked(VkBuffer buffer) const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Buffers.end() != m_Buffers.find(buffer);
+	}
+
+	void ResourceStateTracker::AccessImage(BarrierBatcher &barrierBatcher, VkImage image, VkImageSubresourceRange const &range, VkImageLayout layout,
+		VkAccessFlags access, VkPipelineStageFlags stages, uint32_t queueFamily, bool discardContents)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto trackedImage = m_Images.find(image);
+		if (m_Images.end() == trackedImage)
+		{
+			return;
+		}
+
+		uint32_t levelsEnd;
+		uint32_t layersEnd;
+		ClampRange(trackedImage->second, range, levelsEnd, layersEnd);
+
+		auto addBarriers = [&](std::vector<std::pair<Dependency, VkImageSubresourceRange>> const &barriers)
+		{
+			for (auto &barrier : barriers)
+			{
+				Dependency const &dependency = barrier.first;
+				barrierBatcher.AddImageBarrier(dependency.m_GeneratingStages, stages, { image, dependency.m_CurrentAccess, access, dependency.m_CurrentLayout,
+					layout, dependency.m_CurrentQueueFamily, dependency.m_NewQueueFamily, range.aspectMask }, barrier.second);
+			}
+		};
+
+		// Layers needing the same barriers in consecutive levels share them, so e.g. a whole image in a single state is transitioned with one barrier
+		std::vector<std::pair<Dependency, VkImageSubresourceRange>> previousLevelBarriers;
+		std::vector<std::pair<Dependency, VkImageSubresourceRange>> levelBarriers;
+		for (uint32_t level = range.baseMipLevel; level < levelsEnd; ++level)
+		{
+			levelBarriers.clear();
+			for (uint32_t layer = range.baseArrayLayer; layer < layersEnd; ++layer)
+			{
+				State &state = trackedImage->second.m_Subresources[level * trackedImage->second.m_LayersCount + layer];
+				Dependency dependency = ApplyAccess(state, true, layout, access, stages, queueFamily, discardContents);
+				if (!dependency.m_Needed)
+				{
+					continue;
+				}
+
+				if (!levelBarriers.empty() && (levelBarriers.back().first == dependency) &&
+					(levelBarriers.back().second.baseArrayLayer + levelBarriers.back().second.layerCount == layer))
+				{
+					++levelBarriers.back().second.layerCount;
+				}
+				else
+				{
+					levelBarriers.push_back({ dependency, { range.aspectMask, level, 1, layer, 1 } });
+				}
+			}
+
+			bool sameBarriers = !previousLevelBarriers.empty() && (previousLevelBarriers.size() == levelBarriers.size());
+			for (size_t i = 0; sameBarriers && (i < levelBarriers.size()); ++i)
+			{
+				VkImageSubresourceRange const &previousRange = previousLevelBarriers[i].second;
+				sameBarriers = (previousLevelBarriers[i].first == levelBarriers[i].first) && (previousRange.baseMipLevel + previousRange.levelCount == level) &&
+					(previousRange.baseArrayLayer == levelBarriers[i].second.baseArrayLayer) && (previousRange.layerCount == levelBarriers[i].second.layerCount);
+			}
+
+			if (sameBarriers)
+			{
+				for (auto &barrier : previousLevelBarriers)
+				{
+					++barrier.second.levelCount;
+				}
+			}
+			else
+			{
+				addBarriers(previousLevelBarriers);
+				previousLevelBarriers.swap(levelBarriers);
+			}
+		}
+		addBarriers(previousLevelBarriers);
+	}
+
+	void ResourceStateTracker::AccessBuffer(BarrierBatcher &barrierBatcher, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, VkAccessFlags access,
+		VkPipelineStageFlags stages, uint32_t queueFamily)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto trackedBuffer = m_Buffers.find(buffer);
+		if (m_Buffers.end() == trackedBuffer)
+		{
+			return;
+		}
+
+		std::vector<BufferRange> &ranges = trackedBuffer->second.m_Ranges;
+		VkDeviceSize end = (VK_WHOLE_SIZE == size) || (offset + size > trackedBuffer->second.m_Size) ? trackedBuffer->second.m_Size : offset + size;
+		if (offset >= end)
+		{
+			return;
+		}
+
+		auto addBarrier = [&](Dependency const &dependency, VkDeviceSize barrierOffset, VkDeviceSize barrierSize)
+		{
+			barrierBatcher.AddBufferBarrier(dependency.m_GeneratingStages, stages, { buffer, dependency.m_CurrentAccess, access,
+				dependency.m_CurrentQueueFamily, dependency.m_NewQueueFamily }, barrierOffset, barrierSize);
+		};
+
+		// Adjacent ranges needing the same barrier share it
+		Dependency pendingDependency = { false, 0, 0, VK_IMAGE_LAYOUT_UNDEFINED, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED };
+		VkDeviceSize pendingOffset = 0;
+		VkDeviceSize pendingSize = 0;
+		for (size_t i = SplitBufferRanges(trackedBuffer->second, offset, end); (i < ranges.size()) && (ranges[i].m_Offset < end); ++i)
+		{
+			Dependency dependency = ApplyAccess(ranges[i].m_State, false, VK_IMAGE_LAYOUT_UNDEFINED, access, stages, queueFamily, false);
+			if (!dependency.m_Needed)
+			{
+				continue;
+			}
+
+			if (pendingDependency.m_Needed && (pendingDependency == dependency) && (pendingOffset + pendingSize == ranges[i].m_Offset))
+			{
+				pendingSize += ranges[i].m_Size;
+			}
+			else
+			{
+				if (pendingDependency.m_Needed)
+				{
+					addBarrier(pendingDependency, pendingOffset, pendingSize);
+				}
+				pendingDependency = dependency;
+				pendingOffset = ranges[i].m_Offset;
+				pendingSize = ranges[i].m_Size;
+			}
+		}
+
+		if (pendingDependency.m_Needed)
+		{
+			addBarrier(pendingDependency, pendingOffset, pendingSize);
+		}
+
+		for (size_t i = 1; i < ranges.size();)
+		{
+			if (ranges[i - 1].m_State == ranges[i].m_State)
+			{
+				ranges[i - 1].m_Size += ranges[i].m_Size;
+				ranges.erase(ranges.begin() + i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	void ResourceStateTracker::SetImageState(VkImage image, VkImageSubresourceRange const &range, VkImageLayout layout, VkAccessFlags access,
+		VkPipelineStageFlags stages, uint32_t queueFamily)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto trackedImage = m_Images.find(image);
+		if (m_Images.end() == trackedImage)
+		{
+			return;
+		}
+
+		uint32_t levelsEnd;
+		uint32_t layersEnd;
+		ClampRange(trackedImage->second, range, levelsEnd, layersEnd);
+
+		// Writes still need a barrier before the next access, while reads already waited for everything before them
+		bool write = IsWriteAccess(access);
+		for (uint32_t level = range.baseMipLevel; level < levelsEnd; ++level)
+		{
+			for (uint32_t layer = range.baseArrayLayer; layer < layersEnd; ++layer)
+			{
+				State &state = trackedImage->second.m_Subresources[level * trackedImage->second.m_LayersCount + layer];
+				state =
+				{
+					layout,
+					VK_QUEUE_FAMILY_IGNORED != queueFamily ? queueFamily : state.m_QueueFamily,
+					stages,
+					write ? access : 0,
+					write ? 0 : stages,
+					write ? 0 : stages,
+					write ? 0 : access
+				};
+			}
+		}
+	}
+
+	bool ResourceStateTracker::ValidateImageState(VkImage image, VkImageSubresourceRange const &range, VkImageLayout claimedLayout,
+		VkAccessFlags claimedAccess) const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto trackedImage = m_Images.find(image);
+		if (m_Images.end() == trackedImage)
+		{
+			return true;
+		}
+
+		uint32_t levelsEnd;
+		uint32_t layersEnd;
+		ClampRange(trackedImage->second, range, levelsEnd, layersEnd);
+
+		for (uint32_t level = range.baseMipLevel; level < levelsEnd; ++level)
+		{
+			for (uint32_t layer = range.baseArrayLayer; layer < layersEnd; ++layer)
+			{
+				State const &state = trackedImage->second.m_Subresources[level * trackedImage->second.m_LayersCount + layer];
+				if (((VK_IMAGE_LAYOUT_UNDEFINED != claimedLayout) && (claimedLayout != state.m_Layout)) || (0 != (state.m_WriteAccess & ~claimedAccess)))
+				{
+					std::cout << "Claimed state of image level " << level << " and layer " << layer << " differs from the tracked one." << std::endl;
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool ResourceStateTracker::ValidateBufferState(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, VkAccessFlags claimedAccess) const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto trackedBuffer = m_Buffers.find(buffer);
+		if (m_Buffers.end() == trackedBuffer)
+		{
+			return true;
+		}
+
+		VkDeviceSize end = (VK_WHOLE_SIZE == size) || (offset + size > trackedBuffer->second.m_Size) ? trackedBuffer->second.m_Size : offset + size;
+		for (auto &range : trackedBuffer->second.m_Ranges)
+		{
+			if ((range.m_Offset < end) && (offset < range.m_Offset + range.m_Size) && (0 != (range.m_State.m_WriteAccess & ~claimedAccess)))
+			{
+				std::cout << "Claimed state of buffer range at offset " << range.m_Offset << " differs from the tracked one." << std::endl;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	VkImageLayout ResourceStateTracker::GetImageLayout(VkImage image, uint32_t mipLevel, uint32_t arrayLayer) const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto trackedImage = m_Images.find(image);
+		if ((m_Images.end() == trackedImage) || (mipLevel >= trackedImage->second.m_MipmapsCount) || (arrayLayer >= trackedImage->second.m_LayersCount))
+		{
+			return VK_IMAGE_LAYOUT_UNDEFINED;
+		}
+		return trackedImage->second.m_Subresources[mipLevel * trackedImage->second.m_LayersCount + arrayLayer].m_Layout;
+	}
+
+	ResourceStateTracker::Dependency ResourceStateTracker::ApplyAccess(State &state, bool image, VkImageLayout layout, VkAccessFlags access,
+		VkPipelineStageFlags stages, uint32_t queueFamily, bool discardContents)
+	{
+		bool layoutChange = image && (layout != state.m_Layout);
+		// Ownership of undefined contents doesn't need to be transferred
+		bool queueFamilyChange = !discardContents && (!image || (VK_IMAGE_LAYOUT_UNDEFINED != state.m_Layout)) &&
+			(VK_QUEUE_FAMILY_IGNORED != queueFamily) && (VK_QUEUE_FAMILY_IGNORED != state.m_QueueFamily) && (queueFamily != state.m_QueueFamily);
+		bool write = IsWriteAccess(access);
+		VkPipelineStageFlags previousStages = state.m_WriteStages | state.m_ReadStages;
+
+		Dependency dependency =
+		{
+			false,
+			0,
+			state.m_WriteAccess,
+			discardContents && layoutChange ? VK_IMAGE_LAYOUT_UNDEFINED : state.m_Layout,
+			queueFamilyChange ? state.m_QueueFamily : VK_QUEUE_FAMILY_IGNORED,
+			queueFamilyChange ? queueFamily : VK_QUEUE_FAMILY_IGNORED
+		};
+
+		if (layoutChange || queueFamilyChange || (write && (0 != previousStages)))
+		{
+			dependency.m_Needed = true;
+			dependency.m_GeneratingStages = previousStages;
+		}
+		else if (!write && (0 != state.m_WriteStages) &&
+			((0 != (stages & ~state.m_VisibleStages)) || (0 != (access & ~state.m_VisibleAccess))))
+		{
+			dependency.m_Needed = true;
+			dependency.m_GeneratingStages = state.m_WriteStages;
+		}
+
+		if (dependency.m_Needed && (0 == dependency.m_GeneratingStages))
+		{
+			dependency.m_GeneratingStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		}
+
+		if (write)
+		{
+			state.m_WriteStages = stages;
+			state.m_WriteAccess = access;
+			state.m_ReadStages = 0;
+			state.m_VisibleStages = 0;
+			state.m_VisibleAccess = 0;
+		}
+		else if (layoutChange || queueFamilyChange)
+		{
+			// Later accesses must wait for the transition, which is already visible to this one
+			state.m_WriteStages = stages;
+			state.m_WriteAccess = 0;
+			state.m_ReadStages = stages;
+			state.m_VisibleStages = stages;
+			state.m_VisibleAccess = access;
+		}
+		else
+		{
+			state.m_ReadStages |= stages;
+			if (dependency.m_Needed)
+			{
+				state.m_VisibleStages |= stages;
+				state.m_VisibleAccess |= access;
+			}
+		}
+
+		if (image)
+		{
+			state.m_Layout = layout;
+		}
+		if (VK_QUEUE_FAMILY_IGNORED != queueFamily)
+		{
+			state.m_QueueFamily = queueFamily;
+		}
+		return dependency;
+	}
+
+	void ResourceStateTracker::ClampRange(TrackedImage const &trackedImage, VkImageSubresourceRange const &range, uint32_t &levelsEnd, uint32_t &layersEnd)
+	{
+		levelsEnd = (VK_REMAINING_MIP_LEVELS == range.levelCount) || (range.baseMipLevel + range.levelCount > trackedImage.m_MipmapsCount) ?
+			trackedImage.m_MipmapsCount : range.baseMipLevel + range.levelCount;
+		layersEnd = (VK_REMAINING_ARRAY_LAYERS == range.layerCount) || (range.baseArrayLayer + range.layerCount > trackedImage.m_LayersCount) ?
+			trackedImage.m_LayersCount : range.baseArrayLayer + range.layerCount;
+	}
+
+	size_t ResourceStateTracker::SplitBufferRanges(TrackedBuffer &trackedBuffer, VkDeviceSize offset, VkDeviceSize end)
+	{
+		std::vector<BufferRange> &ranges = trackedBuffer.m_Ranges;
+		for (VkDeviceSize boundary : { offset, end })
+		{
+			for (size_t i = 0; i < ranges.size(); ++i)
+			{
+				if ((ranges[i].m_Offset < boundary) && (boundary < ranges[i].m_Offset + ranges[i].m_Size))
+				{
+					BufferRange second = { boundary, ranges[i].m_Offset + ranges[i].m_Size - boundary, ranges[i].m_State };
+					ranges[i].m_Size = boundary - ranges[i].m_Offset;
+					ranges.insert(ranges.begin() + i + 1, second);
+					break;
+				}
+			}
+		}
+
+		size_t first = 0;
+		while ((first < ranges.size()) && (ranges[first].m_Offset < offset))
+		{
+			++first;
+		}
+		return first;
+	}
+
+	void SetResourceStateTracker(VkDevice logicalDevice, ResourceStateTracker *tracker)
+	{
+		ResourceStateTrackers.Set(logicalDevice, tracker);
+	}
+
+	ResourceStateTracker * GetResourceStateTracker(VkDevice logicalDevice)
+	{
+		return ResourceStateTrackers.Get(logicalDevice);
+	}
+}
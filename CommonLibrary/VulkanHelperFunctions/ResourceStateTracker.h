@@ -0,0 +1,108 @@
+#pragma once
+#include <mutex>
+#include <unordered_map>
+#include "../CommonFiles/Common.h"
+#include "BarrierBatcher.h"
+#include "DeviceRegistry.h"
+
+namespace VulkanSampleFramework
+{
+	bool IsWriteAccess(VkAccessFlags access);
+	bool IsReadAccess(VkAccessFlags access);
+
+	// Remembers the last layout, accesses and queue family of every registered image subresource (mipmap level and array layer) and buffer range,
+	// so barriers are derived from the tracked state instead of the one claimed by callers. Barriers are added only when they are needed:
+	// for layout and queue family changes, for writes after previous accesses and for reads of data not yet visible to them. States follow
+	// the recording order, so command buffers must be submitted in the same order. Claimed states may be validated in debug builds.
+	class ResourceStateTracker
+	{
+	public:
+		void RegisterImage(VkImage image, VkImageAspectFlags aspect, uint32_t mipmapsCount, uint32_t layersCount,
+			VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED, uint32_t queueFamily = VK_QUEUE_FAMILY_IGNORED);
+		void RegisterBuffer(VkBuffer buffer, VkDeviceSize size, uint32_t queueFamily = VK_QUEUE_FAMILY_IGNORED);
+		void UnregisterImage(VkImage image);
+		void UnregisterBuffer(VkBuffer buffer);
+		bool IsImageTracked(VkImage image) const;
+		bool IsBufferTracked(VkBuffer buffer) const;
+
+		// Adds barriers needed before the access to the batcher. Discarded contents are transitioned from the undefined layout and don't need
+		// an ownership transfer. Otherwise a queue family change adds the acquire half of the transfer, the same barrier must release the
+		// ownership on the previous queue.
+		void AccessImage(BarrierBatcher &barrierBatcher, VkImage image, VkImageSubresourceRange const &range, VkImageLayout layout, VkAccessFlags access,
+			VkPipelineStageFlags stages, uint32_t queueFamily = VK_QUEUE_FAMILY_IGNORED, bool discardContents = false);
+		void AccessBuffer(BarrierBatcher &barrierBatcher, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, VkAccessFlags access,
+			VkPipelineStageFlags stages, uint32_t queueFamily = VK_QUEUE_FAMILY_IGNORED);
+		// For accesses which were synchronized with their own barriers, e.g. by mipmap generation
+		void SetImageState(VkImage image, VkImageSubresourceRange const &range, VkImageLayout layout, VkAccessFlags access, VkPipelineStageFlags stages,
+			uint32_t queueFamily = VK_QUEUE_FAMILY_IGNORED);
+
+		// Reports subresources whose tracked layout or last write differs from the claimed ones, the undefined layout matches any
+		bool ValidateImageState(VkImage image, VkImageSubresourceRange const &range, VkImageLayout claimedLayout, VkAccessFlags claimedAccess) const;
+		bool ValidateBufferState(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, VkAccessFlags claimedAccess) const;
+		VkImageLayout GetImageLayout(VkImage image, uint32_t mipLevel, uint32_t arrayLayer) const;
+
+		ResourceStateTracker();
+
+	private:
+		struct State
+		{
+			VkImageLayout			m_Layout;
+			uint32_t				m_QueueFamily;
+			VkPipelineStageFlags	m_WriteStages;
+			VkAccessFlags			m_WriteAccess;
+			VkPipelineStageFlags	m_ReadStages;		// Reads since the last write
+			VkPipelineStageFlags	m_VisibleStages;	// Stages and accesses already synchronized with the last write
+			VkAccessFlags			m_VisibleAccess;
+
+			bool operator==(State const &other) const;
+		};
+
+		// Barrier needed before an access, with a state of the accessed subresources or range
+		struct Dependency
+		{
+			bool					m_Needed;
+			VkPipelineStageFlags	m_GeneratingStages;
+			VkAccessFlags			m_CurrentAccess;
+			VkImageLayout			m_CurrentLayout;
+			uint32_t				m_CurrentQueueFamily;
+			uint32_t				m_NewQueueFamily;
+
+			bool operator==(Dependency const &other) const;
+		};
+
+		struct TrackedImage
+		{
+			VkImageAspectFlags		m_Aspect;
+			uint32_t				m_MipmapsCount;
+			uint32_t				m_LayersCount;
+			std::vector<State>		m_Subresources;		// Layers of the first level, then of the next ones
+		};
+
+		struct BufferRange
+		{
+			VkDeviceSize			m_Offset;
+			VkDeviceSize			m_Size;
+			State					m_State;
+		};
+
+		struct TrackedBuffer
+		{
+			VkDeviceSize				m_Size;
+			std::vector<BufferRange>	m_Ranges;			// Sorted by offsets, covering the whole buffer
+		};
+
+		static Dependency ApplyAccess(State &state, bool image, VkImageLayout layout, VkAccessFlags access, VkPipelineStageFlags stages,
+			uint32_t queueFamily, bool discardContents);
+		static void ClampRange(TrackedImage const &trackedImage, VkImageSubresourceRange const &range, uint32_t &levelsEnd, uint32_t &layersEnd);
+		// Splits ranges so the given one starts and ends at their boundaries, returns the first range inside it
+		static size_t SplitBufferRanges(TrackedBuffer &trackedBuffer, VkDeviceSize offset, VkDeviceSize end);
+
+		std::unordered_map<VkImage, TrackedImage>		m_Images;
+		std::unordered_map<VkBuffer, TrackedBuffer>		m_Buffers;
+		mutable std::mutex								m_Mutex;
+	};
+
+	// Tracker used by the staging buffer updates, mipmap generation and resource destruction for the device, none by default
+	void SetResourceStateTracker(VkDevice logicalDevice, ResourceStateTracker *tracker);
+	ResourceStateTracker * GetResourceStateTracker(VkDevice logicalDevice);
+}
@@ -1,5 +1,9 @@
 #include "CommandBufferAndSyncFunctions.h"
 #include "ResourcesAndMemoryFunctions.h"
+#include "MemoryBudget.h"
+#include "QueueTimeline.h"
+#include "BarrierBatcher.h"
+#include "ResourceStateTracker.h"
 
 namespace VulkanSampleFramework
 {
@@ -74,12 +78,33 @@ namespace VulkanSampleFramework
 			memoryType									// uint32_t           memoryTypeIndex
 		};
 
+		// Budgets are soft limits. Reservation only gives eviction callbacks a chance to free memory, its result is advisory and the
+		// allocation is attempted even when the heap stays over budget - only the driver decides whether it fails.
+		MemoryBudgetTracker *memoryBudgetTracker = GetMemoryBudgetTracker(logicalDevice);
+		if (nullptr != memoryBudgetTracker)
+		{
+			memoryBudgetTracker->ReserveAllocation(memoryType, size);
+		}
+
 		VkResult result = vkAllocateMemory(logicalDevice, &bufferMemoryAllocateInfo, nullptr, &memoryObject);
+		for (uint32_t retry = 0; (VK_SUCCESS != result) && (nullptr != memoryBudgetTracker) && (retry < MemoryBudgetTracker::MaxEvictionRounds); ++retry)
+		{
+			if (!memoryBudgetTracker->EvictAfterFailedAllocation(memoryType, size))
+			{
+				break;
+			}
+			result = vkAllocateMemory(logicalDevice, &bufferMemoryAllocateInfo, nullptr, &memoryObject);
+		}
 		if (VK_SUCCESS != result)
 		{
 			std::cout << "Could not allocate memory object." << std::endl;
 			return false;
 		}
+
+		if (nullptr != memoryBudgetTracker)
+		{
+			memoryBudgetTracker->RecordAllocation(memoryObject, memoryType, size);
+		}
 		return true;
 	}
 
@@ -95,7 +120,7 @@ namespace VulkanSampleFramework
 	}
 
 	void SetBufferMemoryBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages,
-		std::vector<BufferTransition> bufferTransitions)
+		std::vector<BufferTransition> const &bufferTransitions)
 	{
 		std::vector<VkBufferMemoryBarrier> bufferMemoryBarriers;
 
@@ -136,16 +161,7 @@ namespace VulkanSampleFramework
 			return false;
 		}
 
-		VkMemoryAllocateInfo bufferMemoryAllocateInfo =
-		{
-			VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,			// VkStructureType    sType
-			nullptr,										// const void       * pNext
-			memoryRequirements.size,						// VkDeviceSize       allocationSize
-			memoryType                                      // uint32_t           memoryTypeIndex
-		};
-
-		vkAllocateMemory(logicalDevice, &bufferMemoryAllocateInfo, nullptr, &memoryObject);
-		if (VK_NULL_HANDLE == memoryObject)
+		if (!AllocateMemoryObject(logicalDevice, memoryRequirements.size, memoryType, memoryObject))
 		{
 			return false;
 		}
@@ -255,7 +271,7 @@ namespace VulkanSampleFramework
 	}
 
 	void SetImageMemoryBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages,
-		std::vector<ImageTransition> imageTransitions)
+		std::vector<ImageTransition> const &imageTransitions)
 	{
 		std::vector<VkImageMemoryBarrier> imageMemoryBarriers;
 
@@ -381,6 +397,11 @@ namespace VulkanSampleFramework
 		}
 	}
 
+	void FillBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data)
+	{
+		vkCmdFillBuffer(commandBuffer, buffer, offset, size, data);
+	}
+
 	void CopyDataFromBufferToImage(VkCommandBuffer commandBuffer, VkBuffer sourceBuffer, VkImage destinationImage, VkImageLayout imageLayout,
 		std::vector<VkBufferImageCopy> regions)
 	{
@@ -441,37 +462,51 @@ namespace VulkanSampleFramework
 			return false;
 		}
 
-		SetBufferMemoryBarrier(commandBuffer, destinationBufferGeneratingStages, VK_PIPELINE_STAGE_TRANSFER_BIT,
-			{ {destinationBuffer, destinationBufferCurrentAccess, VK_ACCESS_TRANSFER_WRITE_BIT, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED} });
-
-		CopyDataBetweenBuffers(commandBuffer, stagingBuffer, destinationBuffer, { {0, destinationOffset, dataSize} });
+		// Tracked buffers get barriers derived from their tracked state, the claimed one is only validated
+		ResourceStateTracker *stateTracker = GetResourceStateTracker(logicalDevice);
+		if ((nullptr != stateTracker) && stateTracker->IsBufferTracked(destinationBuffer))
+		{
+#ifdef _DEBUG
+			stateTracker->ValidateBufferState(destinationBuffer, destinationOffset, dataSize, destinationBufferCurrentAccess);
+#endif
+			BarrierBatcher barrierBatcher;
+			barrierBatcher.Initialize(false);
+			stateTracker->AccessBuffer(barrierBatcher, destinationBuffer, destinationOffset, dataSize, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+			barrierBatcher.Flush(commandBuffer);
 
-		SetBufferMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, destinationBufferConsumingStages,
-			{ {destinationBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, destinationBufferNewAccess, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED} });
+			CopyDataBetweenBuffers(commandBuffer, stagingBuffer, destinationBuffer, { {0, destinationOffset, dataSize} });
 
-		if (!EndCommandBufferRecordingOperation(commandBuffer))
-		{
-			return false;
+			// Later writes are synchronized when they are recorded, so only reads need a barrier now
+			if (IsReadAccess(destinationBufferNewAccess))
+			{
+				stateTracker->AccessBuffer(barrierBatcher, destinationBuffer, destinationOffset, dataSize, destinationBufferNewAccess,
+					destinationBufferConsumingStages);
+				barrierBatcher.Flush(commandBuffer);
+			}
 		}
+		else
+		{
+			SetBufferMemoryBarrier(commandBuffer, destinationBufferGeneratingStages, VK_PIPELINE_STAGE_TRANSFER_BIT,
+				{ {destinationBuffer, destinationBufferCurrentAccess, VK_ACCESS_TRANSFER_WRITE_BIT, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED} });
 
-		VkFence fence;
-		if (!CreateFence(logicalDevice, false, fence)) {
-			return false;
+			CopyDataBetweenBuffers(commandBuffer, stagingBuffer, destinationBuffer, { {0, destinationOffset, dataSize} });
+
+			SetBufferMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, destinationBufferConsumingStages,
+				{ {destinationBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, destinationBufferNewAccess, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED} });
 		}
 
-		if (!SubmitCommandBuffersToQueue(queue, {}, { commandBuffer }, signalSemaphores, fence))
+		if (!EndCommandBufferRecordingOperation(commandBuffer))
 		{
 			return false;
 		}
 
-		if (!WaitForFences(logicalDevice, { fence }, VK_FALSE, 200000000))
+		if (!SubmitCommandBuffersAndWait(logicalDevice, queue, { commandBuffer }, signalSemaphores, 200000000))
 		{
 			return false;
 		}
 
 		FreeMemoryObject(logicalDevice, memoryObject);
 		DestroyBuffer(logicalDevice, stagingBuffer);
-		DestroyFence(logicalDevice, fence);
 
 		return true;
 	}
@@ -482,6 +517,28 @@ namespace VulkanSampleFramework
 		VkAccessFlags destinationImageNewAccess, VkImageAspectFlags destinationImageAspect, VkPipelineStageFlags destinationImageGeneratingStages,
 		VkPipelineStageFlags destinationImageConsumingStages, VkQueue queue, VkCommandBuffer commandBuffer, std::vector<VkSemaphore> signalSemaphores,
 		VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties)
+	{
+		return UseStagingBufferToUpdateImageRegionsWithDeviceLocalMemoryBound(logicalDevice, dataSize, data, destinationImage,
+			{
+				{
+					0,											// VkDeviceSize               bufferOffset
+					0,											// uint32_t                   bufferRowLength
+					0,											// uint32_t                   bufferImageHeight
+					destinationImageSubresource,				// VkImageSubresourceLayers   imageSubresource
+					destinationImageOffset,						// VkOffset3D                 imageOffset
+					destinationImageSize,						// VkExtent3D                 imageExtent
+				}
+			},
+			destinationImageCurrentLayout, destinationImageNewLayout, destinationImageCurrentAccess, destinationImageNewAccess, destinationImageAspect,
+			destinationImageGeneratingStages, destinationImageConsumingStages, queue, commandBuffer, signalSemaphores, physicalDeviceMemoryProperties);
+	}
+
+	bool UseStagingBufferToUpdateImageRegionsWithDeviceLocalMemoryBound(VkDevice logicalDevice, VkDeviceSize dataSize, void *data,
+		VkImage destinationImage, std::vector<VkBufferImageCopy> const &regions, VkImageLayout destinationImageCurrentLayout,
+		VkImageLayout destinationImageNewLayout, VkAccessFlags destinationImageCurrentAccess, VkAccessFlags destinationImageNewAccess,
+		VkImageAspectFlags destinationImageAspect, VkPipelineStageFlags destinationImageGeneratingStages,
+		VkPipelineStageFlags destinationImageConsumingStages, VkQueue queue, VkCommandBuffer commandBuffer, std::vector<VkSemaphore> signalSemaphores,
+		VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties)
 	{
 		VkBuffer stagingBuffer;
 		if (!CreateBuffer(logicalDevice, dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, stagingBuffer))
@@ -520,70 +577,84 @@ namespace VulkanSampleFramework
 			return false;
 		}
 
-		SetImageMemoryBarrier(commandBuffer, destinationImageGeneratingStages, VK_PIPELINE_STAGE_TRANSFER_BIT,
-			{
-				{
-					destinationImage,							// VkImage            Image
-					destinationImageCurrentAccess,				// VkAccessFlags      CurrentAccess
-					VK_ACCESS_TRANSFER_WRITE_BIT,				// VkAccessFlags      NewAccess
-					destinationImageCurrentLayout,				// VkImageLayout      CurrentLayout
-					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,		// VkImageLayout      NewLayout
-					VK_QUEUE_FAMILY_IGNORED,					// uint32_t           CurrentQueueFamily
-					VK_QUEUE_FAMILY_IGNORED,					// uint32_t           NewQueueFamily
-					destinationImageAspect						// VkImageAspectFlags Aspect
-				} 
-			});
-
-		CopyDataFromBufferToImage(commandBuffer, stagingBuffer, destinationImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		// Tracked images get barriers derived from the tracked state of the updated subresources only, the claimed state is just validated, so
+		// other subresources keep their contents
+		ResourceStateTracker *stateTracker = GetResourceStateTracker(logicalDevice);
+		if ((nullptr != stateTracker) && stateTracker->IsImageTracked(destinationImage))
+		{
+			BarrierBatcher barrierBatcher;
+			barrierBatcher.Initialize(false);
+			for (auto &region : regions)
 			{
-				{
-					0,											// VkDeviceSize               bufferOffset
-					0,											// uint32_t                   bufferRowLength
-					0,											// uint32_t                   bufferImageHeight
-					destinationImageSubresource,				// VkImageSubresourceLayers   imageSubresource
-					destinationImageOffset,						// VkOffset3D                 imageOffset
-					destinationImageSize,						// VkExtent3D                 imageExtent
-				} 
-			});
+				VkImageSubresourceRange range = { region.imageSubresource.aspectMask, region.imageSubresource.mipLevel, 1,
+					region.imageSubresource.baseArrayLayer, region.imageSubresource.layerCount };
+#ifdef _DEBUG
+				stateTracker->ValidateImageState(destinationImage, range, destinationImageCurrentLayout, destinationImageCurrentAccess);
+#endif
+				stateTracker->AccessImage(barrierBatcher, destinationImage, range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT,
+					VK_PIPELINE_STAGE_TRANSFER_BIT);
+			}
+			barrierBatcher.Flush(commandBuffer);
 
-		SetImageMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, destinationImageConsumingStages,
+			CopyDataFromBufferToImage(commandBuffer, stagingBuffer, destinationImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions);
+
+			// Later writes in the same layout are synchronized when they are recorded, so e.g. further uploads don't need a barrier now
+			if ((VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL != destinationImageNewLayout) || IsReadAccess(destinationImageNewAccess))
 			{
+				for (auto &region : regions)
 				{
-					destinationImage,							// VkImage            Image
-					VK_ACCESS_TRANSFER_WRITE_BIT,				// VkAccessFlags      CurrentAccess
-					destinationImageNewAccess,					// VkAccessFlags      NewAccess
-					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,		// VkImageLayout      CurrentLayout
-					destinationImageNewLayout,					// VkImageLayout      NewLayout
-					VK_QUEUE_FAMILY_IGNORED,					// uint32_t           CurrentQueueFamily
-					VK_QUEUE_FAMILY_IGNORED,					// uint32_t           NewQueueFamily
-					destinationImageAspect						// VkImageAspectFlags Aspect
-				} 
-			});
-
-		if (!EndCommandBufferRecordingOperation(commandBuffer))
-		{
-			return false;
+					stateTracker->AccessImage(barrierBatcher, destinationImage, { region.imageSubresource.aspectMask, region.imageSubresource.mipLevel, 1,
+						region.imageSubresource.baseArrayLayer, region.imageSubresource.layerCount }, destinationImageNewLayout, destinationImageNewAccess,
+						destinationImageConsumingStages);
+				}
+				barrierBatcher.Flush(commandBuffer);
+			}
 		}
-
-		VkFence fence;
-		if (!CreateFence(logicalDevice, false, fence))
+		else
 		{
-			return false;
+			SetImageMemoryBarrier(commandBuffer, destinationImageGeneratingStages, VK_PIPELINE_STAGE_TRANSFER_BIT,
+				{
+					{
+						destinationImage,							// VkImage            Image
+						destinationImageCurrentAccess,				// VkAccessFlags      CurrentAccess
+						VK_ACCESS_TRANSFER_WRITE_BIT,				// VkAccessFlags      NewAccess
+						destinationImageCurrentLayout,				// VkImageLayout      CurrentLayout
+						VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,		// VkImageLayout      NewLayout
+						VK_QUEUE_FAMILY_IGNORED,					// uint32_t           CurrentQueueFamily
+						VK_QUEUE_FAMILY_IGNORED,					// uint32_t           NewQueueFamily
+						destinationImageAspect						// VkImageAspectFlags Aspect
+					} 
+				});
+
+			CopyDataFromBufferToImage(commandBuffer, stagingBuffer, destinationImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions);
+
+			SetImageMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, destinationImageConsumingStages,
+				{
+					{
+						destinationImage,							// VkImage            Image
+						VK_ACCESS_TRANSFER_WRITE_BIT,				// VkAccessFlags      CurrentAccess
+						destinationImageNewAccess,					// VkAccessFlags      NewAccess
+						VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,		// VkImageLayout      CurrentLayout
+						destinationImageNewLayout,					// VkImageLayout      NewLayout
+						VK_QUEUE_FAMILY_IGNORED,					// uint32_t           CurrentQueueFamily
+						VK_QUEUE_FAMILY_IGNORED,					// uint32_t           NewQueueFamily
+						destinationImageAspect						// VkImageAspectFlags Aspect
+					} 
+				});
 		}
 
-		if (!SubmitCommandBuffersToQueue(queue, {}, { commandBuffer }, signalSemaphores, fence))
+		if (!EndCommandBufferRecordingOperation(commandBuffer))
 		{
 			return false;
 		}
 
-		if (!WaitForFences(logicalDevice, {fence}, VK_FALSE, 500000000))
+		if (!SubmitCommandBuffersAndWait(logicalDevice, queue, { commandBuffer }, signalSemaphores, 500000000))
 		{
 			return false;
 		}
 
 		FreeMemoryObject(logicalDevice, memoryObject);
 		DestroyBuffer(logicalDevice, stagingBuffer);
-		DestroyFence(logicalDevice, fence);
 
 		return true;
 	}
@@ -601,6 +672,11 @@ namespace VulkanSampleFramework
 	{
 		if (VK_NULL_HANDLE != image)
 		{
+			ResourceStateTracker *stateTracker = GetResourceStateTracker(logicalDevice);
+			if (nullptr != stateTracker)
+			{
+				stateTracker->UnregisterImage(image);
+			}
 			vkDestroyImage(logicalDevice, image, nullptr);
 			image = VK_NULL_HANDLE;
 		}
@@ -619,6 +695,11 @@ namespace VulkanSampleFramework
 	{
 		if (VK_NULL_HANDLE != buffer)
 		{
+			ResourceStateTracker *stateTracker = GetResourceStateTracker(logicalDevice);
+			if (nullptr != stateTracker)
+			{
+				stateTracker->UnregisterBuffer(buffer);
+			}
 			vkDestroyBuffer(logicalDevice, buffer, nullptr);
 			buffer = VK_NULL_HANDLE;
 		}
@@ -628,6 +709,11 @@ namespace VulkanSampleFramework
 	{
 		if (VK_NULL_HANDLE != memoryObject)
 		{
+			MemoryBudgetTracker *memoryBudgetTracker = GetMemoryBudgetTracker(logicalDevice);
+			if (nullptr != memoryBudgetTracker)
+			{
+				memoryBudgetTracker->RecordFree(memoryObject);
+			}
 			vkFreeMemory(logicalDevice, memoryObject, nullptr);
 			memoryObject = VK_NULL_HANDLE;
 		}
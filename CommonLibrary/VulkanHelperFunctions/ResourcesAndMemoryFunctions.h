@@ -35,7 +35,7 @@ namespace VulkanSampleFramework
 	bool AllocateMemoryObject(VkDevice logicalDevice, VkDeviceSize size, uint32_t memoryType, VkDeviceMemory &memoryObject);
 	bool BindMemoryObjectToBufer(VkDevice logicalDevice, VkDeviceMemory memoryObject, VkBuffer buffer, uint32_t memoryOffset /*in bytes*/);
 	void SetBufferMemoryBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages,
-		std::vector<BufferTransition> bufferTransitions);
+		std::vector<BufferTransition> const &bufferTransitions);
 	bool AllocateAndBindMemoryObjectToBuffer(VkDevice logicalDevice, VkBuffer buffer, VkMemoryPropertyFlagBits memoryProperties,
 		VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties, VkDeviceMemory &memoryObject);
 	bool CreateBufferView(VkDevice logicalDevice, VkBuffer buffer, VkFormat format, VkDeviceSize memoryOffset, VkDeviceSize memoryRange, VkBufferView & bufferView);
@@ -45,13 +45,14 @@ namespace VulkanSampleFramework
 		VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties, VkDeviceMemory &memoryObject);
 	bool BindMemoryObjectToImage(VkDevice logicalDevice, VkImage image, VkDeviceMemory & memoryObject, uint32_t memoryOffset);
 	void SetImageMemoryBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags generatingStages, VkPipelineStageFlags consumingStages,
-		std::vector<ImageTransition> imageTransitions);
+		std::vector<ImageTransition> const &imageTransitions);
 	bool CreateImageView(VkDevice logicalDevice, VkImage image, VkImageViewType viewType, VkFormat format, VkImageAspectFlags aspect, VkImageView &imageView);
 	
 	// Now I just flush whole range of memory to update.
 	bool MapUpdateAndUnmapHostVisibleMemory(VkDevice logicalDevice, VkDeviceMemory memoryObject, VkDeviceSize offset, VkDeviceSize dataSize, void *data,
 		bool unmap, void **pointer);
 	void CopyDataBetweenBuffers(VkCommandBuffer commandBuffer, VkBuffer sourceBuffer, VkBuffer destinationBuffer, std::vector<VkBufferCopy> regions);
+	void FillBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data);
 	void CopyDataFromBufferToImage(VkCommandBuffer commandBuffer, VkBuffer sourceBuffer, VkImage destinationImage, VkImageLayout imageLayout,
 		std::vector<VkBufferImageCopy> regions);
 	void CopyDataFromImageToBuffer(VkCommandBuffer commandBuffer, VkImage sourceImage, VkImageLayout imageLayout, VkBuffer destinationBuffer,
@@ -66,6 +67,12 @@ namespace VulkanSampleFramework
 		VkAccessFlags destinationImageNewAccess, VkImageAspectFlags destinationImageAspect, VkPipelineStageFlags destinationImageGeneratingStages,
 		VkPipelineStageFlags destinationImageConsumingStages, VkQueue queue, VkCommandBuffer commandBuffer, std::vector<VkSemaphore> signalSemaphores,
 		VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties);
+	// Regions may cover several mip levels and layers, e.g. of compressed textures with a precomputed mipmap chain
+	bool UseStagingBufferToUpdateImageRegionsWithDeviceLocalMemoryBound(VkDevice logicalDevice, VkDeviceSize dataSize, void *data,
+		VkImage destinationImage, std::vector<VkBufferImageCopy> const &regions, VkImageLayout destinationImageCurrentLayout,
+		VkImageLayout destinationImageNewLayout, VkAccessFlags destinationImageCurrentAccess, VkAccessFlags destinationImageNewAccess,
+		VkImageAspectFlags destinationImageAspect, VkPipelineStageFlags destinationImageGeneratingStages, VkPipelineStageFlags destinationImageConsumingStages,
+		VkQueue queue, VkCommandBuffer commandBuffer, std::vector<VkSemaphore> signalSemaphores, VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties);
 	void DestroyImageView(VkDevice logicalDevice, VkImageView &imageView);
 	void DestroyImage(VkDevice logicalDevice, VkImage  &image);
 	void DestroyBufferView(VkDevice logicalDevice, VkBufferView & bufferView);
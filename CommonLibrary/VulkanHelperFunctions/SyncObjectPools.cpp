@@ -0,0 +1,265 @@
+#include "SyncObjectPools.h"
+#include "CommandBufferAndSyncFunctions.h"
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		DeviceRegistry<FencePool> FencePools;
+		DeviceRegistry<SemaphorePool> SemaphorePools;
+	}
+
+	FencePool::FencePool() :
+		m_CreatedCount(0),
+		m_InUseCount(0),
+		m_HighWaterMark(0)
+	{
+	}
+
+	bool FencePool::AcquireFence(VkDevice logicalDevice, VkFence &fence)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// Pending fences are checked only when they are needed
+		if (m_FreeFences.empty() && !RecycleSignaledFences(logicalDevice))
+		{
+			return false;
+		}
+
+		if (!m_FreeFences.empty())
+		{
+			fence = m_FreeFences.back();
+			m_FreeFences.pop_back();
+		}
+		else
+		{
+			if (!CreateFence(logicalDevice, false, fence))
+			{
+				return false;
+			}
+			++m_CreatedCount;
+		}
+
+		++m_InUseCount;
+		m_HighWaterMark = m_InUseCount > m_HighWaterMark ? m_InUseCount : m_HighWaterMark;
+		return true;
+	}
+
+	bool FencePool::ReleaseFence(VkDevice logicalDevice, VkFence &fence)
+	{
+		if (!ResetFences(logicalDevice, { fence }))
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_FreeFences.push_back(fence);
+		--m_InUseCount;
+		fence = VK_NULL_HANDLE;
+		return true;
+	}
+
+	void FencePool::ReleaseFenceWhenSignaled(VkFence &fence)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_PendingFences.push_back(fence);
+		fence = VK_NULL_HANDLE;
+	}
+
+	bool FencePool::Recycle(VkDevice logicalDevice)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return RecycleSignaledFences(logicalDevice);
+	}
+
+	void FencePool::Destroy(VkDevice logicalDevice)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (auto fences : { &m_FreeFences, &m_PendingFences })
+		{
+			for (auto &fence : *fences)
+			{
+				DestroyFence(logicalDevice, fence);
+			}
+			fences->clear();
+		}
+		m_CreatedCount = 0;
+		m_InUseCount = 0;
+	}
+
+	SyncObjectPoolStatistics FencePool::GetStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return { m_CreatedCount, m_InUseCount, m_HighWaterMark };
+	}
+
+	bool FencePool::RecycleSignaledFences(VkDevice logicalDevice)
+	{
+		for (size_t i = 0; i < m_PendingFences.size();)
+		{
+			VkResult result = vkGetFenceStatus(logicalDevice, m_PendingFences[i]);
+			if (VK_NOT_READY == result)
+			{
+				++i;
+				continue;
+			}
+			if ((VK_SUCCESS != result) || !ResetFences(logicalDevice, { m_PendingFences[i] }))
+			{
+				std::cout << "Could not recycle a fence." << std::endl;
+				return false;
+			}
+
+			m_FreeFences.push_back(m_PendingFences[i]);
+			m_PendingFences[i] = m_PendingFences.back();
+			m_PendingFences.pop_back();
+			--m_InUseCount;
+		}
+		return true;
+	}
+
+	SemaphorePool::SemaphorePool() :
+		m_CreatedCount(0),
+		m_InUseCount(0),
+		m_HighWaterMark(0)
+	{
+	}
+
+	bool SemaphorePool::AcquireSemaphore(VkDevice logicalDevice, VkSemaphore &semaphore)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (m_FreeSemaphores.empty() && !RecycleCompletedSemaphores(logicalDevice))
+		{
+			return false;
+		}
+
+		if (!m_FreeSemaphores.empty())
+		{
+			semaphore = m_FreeSemaphores.back();
+			m_FreeSemaphores.pop_back();
+		}
+		else
+		{
+			if (!CreateSemaphore(logicalDevice, semaphore))
+			{
+				return false;
+			}
+			++m_CreatedCount;
+		}
+
+		++m_InUseCount;
+		m_HighWaterMark = m_InUseCount > m_HighWaterMark ? m_InUseCount : m_HighWaterMark;
+		return true;
+	}
+
+	void SemaphorePool::ReleaseSemaphore(VkSemaphore &semaphore)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_FreeSemaphores.push_back(semaphore);
+		--m_InUseCount;
+		semaphore = VK_NULL_HANDLE;
+	}
+
+	void SemaphorePool::ReleaseSemaphoreWhenSignaled(VkSemaphore &semaphore, VkFence completionFence)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_PendingSemaphores.push_back({ semaphore, completionFence, { VK_NULL_HANDLE, 0 } });
+		semaphore = VK_NULL_HANDLE;
+	}
+
+	void SemaphorePool::ReleaseSemaphoreWhenReached(VkSemaphore &semaphore, TimelinePoint const &completionPoint)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_PendingSemaphores.push_back({ semaphore, VK_NULL_HANDLE, completionPoint });
+		semaphore = VK_NULL_HANDLE;
+	}
+
+	bool SemaphorePool::Recycle(VkDevice logicalDevice)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return RecycleCompletedSemaphores(logicalDevice);
+	}
+
+	void SemaphorePool::Destroy(VkDevice logicalDevice)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (auto &semaphore : m_FreeSemaphores)
+		{
+			DestroySemaphore(logicalDevice, semaphore);
+		}
+		for (auto &pendingSemaphore : m_PendingSemaphores)
+		{
+			DestroySemaphore(logicalDevice, pendingSemaphore.m_Semaphore);
+		}
+		m_FreeSemaphores.clear();
+		m_PendingSemaphores.clear();
+		m_CreatedCount = 0;
+		m_InUseCount = 0;
+	}
+
+	SyncObjectPoolStatistics SemaphorePool::GetStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return { m_CreatedCount, m_InUseCount, m_HighWaterMark };
+	}
+
+	bool SemaphorePool::RecycleCompletedSemaphores(VkDevice logicalDevice)
+	{
+		for (size_t i = 0; i < m_PendingSemaphores.size();)
+		{
+			PendingSemaphore const &pendingSemaphore = m_PendingSemaphores[i];
+
+			bool completed;
+			VkResult result;
+			if (VK_NULL_HANDLE != pendingSemaphore.m_CompletionFence)
+			{
+				result = vkGetFenceStatus(logicalDevice, pendingSemaphore.m_CompletionFence);
+				completed = (VK_SUCCESS == result);
+				result = (VK_NOT_READY == result) ? VK_SUCCESS : result;
+			}
+			else
+			{
+				uint64_t reachedValue = 0;
+				result = vkGetSemaphoreCounterValueKHR(logicalDevice, pendingSemaphore.m_CompletionPoint.m_Semaphore, &reachedValue);
+				completed = (VK_SUCCESS == result) && (reachedValue >= pendingSemaphore.m_CompletionPoint.m_Value);
+			}
+
+			if (VK_SUCCESS != result)
+			{
+				std::cout << "Could not recycle a semaphore." << std::endl;
+				return false;
+			}
+			if (!completed)
+			{
+				++i;
+				continue;
+			}
+
+			m_FreeSemaphores.push_back(pendingSemaphore.m_Semaphore);
+			m_PendingSemaphores[i] = m_PendingSemaphores.back();
+			m_PendingSemaphores.pop_back();
+			--m_InUseCount;
+		}
+		return true;
+	}
+
+	void SetFencePool(VkDevice logicalDevice, FencePool *pool)
+	{
+		FencePools.Set(logicalDevice, pool);
+	}
+
+	FencePool * GetFencePool(VkDevice logicalDevice)
+	{
+		return FencePools.Get(logicalDevice);
+	}
+
+	void SetSemaphorePool(VkDevice logicalDevice, SemaphorePool *pool)
+	{
+		SemaphorePools.Set(logicalDevice, pool);
+	}
+
+	SemaphorePool * GetSemaphorePool(VkDevice logicalDevice)
+	{
+		return SemaphorePools.Get(logicalDevice);
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <mutex>
+#include "../CommonFiles/Common.h"
+#include "QueueTimeline.h"
+#include "DeviceRegistry.h"
+
+namespace VulkanSampleFramework
+{
+	struct SyncObjectPoolStatistics
+	{
+		uint32_t	m_CreatedCount;			// Objects owned by the pool, in use or not
+		uint32_t	m_InUseCount;			// Acquired and not yet returned, including those waiting for their work to complete
+		uint32_t	m_HighWaterMark;		// Most objects in use at the same time
+	};
+
+	// Hands out unsignaled fences and takes them back either directly or after they get signaled, so in a steady state submissions
+	// don't create any fences. Fences returned before they are signaled are checked and reset when the next one is acquired.
+	class FencePool
+	{
+	public:
+		bool AcquireFence(VkDevice logicalDevice, VkFence &fence);
+		// The fence must be signaled or not submitted at all
+		bool ReleaseFence(VkDevice logicalDevice, VkFence &fence);
+		// For fences whose work may still be executing, e.g. after a wait timed out
+		void ReleaseFenceWhenSignaled(VkFence &fence);
+		bool Recycle(VkDevice logicalDevice);
+		// Device must be idle
+		void Destroy(VkDevice logicalDevice);
+
+		SyncObjectPoolStatistics GetStatistics() const;
+
+		FencePool();
+
+	private:
+		bool RecycleSignaledFences(VkDevice logicalDevice);
+
+		std::vector<VkFence>	m_FreeFences;
+		std::vector<VkFence>	m_PendingFences;
+		uint32_t				m_CreatedCount;
+		uint32_t				m_InUseCount;
+		uint32_t				m_HighWaterMark;
+		mutable std::mutex		m_Mutex;
+	};
+
+	// Hands out binary semaphores and takes them back when nothing waits on them anymore. Binary semaphores can't be reset, so a semaphore
+	// may be reused only after the wait operation consuming its signal completed, which is known directly or from a fence or timeline point
+	// guarding the submission that waited on it.
+	class SemaphorePool
+	{
+	public:
+		bool AcquireSemaphore(VkDevice logicalDevice, VkSemaphore &semaphore);
+		// The semaphore must be unsignaled with no pending operations
+		void ReleaseSemaphore(VkSemaphore &semaphore);
+		// The fence must not be reset or destroyed before the semaphore is recycled
+		void ReleaseSemaphoreWhenSignaled(VkSemaphore &semaphore, VkFence completionFence);
+		void ReleaseSemaphoreWhenReached(VkSemaphore &semaphore, TimelinePoint const &completionPoint);
+		bool Recycle(VkDevice logicalDevice);
+		// Device must be idle
+		void Destroy(VkDevice logicalDevice);
+
+		SyncObjectPoolStatistics GetStatistics() const;
+
+		SemaphorePool();
+
+	private:
+		struct PendingSemaphore
+		{
+			VkSemaphore		m_Semaphore;
+			VkFence			m_CompletionFence;		// Or a timeline point when it's null
+			TimelinePoint	m_CompletionPoint;
+		};
+
+		bool RecycleCompletedSemaphores(VkDevice logicalDevice);
+
+		std::vector<VkSemaphore>		m_FreeSemaphores;
+		std::vector<PendingSemaphore>	m_PendingSemaphores;
+		uint32_t						m_CreatedCount;
+		uint32_t						m_InUseCount;
+		uint32_t						m_HighWaterMark;
+		mutable std::mutex				m_Mutex;
+	};
+
+	// Pools used by frame resources and the helper functions submitting work on the device, none by default
+	void SetFencePool(VkDevice logicalDevice, FencePool *pool);
+	FencePool * GetFencePool(VkDevice logicalDevice);
+	void SetSemaphorePool(VkDevice logicalDevice, SemaphorePool *pool);
+	SemaphorePool * GetSemaphorePool(VkDevice logicalDevice);
+}
@@ -0,0 +1,607 @@
+#include <algorithm>
+#include "TextureStreamer.h"
+#include "CommandBufferAndSyncFunctions.h"
+#include "DeferredDestructionQueue.h"
+#include "DescriptorSetsFunctions.h"
+#include "QueueTimeline.h"
+#include "ResourcesAndMemoryFunctions.h"
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		VkExtent3D GetLevelSize(VkExtent3D const &size, uint32_t level)
+		{
+			uint32_t width = size.width >> level;
+			uint32_t height = size.height >> level;
+			uint32_t depth = size.depth >> level;
+			return { width > 0 ? width : 1, height > 0 ? height : 1, depth > 0 ? depth : 1 };
+		}
+	}
+
+	uint32_t CalculateRequiredMipLevel(VkExtent3D textureSize, uint32_t mipmapsCount, float projectedWidth, float projectedHeight)
+	{
+		if ((projectedWidth <= 0.0f) || (projectedHeight <= 0.0f))
+		{
+			return mipmapsCount - 1;
+		}
+
+		float widthRatio = textureSize.width / projectedWidth;
+		float heightRatio = textureSize.height / projectedHeight;
+		float ratio = widthRatio > heightRatio ? widthRatio : heightRatio;
+		if (ratio <= 1.0f)
+		{
+			return 0;
+		}
+
+		uint32_t mipLevel = static_cast<uint32_t>(std::floor(std::log2(ratio)));
+		return mipLevel < mipmapsCount ? mipLevel : mipmapsCount - 1;
+	}
+
+	TextureStreamer::TextureStreamer() :
+		m_PhysicalDevice(VK_NULL_HANDLE),
+		m_PhysicalDeviceMemoryProperties(),
+		m_MemoryBudget(0),
+		m_ResidentMemorySize(0),
+		m_FrameIndex(0),
+		m_MemoryBudgetTracker(nullptr),
+		m_EvictionCallbackId(0),
+		m_RequestedEvictionSize(0),
+		m_Stopping(false)
+	{
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+	}
+
+	bool TextureStreamer::Initialize(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties,
+		VkDeviceSize memoryBudget, uint32_t loadingThreadsCount)
+	{
+		// Without the queue replaced images would be destroyed while recorded commands still copy from them
+		if (nullptr == GetDeferredDestructionQueue(logicalDevice))
+		{
+			std::cout << "Could not initialize texture streaming, no deferred destruction queue is registered for the device." << std::endl;
+			return false;
+		}
+
+		m_PhysicalDevice = physicalDevice;
+		m_PhysicalDeviceMemoryProperties = physicalDeviceMemoryProperties;
+		m_MemoryBudget = memoryBudget;
+		m_RequestedEvictionSize = 0;
+		m_Stopping = false;
+
+		m_MemoryBudgetTracker = GetMemoryBudgetTracker(logicalDevice);
+		if (nullptr != m_MemoryBudgetTracker)
+		{
+			m_EvictionCallbackId = m_MemoryBudgetTracker->RegisterEvictionCallback(
+				[this](uint32_t heapIndex, VkDeviceSize requiredSize) { return RequestEviction(heapIndex, requiredSize); });
+		}
+
+		loadingThreadsCount = loadingThreadsCount > 0 ? loadingThreadsCount : 1;
+		for (uint32_t i = 0; i < loadingThreadsCount; ++i)
+		{
+			m_LoadingThreads.emplace_back(&TextureStreamer::LoadLevels, this);
+		}
+		return true;
+	}
+
+	void TextureStreamer::Destroy(VkDevice logicalDevice)
+	{
+		if (nullptr != m_MemoryBudgetTracker)
+		{
+			m_MemoryBudgetTracker->UnregisterEvictionCallback(m_EvictionCallbackId);
+			m_MemoryBudgetTracker = nullptr;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stopping = true;
+		}
+		m_LoadRequested.notify_all();
+		for (auto &thread : m_LoadingThreads)
+		{
+			thread.join();
+		}
+		m_LoadingThreads.clear();
+		m_LoadRequests.clear();
+		m_LoadedLevels.clear();
+
+		for (auto &texture : m_Textures)
+		{
+			DestroyImageView(logicalDevice, texture.m_ImageView);
+			DestroyImage(logicalDevice, texture.m_Image);
+			FreeMemoryObject(logicalDevice, texture.m_Memory);
+		}
+		m_Textures.clear();
+		m_ResidentMemorySize = 0;
+	}
+
+	bool TextureStreamer::AddTexture(VkDevice logicalDevice, char const *filename, uint32_t residentTailMipmapsCount, VkQueue queue,
+		VkCommandBuffer commandBuffer, uint32_t &textureIndex)
+	{
+		// Whole file is read once, as the number of levels is not known before
+		CompressedTexture data;
+		if (!LoadCompressedTextureFromFile(filename, data))
+		{
+			return false;
+		}
+		if (!IsCompressedTextureFormatSupported(m_PhysicalDevice, data.m_Format, true))
+		{
+			std::cout << "Could not stream texture, its format is not supported for a sampled image." << std::endl;
+			return false;
+		}
+
+		residentTailMipmapsCount = residentTailMipmapsCount > 0 ? residentTailMipmapsCount : 1;
+		uint32_t tailMipLevel = data.m_MipmapsCount > residentTailMipmapsCount ? data.m_MipmapsCount - residentTailMipmapsCount : 0;
+
+		StreamedTexture texture =
+		{
+			filename,
+			data.m_Format,
+			data.m_Size,
+			data.m_MipmapsCount,
+			data.m_LayersCount,
+			data.m_Cubemap,
+			tailMipLevel,
+			data.m_MipmapsCount,	// Nothing is resident yet
+			tailMipLevel,
+			m_FrameIndex,
+			false,
+			m_FrameIndex,
+			VK_NULL_HANDLE,
+			VK_NULL_HANDLE,
+			VK_NULL_HANDLE,
+			0,
+			{}
+		};
+		if (!QueryResidencyMemorySizes(logicalDevice, texture))
+		{
+			return false;
+		}
+
+		if (!BeginCommandBufferRecordingOperation(commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr))
+		{
+			return false;
+		}
+
+		if (!ChangeResidency(logicalDevice, commandBuffer, texture, tailMipLevel, &data))
+		{
+			EndCommandBufferRecordingOperation(commandBuffer);
+			return false;
+		}
+
+		if (!EndCommandBufferRecordingOperation(commandBuffer))
+		{
+			return false;
+		}
+
+		if (!SubmitCommandBuffersAndWait(logicalDevice, queue, { commandBuffer }, {}, 500000000))
+		{
+			// Upload may still be executed after a timeout, so the image isn't destroyed immediately
+			VkImage image = texture.m_Image;
+			VkDeviceMemory memory = texture.m_Memory;
+			VkImageView imageView = texture.m_ImageView;
+			DestroyWhenUnused(logicalDevice, [image, memory, imageView](VkDevice device) mutable
+			{
+				DestroyImageView(device, imageView);
+				DestroyImage(device, image);
+				FreeMemoryObject(device, memory);
+			});
+			m_ResidentMemorySize -= texture.m_MemorySize;
+			return false;
+		}
+
+		m_Textures.push_back(texture);
+		textureIndex = static_cast<uint32_t>(m_Textures.size() - 1);
+		return true;
+	}
+
+	void TextureStreamer::RequestMipLevel(uint32_t textureIndex, uint32_t mipLevel)
+	{
+		StreamedTexture &texture = m_Textures[textureIndex];
+		mipLevel = mipLevel < texture.m_TailMipLevel ? mipLevel : texture.m_TailMipLevel;
+
+		if ((texture.m_LastUsedFrame != m_FrameIndex) || (mipLevel < texture.m_RequestedMipLevel))
+		{
+			texture.m_RequestedMipLevel = mipLevel;
+		}
+		texture.m_LastUsedFrame = m_FrameIndex;
+	}
+
+	bool TextureStreamer::Update(VkDevice logicalDevice, VkCommandBuffer commandBuffer, std::vector<uint32_t> &updatedTextures)
+	{
+		updatedTextures.clear();
+
+		// Number of uploads per frame is limited, so streaming doesn't cause frame time spikes
+		std::vector<LoadedLevels> loadedLevels;
+		VkDeviceSize requestedEvictionSize;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			requestedEvictionSize = m_RequestedEvictionSize;
+			m_RequestedEvictionSize = 0;
+			while (!m_LoadedLevels.empty() && (loadedLevels.size() < MaxResidencyChangesPerUpdate))
+			{
+				loadedLevels.push_back(std::move(m_LoadedLevels.front()));
+				m_LoadedLevels.pop_front();
+			}
+		}
+
+		// Other allocations would exceed the budget of the heap, so levels not needed in this frame are dropped and no new ones are loaded for a while
+		if (requestedEvictionSize > 0)
+		{
+			// No texture is excluded
+			if (!EvictLeastRecentlyUsedLevels(logicalDevice, commandBuffer, requestedEvictionSize, static_cast<uint32_t>(m_Textures.size()), true, updatedTextures))
+			{
+				return false;
+			}
+			for (auto &texture : m_Textures)
+			{
+				texture.m_NextLoadFrame = m_FrameIndex + LoadRetryDelayInFrames;
+			}
+		}
+
+		for (auto &loaded : loadedLevels)
+		{
+			StreamedTexture &texture = m_Textures[loaded.m_TextureIndex];
+			texture.m_Loading = false;
+			// Failed loads are requested again later, the file may e.g. be temporarily locked
+			if (!loaded.m_Loaded || loaded.m_Data.m_Subresources.empty())
+			{
+				std::cout << "Could not load mip levels of the '" << texture.m_Filename << "' streamed texture." << std::endl;
+				texture.m_NextLoadFrame = m_FrameIndex + LoadRetryDelayInFrames;
+				continue;
+			}
+
+			// Levels between the loaded and the resident ones may have been evicted during loading, they are requested again then
+			if (loaded.m_MipLevel + loaded.m_MipLevelsCount < texture.m_ResidentMipLevel)
+			{
+				continue;
+			}
+
+			// Request may have changed during loading
+			uint32_t newResidentMipLevel = loaded.m_MipLevel > texture.m_RequestedMipLevel ? loaded.m_MipLevel : texture.m_RequestedMipLevel;
+			if (newResidentMipLevel >= texture.m_ResidentMipLevel)
+			{
+				continue;
+			}
+
+			VkDeviceSize requiredMemorySize = m_ResidentMemorySize + texture.m_ResidencyMemorySizes[newResidentMipLevel] - texture.m_MemorySize;
+			if ((requiredMemorySize > m_MemoryBudget) &&
+				!EvictLeastRecentlyUsedLevels(logicalDevice, commandBuffer, requiredMemorySize - m_MemoryBudget, loaded.m_TextureIndex, false, updatedTextures))
+			{
+				texture.m_NextLoadFrame = m_FrameIndex + LoadRetryDelayInFrames;
+				continue;
+			}
+
+			if (!ChangeResidency(logicalDevice, commandBuffer, texture, newResidentMipLevel, &loaded.m_Data))
+			{
+				return false;
+			}
+			updatedTextures.push_back(loaded.m_TextureIndex);
+		}
+
+		// Levels are loaded only for textures used in the current frame, which could fit into the budget
+		bool loadRequested = false;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (uint32_t i = 0; i < static_cast<uint32_t>(m_Textures.size()); ++i)
+			{
+				StreamedTexture &texture = m_Textures[i];
+				if (texture.m_Loading || (texture.m_LastUsedFrame != m_FrameIndex) || (texture.m_NextLoadFrame > m_FrameIndex) || (texture.m_RequestedMipLevel >= texture.m_ResidentMipLevel) ||
+					(texture.m_ResidencyMemorySizes[texture.m_RequestedMipLevel] > m_MemoryBudget))
+				{
+					continue;
+				}
+
+				m_LoadRequests.push_back({ i, texture.m_RequestedMipLevel, texture.m_ResidentMipLevel - texture.m_RequestedMipLevel, texture.m_Filename });
+				texture.m_Loading = true;
+				loadRequested = true;
+			}
+		}
+		if (loadRequested)
+		{
+			m_LoadRequested.notify_all();
+		}
+
+		++m_FrameIndex;
+		return true;
+	}
+
+	VkExtent3D TextureStreamer::GetSize(uint32_t textureIndex) const
+	{
+		return m_Textures[textureIndex].m_Size;
+	}
+
+	uint32_t TextureStreamer::GetMipmapsCount(uint32_t textureIndex) const
+	{
+		return m_Textures[textureIndex].m_MipmapsCount;
+	}
+
+	VkImageView TextureStreamer::GetImageView(uint32_t textureIndex) const
+	{
+		return m_Textures[textureIndex].m_ImageView;
+	}
+
+	uint32_t TextureStreamer::GetResidentMipLevel(uint32_t textureIndex) const
+	{
+		return m_Textures[textureIndex].m_ResidentMipLevel;
+	}
+
+	VkDeviceSize TextureStreamer::GetResidentMemorySize() const
+	{
+		return m_ResidentMemorySize;
+	}
+
+	void TextureStreamer::LoadLevels()
+	{
+		while (true)
+		{
+			LoadRequest request;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_LoadRequested.wait(lock, [this]() { return m_Stopping || !m_LoadRequests.empty(); });
+				if (m_Stopping)
+				{
+					return;
+				}
+				request = std::move(m_LoadRequests.front());
+				m_LoadRequests.pop_front();
+			}
+
+			LoadedLevels loaded;
+			loaded.m_TextureIndex = request.m_TextureIndex;
+			loaded.m_MipLevel = request.m_MipLevel;
+			loaded.m_MipLevelsCount = request.m_MipLevelsCount;
+			loaded.m_Loaded = LoadCompressedTextureFromFile(request.m_Filename.c_str(), loaded.m_Data, request.m_MipLevel, request.m_MipLevelsCount);
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_LoadedLevels.push_back(std::move(loaded));
+		}
+	}
+
+	bool TextureStreamer::CreateResidentImage(VkDevice logicalDevice, StreamedTexture const &texture, uint32_t firstMipLevel, VkImage &image) const
+	{
+		return CreateImage(logicalDevice, texture.m_Size.depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D, texture.m_Format, GetLevelSize(texture.m_Size, firstMipLevel),
+			texture.m_MipmapsCount - firstMipLevel, texture.m_LayersCount, VK_SAMPLE_COUNT_1_BIT,
+			VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, texture.m_Cubemap, image);
+	}
+
+	bool TextureStreamer::QueryResidencyMemorySizes(VkDevice logicalDevice, StreamedTexture &texture) const
+	{
+		// Images created with the same parameters have the same memory requirements, so images never bound to memory are enough
+		texture.m_ResidencyMemorySizes.assign(texture.m_MipmapsCount + 1, 0);
+		for (uint32_t level = 0; level < texture.m_MipmapsCount; ++level)
+		{
+			VkImage image = VK_NULL_HANDLE;
+			if (!CreateResidentImage(logicalDevice, texture, level, image))
+			{
+				return false;
+			}
+
+			VkMemoryRequirements memoryRequirements;
+			vkGetImageMemoryRequirements(logicalDevice, image, &memoryRequirements);
+			texture.m_ResidencyMemorySizes[level] = memoryRequirements.size;
+			DestroyImage(logicalDevice, image);
+		}
+		return true;
+	}
+
+	VkDeviceSize TextureStreamer::RequestEviction(uint32_t heapIndex, VkDeviceSize requiredSize)
+	{
+		// Streamed images are allocated from device local memory
+		if (0 == (m_PhysicalDeviceMemoryProperties.memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+		{
+			return 0;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_RequestedEvictionSize = requiredSize > m_RequestedEvictionSize ? requiredSize : m_RequestedEvictionSize;
+
+		// Levels are evicted by commands recorded in the next update and their images are destroyed after frames in flight finish
+		return 0;
+	}
+
+	bool TextureStreamer::EvictLeastRecentlyUsedLevels(VkDevice logicalDevice, VkCommandBuffer commandBuffer, VkDeviceSize requiredMemorySize,
+		uint32_t excludedTexture, bool partialEviction, std::vector<uint32_t> &updatedTextures)
+	{
+		// Textures used in the current frame are never evicted
+		std::vector<uint32_t> candidates;
+		VkDeviceSize evictableMemorySize = 0;
+		for (uint32_t i = 0; i < static_cast<uint32_t>(m_Textures.size()); ++i)
+		{
+			StreamedTexture const &texture = m_Textures[i];
+			if ((i != excludedTexture) && (texture.m_LastUsedFrame != m_FrameIndex) && (texture.m_ResidentMipLevel < texture.m_TailMipLevel))
+			{
+				candidates.push_back(i);
+				evictableMemorySize += texture.m_MemorySize - texture.m_ResidencyMemorySizes[texture.m_TailMipLevel];
+			}
+		}
+		if (evictableMemorySize < requiredMemorySize)
+		{
+			if (!partialEviction)
+			{
+				return false;
+			}
+			requiredMemorySize = evictableMemorySize;
+		}
+
+		std::sort(candidates.begin(), candidates.end(),
+			[this](uint32_t left, uint32_t right) { return m_Textures[left].m_LastUsedFrame < m_Textures[right].m_LastUsedFrame; });
+
+		// Levels are dropped one by one, starting from the most detailed ones, until enough memory is freed
+		VkDeviceSize evictedMemorySize = 0;
+		for (auto candidate : candidates)
+		{
+			StreamedTexture &texture = m_Textures[candidate];
+
+			uint32_t newResidentMipLevel = texture.m_ResidentMipLevel;
+			VkDeviceSize freedMemorySize = 0;
+			while ((newResidentMipLevel < texture.m_TailMipLevel) && (evictedMemorySize + freedMemorySize < requiredMemorySize))
+			{
+				++newResidentMipLevel;
+				freedMemorySize = texture.m_MemorySize - texture.m_ResidencyMemorySizes[newResidentMipLevel];
+			}
+
+			if (!ChangeResidency(logicalDevice, commandBuffer, texture, newResidentMipLevel, nullptr))
+			{
+				return false;
+			}
+			updatedTextures.push_back(candidate);
+
+			evictedMemorySize += freedMemorySize;
+			if (evictedMemorySize >= requiredMemorySize)
+			{
+				break;
+			}
+		}
+		return true;
+	}
+
+	bool TextureStreamer::ChangeResidency(VkDevice logicalDevice, VkCommandBuffer commandBuffer, StreamedTexture &texture, uint32_t newResidentMipLevel,
+		CompressedTexture const *loadedLevels)
+	{
+		if (newResidentMipLevel == texture.m_ResidentMipLevel)
+		{
+			return true;
+		}
+
+		VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D;
+		if (texture.m_Size.depth > 1)
+		{
+			viewType = VK_IMAGE_VIEW_TYPE_3D;
+		}
+		else if (texture.m_Cubemap)
+		{
+			viewType = texture.m_LayersCount > 6 ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE;
+		}
+		else if (texture.m_LayersCount > 1)
+		{
+			viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+		}
+
+		// New image
+		VkImage image = VK_NULL_HANDLE;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkImageView imageView = VK_NULL_HANDLE;
+		if (!CreateResidentImage(logicalDevice, texture, newResidentMipLevel, image))
+		{
+			return false;
+		}
+		if (!AllocateAndBindMemoryObjectToImage(logicalDevice, image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_PhysicalDeviceMemoryProperties, memory) ||
+			!CreateImageView(logicalDevice, image, viewType, texture.m_Format, VK_IMAGE_ASPECT_COLOR_BIT, imageView))
+		{
+			DestroyImage(logicalDevice, image);
+			FreeMemoryObject(logicalDevice, memory);
+			return false;
+		}
+
+		VkMemoryRequirements memoryRequirements;
+		vkGetImageMemoryRequirements(logicalDevice, image, &memoryRequirements);
+
+		SetImageMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			{ { image, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_QUEUE_FAMILY_IGNORED,
+			VK_QUEUE_FAMILY_IGNORED, VK_IMAGE_ASPECT_COLOR_BIT } });
+
+		// Levels resident in both images are copied on the GPU
+		if (VK_NULL_HANDLE != texture.m_Image)
+		{
+			SetImageMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+				{ { texture.m_Image, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, VK_IMAGE_ASPECT_COLOR_BIT } });
+
+			std::vector<VkImageCopy> regions;
+			uint32_t firstCopiedLevel = newResidentMipLevel > texture.m_ResidentMipLevel ? newResidentMipLevel : texture.m_ResidentMipLevel;
+			for (uint32_t level = firstCopiedLevel; level < texture.m_MipmapsCount; ++level)
+			{
+				regions.push_back(
+					{
+						{ VK_IMAGE_ASPECT_COLOR_BIT, level - texture.m_ResidentMipLevel, 0, texture.m_LayersCount },	// VkImageSubresourceLayers   srcSubresource
+						{ 0, 0, 0 },																				// VkOffset3D                 srcOffset
+						{ VK_IMAGE_ASPECT_COLOR_BIT, level - newResidentMipLevel, 0, texture.m_LayersCount },		// VkImageSubresourceLayers   dstSubresource
+						{ 0, 0, 0 },																				// VkOffset3D                 dstOffset
+						GetLevelSize(texture.m_Size, level)															// VkExtent3D                 extent
+					});
+			}
+			vkCmdCopyImage(commandBuffer, texture.m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				static_cast<uint32_t>(regions.size()), regions.data());
+		}
+
+		// Remaining levels are uploaded from the loaded data, the staging buffer holds only their subresources
+		VkBuffer stagingBuffer = VK_NULL_HANDLE;
+		VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+		if (newResidentMipLevel < texture.m_ResidentMipLevel)
+		{
+			std::vector<VkBufferImageCopy> loadedRegions;
+			SpecifyCompressedTextureCopyRegions(*loadedLevels, loadedRegions);
+
+			// Subresource sizes are multiples of the block size, so packed offsets stay aligned
+			std::vector<VkBufferImageCopy> regions;
+			std::vector<unsigned char> stagingData;
+			for (size_t i = 0; i < loadedRegions.size(); ++i)
+			{
+				VkBufferImageCopy region = loadedRegions[i];
+				CompressedTexture::Subresource const &subresource = loadedLevels->m_Subresources[i];
+				if ((subresource.m_MipLevel >= newResidentMipLevel) && (subresource.m_MipLevel < texture.m_ResidentMipLevel))
+				{
+					region.bufferOffset = stagingData.size();
+					region.imageSubresource.mipLevel -= newResidentMipLevel;
+					regions.push_back(region);
+
+					auto subresourceData = loadedLevels->m_Data.begin() + static_cast<size_t>(subresource.m_DataOffset);
+					stagingData.insert(stagingData.end(), subresourceData, subresourceData + static_cast<size_t>(subresource.m_DataSize));
+				}
+			}
+
+			if (regions.empty())
+			{
+				std::cout << "Could not change texture residency, loaded data doesn't contain the uploaded levels." << std::endl;
+				DestroyImageView(logicalDevice, imageView);
+				DestroyImage(logicalDevice, image);
+				FreeMemoryObject(logicalDevice, memory);
+				return false;
+			}
+
+			if (!CreateBuffer(logicalDevice, stagingData.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, stagingBuffer) ||
+				!AllocateAndBindMemoryObjectToBuffer(logicalDevice, stagingBuffer,
+					static_cast<VkMemoryPropertyFlagBits>(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+					m_PhysicalDeviceMemoryProperties, stagingMemory) ||
+				!MapUpdateAndUnmapHostVisibleMemory(logicalDevice, stagingMemory, 0, stagingData.size(), stagingData.data(), true, nullptr))
+			{
+				DestroyBuffer(logicalDevice, stagingBuffer);
+				FreeMemoryObject(logicalDevice, stagingMemory);
+				DestroyImageView(logicalDevice, imageView);
+				DestroyImage(logicalDevice, image);
+				FreeMemoryObject(logicalDevice, memory);
+				return false;
+			}
+
+			CopyDataFromBufferToImage(commandBuffer, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions);
+		}
+
+		SetImageMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			{ { image, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, VK_IMAGE_ASPECT_COLOR_BIT } });
+
+		// Old image may still be used by frames in flight, and both it and the staging buffer by the commands being recorded
+		VkImage oldImage = texture.m_Image;
+		VkDeviceMemory oldMemory = texture.m_Memory;
+		VkImageView oldImageView = texture.m_ImageView;
+		DestroyWhenUnused(logicalDevice, [oldImage, oldMemory, oldImageView, stagingBuffer, stagingMemory](VkDevice device) mutable
+		{
+			DestroyImageView(device, oldImageView);
+			DestroyImage(device, oldImage);
+			FreeMemoryObject(device, oldMemory);
+			DestroyBuffer(device, stagingBuffer);
+			FreeMemoryObject(device, stagingMemory);
+		});
+
+		m_ResidentMemorySize = m_ResidentMemorySize + memoryRequirements.size - texture.m_MemorySize;
+		texture.m_Image = image;
+		texture.m_Memory = memory;
+		texture.m_ImageView = imageView;
+		texture.m_MemorySize = memoryRequirements.size;
+		texture.m_ResidentMipLevel = newResidentMipLevel;
+		return true;
+	}
+}
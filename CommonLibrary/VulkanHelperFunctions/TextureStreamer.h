@@ -0,0 +1,122 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "../CommonFiles/Common.h"
+#include "../CommonFiles/TextureContainers.h"
+#include "MemoryBudget.h"
+
+namespace VulkanSampleFramework
+{
+	// Most detailed level needed to draw a texture covering the given area of the screen (in pixels) without minification aliasing
+	uint32_t CalculateRequiredMipLevel(VkExtent3D textureSize, uint32_t mipmapsCount, float projectedWidth, float projectedHeight);
+
+	// Keeps only the mip levels which are needed by the renderer resident, under a memory budget. Least detailed levels of each
+	// texture are uploaded when it is added and stay resident, more detailed ones are loaded from files (KTX2 or DDS) by background
+	// threads once they are requested. When the budget would be exceeded, most detailed levels of the least recently used textures
+	// are evicted. Residency changes create a new image with the resident levels, copy the kept ones from the old image and upload
+	// the loaded ones, all recorded into the command buffer of the current frame. Old images and staging buffers are destroyed through
+	// DestroyWhenUnused() once the frames which could have used them are finished, so callers only have to update their descriptors with
+	// the new views. This requires a deferred destruction queue registered for the device, like the one of the framework.
+	// When a memory budget tracker is registered for the device, allocations which would exceed the budget of a device local heap
+	// make the next update evict levels of the least recently used textures and postpone loading of more detailed ones.
+	class TextureStreamer
+	{
+	public:
+		bool Initialize(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties,
+			VkDeviceSize memoryBudget, uint32_t loadingThreadsCount);
+		void Destroy(VkDevice logicalDevice);
+
+		// Uploads the given number of least detailed levels, command buffer is recorded and submitted by this call
+		bool AddTexture(VkDevice logicalDevice, char const *filename, uint32_t residentTailMipmapsCount, VkQueue queue, VkCommandBuffer commandBuffer,
+			uint32_t &textureIndex);
+		// Called every frame for each drawn texture (e.g. with CalculateRequiredMipLevel()), the most detailed request of a frame wins
+		void RequestMipLevel(uint32_t textureIndex, uint32_t mipLevel);
+		// Must be recorded once per frame outside of a render pass, before draws sampling the textures (in fragment shaders).
+		// Returns textures with new image views, which should be written into descriptor sets not used by frames in flight.
+		bool Update(VkDevice logicalDevice, VkCommandBuffer commandBuffer, std::vector<uint32_t> &updatedTextures);
+
+		// Size and levels count of the whole texture, e.g. for CalculateRequiredMipLevel()
+		VkExtent3D GetSize(uint32_t textureIndex) const;
+		uint32_t GetMipmapsCount(uint32_t textureIndex) const;
+		// View contains only resident levels, so its first level is the most detailed resident one
+		VkImageView GetImageView(uint32_t textureIndex) const;
+		uint32_t GetResidentMipLevel(uint32_t textureIndex) const;
+		VkDeviceSize GetResidentMemorySize() const;
+
+		TextureStreamer();
+		~TextureStreamer();
+
+	private:
+		static uint32_t const	MaxResidencyChangesPerUpdate = 4;
+		static uint32_t const	LoadRetryDelayInFrames = 60;
+
+		struct StreamedTexture
+		{
+			std::string		m_Filename;
+			VkFormat		m_Format;
+			VkExtent3D		m_Size;
+			uint32_t		m_MipmapsCount;
+			uint32_t		m_LayersCount;
+			bool			m_Cubemap;
+			uint32_t		m_TailMipLevel;			// Levels starting from this one are always resident
+			uint32_t		m_ResidentMipLevel;
+			uint32_t		m_RequestedMipLevel;
+			uint64_t		m_LastUsedFrame;
+			bool			m_Loading;
+			uint64_t		m_NextLoadFrame;		// Delays loading of levels which didn't fit into the budget or couldn't be loaded
+			VkImage			m_Image;
+			VkDeviceMemory	m_Memory;
+			VkImageView		m_ImageView;
+			VkDeviceSize	m_MemorySize;
+			// Memory required by the image when the given level is the most detailed resident one, queried from the driver so the
+			// budget is charged and released with the same sizes. The last element (no resident levels) is zero.
+			std::vector<VkDeviceSize>	m_ResidencyMemorySizes;
+		};
+
+		// Only levels which are not resident yet are loaded
+		struct LoadRequest
+		{
+			uint32_t	m_TextureIndex;
+			uint32_t	m_MipLevel;
+			uint32_t	m_MipLevelsCount;
+			std::string	m_Filename;
+		};
+
+		struct LoadedLevels
+		{
+			uint32_t			m_TextureIndex;
+			uint32_t			m_MipLevel;
+			uint32_t			m_MipLevelsCount;
+			bool				m_Loaded;
+			CompressedTexture	m_Data;
+		};
+
+		void LoadLevels();
+		VkDeviceSize RequestEviction(uint32_t heapIndex, VkDeviceSize requiredSize);
+		bool CreateResidentImage(VkDevice logicalDevice, StreamedTexture const &texture, uint32_t firstMipLevel, VkImage &image) const;
+		bool QueryResidencyMemorySizes(VkDevice logicalDevice, StreamedTexture &texture) const;
+		// Without partial eviction nothing is evicted when less than the required memory could be freed
+		bool EvictLeastRecentlyUsedLevels(VkDevice logicalDevice, VkCommandBuffer commandBuffer, VkDeviceSize requiredMemorySize, uint32_t excludedTexture,
+			bool partialEviction, std::vector<uint32_t> &updatedTextures);
+		bool ChangeResidency(VkDevice logicalDevice, VkCommandBuffer commandBuffer, StreamedTexture &texture, uint32_t newResidentMipLevel,
+			CompressedTexture const *loadedLevels);
+
+		VkPhysicalDevice					m_PhysicalDevice;
+		VkPhysicalDeviceMemoryProperties	m_PhysicalDeviceMemoryProperties;
+		VkDeviceSize						m_MemoryBudget;
+		VkDeviceSize						m_ResidentMemorySize;
+		uint64_t							m_FrameIndex;
+		std::vector<StreamedTexture>		m_Textures;
+		MemoryBudgetTracker					*m_MemoryBudgetTracker;
+		uint32_t							m_EvictionCallbackId;
+
+		std::vector<std::thread>			m_LoadingThreads;
+		std::mutex							m_Mutex;
+		std::condition_variable				m_LoadRequested;
+		std::deque<LoadRequest>				m_LoadRequests;
+		std::deque<LoadedLevels>			m_LoadedLevels;
+		VkDeviceSize						m_RequestedEvictionSize;
+		bool								m_Stopping;
+	};
+}
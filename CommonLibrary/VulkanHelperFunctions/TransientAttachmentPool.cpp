@@ -0,0 +1,301 @@
+#include <algorithm>
+#include "DeferredDestructionQueue.h"
+#include "ResourcesAndMemoryFunctions.h"
+#include "TransientAttachmentPool.h"
+
+namespace VulkanSampleFramework
+{
+	namespace
+	{
+		struct MemoryPlacement
+		{
+			uint32_t		m_Attachment;
+			VkDeviceSize	m_Offset;
+			VkDeviceSize	m_Size;
+			uint32_t		m_FirstPass;
+			uint32_t		m_LastPass;
+		};
+
+		struct MemoryBlock
+		{
+			uint32_t						m_MemoryType;
+			VkDeviceSize					m_Size;
+			std::vector<MemoryPlacement>	m_Placements;
+		};
+
+		bool AreDescriptionsEqual(AttachmentDescription const &first, AttachmentDescription const &second)
+		{
+			return (first.m_Format == second.m_Format) && (first.m_Size.width == second.m_Size.width) && (first.m_Size.height == second.m_Size.height) &&
+				(first.m_Samples == second.m_Samples) && (first.m_Usage == second.m_Usage) && (first.m_Aspect == second.m_Aspect);
+		}
+
+		// Lowest offset in the block where the attachment overlaps in memory only with attachments not alive at the same time
+		bool FindOffsetInBlock(MemoryBlock const &block, VkMemoryRequirements const &memoryRequirements, uint32_t firstPass, uint32_t lastPass,
+			VkDeviceSize &offset)
+		{
+			std::vector<VkDeviceSize> candidateOffsets = { 0 };
+			for (auto &placement : block.m_Placements)
+			{
+				VkDeviceSize end = placement.m_Offset + placement.m_Size;
+				candidateOffsets.push_back((end + memoryRequirements.alignment - 1) / memoryRequirements.alignment * memoryRequirements.alignment);
+			}
+			std::sort(candidateOffsets.begin(), candidateOffsets.end());
+
+			for (auto candidateOffset : candidateOffsets)
+			{
+				if (candidateOffset + memoryRequirements.size > block.m_Size)
+				{
+					break;
+				}
+
+				bool conflict = false;
+				for (auto &placement : block.m_Placements)
+				{
+					bool livesTogether = (firstPass <= placement.m_LastPass) && (placement.m_FirstPass <= lastPass);
+					bool sharesMemory = (candidateOffset < placement.m_Offset + placement.m_Size) && (placement.m_Offset < candidateOffset + memoryRequirements.size);
+					if (livesTogether && sharesMemory)
+					{
+						conflict = true;
+						break;
+					}
+				}
+
+				if (!conflict)
+				{
+					offset = candidateOffset;
+					return true;
+				}
+			}
+			return false;
+		}
+	}
+
+	TransientAttachmentPool::TransientAttachmentPool() :
+		m_PhysicalDeviceMemoryProperties(),
+		m_CurrentFrame(0)
+	{
+	}
+
+	bool TransientAttachmentPool::Initialize(VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties, uint32_t framesInFlightCount)
+	{
+		if (0 == framesInFlightCount)
+		{
+			std::cout << "Could not create a transient attachment pool without frames." << std::endl;
+			return false;
+		}
+
+		m_PhysicalDeviceMemoryProperties = physicalDeviceMemoryProperties;
+		m_Frames.resize(framesInFlightCount);
+		m_CurrentFrame = 0;
+		return true;
+	}
+
+	void TransientAttachmentPool::Destroy(VkDevice logicalDevice)
+	{
+		for (auto &frame : m_Frames)
+		{
+			DestroyAttachments(logicalDevice, frame);
+		}
+		m_Frames.clear();
+	}
+
+	void TransientAttachmentPool::BeginFrame(uint32_t frameIndex)
+	{
+		m_CurrentFrame = frameIndex;
+		m_Frames[frameIndex].m_RequestedAttachments.clear();
+	}
+
+	uint32_t TransientAttachmentPool::RequestAttachment(AttachmentDescription const &description, uint32_t firstPass, uint32_t lastPass)
+	{
+		std::vector<Attachment> &requestedAttachments = m_Frames[m_CurrentFrame].m_RequestedAttachments;
+		requestedAttachments.push_back({ description, firstPass, lastPass, VK_NULL_HANDLE, VK_NULL_HANDLE });
+		return static_cast<uint32_t>(requestedAttachments.size() - 1);
+	}
+
+	bool TransientAttachmentPool::EndFrame(VkDevice logicalDevice)
+	{
+		FrameAttachments &frame = m_Frames[m_CurrentFrame];
+
+		bool unchanged = frame.m_RequestedAttachments.size() == frame.m_Attachments.size();
+		for (size_t i = 0; unchanged && (i < frame.m_Attachments.size()); ++i)
+		{
+			Attachment const &requested = frame.m_RequestedAttachments[i];
+			Attachment const &current = frame.m_Attachments[i];
+			unchanged = AreDescriptionsEqual(requested.m_Description, current.m_Description) && (requested.m_FirstPass == current.m_FirstPass) &&
+				(requested.m_LastPass == current.m_LastPass);
+		}
+
+		if (unchanged)
+		{
+			return true;
+		}
+
+		DestroyAttachments(logicalDevice, frame);
+		frame.m_Attachments = frame.m_RequestedAttachments;
+		if (!CreateAttachments(logicalDevice, frame))
+		{
+			DestroyAttachments(logicalDevice, frame);
+			return false;
+		}
+		return true;
+	}
+
+	VkImage TransientAttachmentPool::GetImage(uint32_t frameIndex, uint32_t attachmentIndex) const
+	{
+		return m_Frames[frameIndex].m_Attachments[attachmentIndex].m_Image;
+	}
+
+	VkImageView TransientAttachmentPool::GetImageView(uint32_t frameIndex, uint32_t attachmentIndex) const
+	{
+		return m_Frames[frameIndex].m_Attachments[attachmentIndex].m_ImageView;
+	}
+
+	VkDeviceSize TransientAttachmentPool::GetAllocatedMemorySize() const
+	{
+		VkDeviceSize memorySize = 0;
+		for (auto &frame : m_Frames)
+		{
+			for (auto size : frame.m_MemorySizes)
+			{
+				memorySize += size;
+			}
+		}
+		return memorySize;
+	}
+
+	bool TransientAttachmentPool::CreateAttachments(VkDevice logicalDevice, FrameAttachments &frame)
+	{
+		std::vector<VkMemoryRequirements> memoryRequirements(frame.m_Attachments.size());
+		for (size_t i = 0; i < frame.m_Attachments.size(); ++i)
+		{
+			Attachment &attachment = frame.m_Attachments[i];
+			if (!CreateImage(logicalDevice, VK_IMAGE_TYPE_2D, attachment.m_Description.m_Format, { attachment.m_Description.m_Size.width,
+				attachment.m_Description.m_Size.height, 1 }, 1, 1, attachment.m_Description.m_Samples, attachment.m_Description.m_Usage, false, attachment.m_Image))
+			{
+				return false;
+			}
+			vkGetImageMemoryRequirements(logicalDevice, attachment.m_Image, &memoryRequirements[i]);
+		}
+
+		// Placing the largest attachments first lets the smaller ones fill the blocks created for them
+		std::vector<uint32_t> placementOrder(frame.m_Attachments.size());
+		for (uint32_t i = 0; i < placementOrder.size(); ++i)
+		{
+			placementOrder[i] = i;
+		}
+		std::stable_sort(placementOrder.begin(), placementOrder.end(), [&](uint32_t first, uint32_t second)
+		{
+			return memoryRequirements[first].size > memoryRequirements[second].size;
+		});
+
+		std::vector<MemoryBlock> memoryBlocks;
+		for (auto attachmentIndex : placementOrder)
+		{
+			Attachment const &attachment = frame.m_Attachments[attachmentIndex];
+			bool transient = 0 != (attachment.m_Description.m_Usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT);
+			uint32_t memoryType = SelectMemoryType(memoryRequirements[attachmentIndex], transient);
+			if (memoryType >= m_PhysicalDeviceMemoryProperties.memoryTypeCount)
+			{
+				std::cout << "Could not find sutiable memory type for an attachment." << std::endl;
+				return false;
+			}
+
+			bool placed = false;
+			for (auto &block : memoryBlocks)
+			{
+				VkDeviceSize offset;
+				if ((memoryType == block.m_MemoryType) && FindOffsetInBlock(block, memoryRequirements[attachmentIndex], attachment.m_FirstPass, attachment.m_LastPass, offset))
+				{
+					block.m_Placements.push_back({ attachmentIndex, offset, memoryRequirements[attachmentIndex].size, attachment.m_FirstPass, attachment.m_LastPass });
+					placed = true;
+					break;
+				}
+			}
+
+			if (!placed)
+			{
+				memoryBlocks.push_back({ memoryType, memoryRequirements[attachmentIndex].size, {} });
+				memoryBlocks.back().m_Placements.push_back({ attachmentIndex, 0, memoryRequirements[attachmentIndex].size, attachment.m_FirstPass, attachment.m_LastPass });
+			}
+		}
+
+		for (auto &block : memoryBlocks)
+		{
+			frame.m_MemoryObjects.emplace_back(VkDeviceMemory());
+			if (!AllocateMemoryObject(logicalDevice, block.m_Size, block.m_MemoryType, frame.m_MemoryObjects.back()))
+			{
+				frame.m_MemoryObjects.pop_back();
+				return false;
+			}
+			frame.m_MemorySizes.push_back(block.m_Size);
+
+			for (auto &placement : block.m_Placements)
+			{
+				Attachment &attachment = frame.m_Attachments[placement.m_Attachment];
+				if (!BindMemoryObjectToImage(logicalDevice, attachment.m_Image, frame.m_MemoryObjects.back(), static_cast<uint32_t>(placement.m_Offset)))
+				{
+					return false;
+				}
+
+				if (!CreateImageView(logicalDevice, attachment.m_Image, VK_IMAGE_VIEW_TYPE_2D, attachment.m_Description.m_Format,
+					attachment.m_Description.m_Aspect, attachment.m_ImageView))
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void TransientAttachmentPool::DestroyAttachments(VkDevice logicalDevice, FrameAttachments &frame)
+	{
+		// Attachments recreated at runtime may still be used by frames in flight
+		for (auto &attachment : frame.m_Attachments)
+		{
+			VkImageView imageView = attachment.m_ImageView;
+			VkImage image = attachment.m_Image;
+			DestroyWhenUnused(logicalDevice, [imageView, image](VkDevice device) mutable
+			{
+				DestroyImageView(device, imageView);
+				DestroyImage(device, image);
+			});
+		}
+		frame.m_Attachments.clear();
+
+		for (auto &memoryObject : frame.m_MemoryObjects)
+		{
+			VkDeviceMemory memory = memoryObject;
+			DestroyWhenUnused(logicalDevice, [memory](VkDevice device) mutable
+			{
+				FreeMemoryObject(device, memory);
+			});
+		}
+		frame.m_MemoryObjects.clear();
+		frame.m_MemorySizes.clear();
+	}
+
+	uint32_t TransientAttachmentPool::SelectMemoryType(VkMemoryRequirements const &memoryRequirements, bool transient) const
+	{
+		// Lazily allocated memory may never be backed by physical memory on tiled GPUs, when the attachment isn't stored
+		std::vector<VkMemoryPropertyFlags> preferredProperties;
+		if (transient)
+		{
+			preferredProperties.push_back(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+		}
+		preferredProperties.push_back(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		preferredProperties.push_back(0);
+
+		for (auto properties : preferredProperties)
+		{
+			for (uint32_t type = 0; type < m_PhysicalDeviceMemoryProperties.memoryTypeCount; ++type)
+			{
+				if ((memoryRequirements.memoryTypeBits & (1 << type)) &&
+					((m_PhysicalDeviceMemoryProperties.memoryTypes[type].propertyFlags & properties) == properties))
+				{
+					return type;
+				}
+			}
+		}
+		return m_PhysicalDeviceMemoryProperties.memoryTypeCount;
+	}
+}
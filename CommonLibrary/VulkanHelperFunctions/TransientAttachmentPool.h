@@ -0,0 +1,65 @@
+#pragma once
+#include "../CommonFiles/Common.h"
+
+namespace VulkanSampleFramework
+{
+	struct AttachmentDescription
+	{
+		VkFormat				m_Format;
+		VkExtent2D				m_Size;
+		VkSampleCountFlagBits	m_Samples;
+		VkImageUsageFlags		m_Usage;		// With VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT lazily allocated memory is preferred
+		VkImageAspectFlags		m_Aspect;
+	};
+
+	// Owns intermediate attachments (depth buffers, G-buffers, multisampled targets, ...) of each frame in flight. Attachments are requested
+	// every frame together with the range of passes using them, and those whose ranges don't overlap are placed in the same memory.
+	// Images of a frame are kept as long as the same attachments are requested for it, so in a steady state nothing is created.
+	class TransientAttachmentPool
+	{
+	public:
+		bool Initialize(VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties, uint32_t framesInFlightCount);
+		void Destroy(VkDevice logicalDevice);
+
+		// Must be called after the previous submission of the frame is finished, because its attachments may be recreated
+		void BeginFrame(uint32_t frameIndex);
+		// Returns the index of the attachment in the frame. Aliased attachments share memory, so the first pass using an attachment must
+		// treat its contents as undefined (transition it from VK_IMAGE_LAYOUT_UNDEFINED) and wait for the last pass of the previous one.
+		uint32_t RequestAttachment(AttachmentDescription const &description, uint32_t firstPass, uint32_t lastPass);
+		// Creates images for the requested attachments, unless the same ones were requested the last time this frame was prepared
+		bool EndFrame(VkDevice logicalDevice);
+
+		VkImage GetImage(uint32_t frameIndex, uint32_t attachmentIndex) const;
+		VkImageView GetImageView(uint32_t frameIndex, uint32_t attachmentIndex) const;
+		// Memory allocated for all frames, lazily allocated memory is counted with its full size
+		VkDeviceSize GetAllocatedMemorySize() const;
+
+		TransientAttachmentPool();
+
+	private:
+		struct Attachment
+		{
+			AttachmentDescription	m_Description;
+			uint32_t				m_FirstPass;
+			uint32_t				m_LastPass;
+			VkImage					m_Image;
+			VkImageView				m_ImageView;
+		};
+
+		struct FrameAttachments
+		{
+			std::vector<Attachment>			m_RequestedAttachments;
+			std::vector<Attachment>			m_Attachments;
+			std::vector<VkDeviceMemory>		m_MemoryObjects;
+			std::vector<VkDeviceSize>		m_MemorySizes;
+		};
+
+		bool CreateAttachments(VkDevice logicalDevice, FrameAttachments &frame);
+		void DestroyAttachments(VkDevice logicalDevice, FrameAttachments &frame);
+		uint32_t SelectMemoryType(VkMemoryRequirements const &memoryRequirements, bool transient) const;
+
+		VkPhysicalDeviceMemoryProperties	m_PhysicalDeviceMemoryProperties;
+		std::vector<FrameAttachments>		m_Frames;
+		uint32_t							m_CurrentFrame;
+	};
+}
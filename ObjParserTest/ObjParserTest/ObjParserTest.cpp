@@ -0,0 +1,138 @@
+// Checks that files split into chunks parsed on multiple threads give the same data regardless of whether faces use absolute or
+// negative (relative) indices and whether statements are followed by comments. Files are big enough to be split into as many chunks as there are hardware threads.
+
+#include <cstdio>
+#include <fstream>
+#include "../../CommonLibrary/CommonFiles/ObjParser.h"
+
+using namespace VulkanSampleFramework;
+
+namespace
+{
+	int const QuadsCount = 1 << 18;
+
+	enum class IndexingMode
+	{
+		Absolute,
+		Relative,
+		Mixed
+	};
+
+	// Each quad defines its own 4 vertices followed by a face using them
+	bool WriteObjFile(char const *filename, IndexingMode mode, bool inlineComments = false)
+	{
+		std::ofstream file(filename);
+		if (file.fail())
+		{
+			std::cout << "Could not create the '" << filename << "' file." << std::endl;
+			return false;
+		}
+
+		for (int quad = 0; quad < QuadsCount; ++quad)
+		{
+			if (0 == quad % 4096)
+			{
+				file << "o Part" << quad / 4096 << "\n";
+			}
+			for (int corner = 0; corner < 4; ++corner)
+			{
+				float x = static_cast<float>(quad + (corner & 1));
+				float y = static_cast<float>(corner >> 1);
+				file << "v " << x << " " << y << (inlineComments ? " 0 # corner\n" : " 0\n");
+				file << "vt " << (corner & 1) << " " << (corner >> 1) << "\n";
+				file << "vn 0 0 1\n";
+			}
+
+			// Relative faces alternate with absolute ones, so chunks start with both of them
+			bool relative = (IndexingMode::Relative == mode) || ((IndexingMode::Mixed == mode) && (quad & 1));
+			file << "f";
+			for (int corner : { 0, 1, 3, 2 })
+			{
+				int index = relative ? corner - 4 : 4 * quad + corner + 1;
+				file << " " << index << "/" << index << "/" << index;
+			}
+			file << (inlineComments ? " # quad\n" : "\n");
+		}
+		return true;
+	}
+
+	bool CompareObjData(ObjData const &expected, ObjData const &tested)
+	{
+		if ((expected.m_Positions != tested.m_Positions) ||
+			(expected.m_Normals != tested.m_Normals) ||
+			(expected.m_Texcoords != tested.m_Texcoords) ||
+			(expected.m_Indices.size() != tested.m_Indices.size()) ||
+			(expected.m_Parts.size() != tested.m_Parts.size()))
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < expected.m_Indices.size(); ++i)
+		{
+			ObjIndex const &left = expected.m_Indices[i];
+			ObjIndex const &right = tested.m_Indices[i];
+			if ((left.m_Position != right.m_Position) ||
+				(left.m_Texcoord != right.m_Texcoord) ||
+				(left.m_Normal != right.m_Normal))
+			{
+				std::cout << "Index " << i << " differs." << std::endl;
+				return false;
+			}
+		}
+
+		for (size_t i = 0; i < expected.m_Parts.size(); ++i)
+		{
+			if ((expected.m_Parts[i].m_FirstIndex != tested.m_Parts[i].m_FirstIndex) ||
+				(expected.m_Parts[i].m_IndicesCount != tested.m_Parts[i].m_IndicesCount))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+int main()
+{
+	char const *absoluteFilename = "ObjParserTest_Absolute.obj";
+	char const *testedFilename = "ObjParserTest_Tested.obj";
+
+	ObjData expected;
+	if (!WriteObjFile(absoluteFilename, IndexingMode::Absolute) ||
+		!ParseObjFile(absoluteFilename, expected))
+	{
+		return 1;
+	}
+	std::remove(absoluteFilename);
+
+	if (expected.m_Indices.size() != static_cast<size_t>(6 * QuadsCount))
+	{
+		std::cout << "Absolute indices: FAILED (" << expected.m_Indices.size() << " indices)" << std::endl;
+		return 1;
+	}
+
+	bool passed = true;
+	struct
+	{
+		char const *m_Name;
+		IndexingMode m_Mode;
+		bool m_InlineComments;
+	} const testedModes[] =
+	{
+		{ "Relative indices", IndexingMode::Relative, false },
+		{ "Mixed indices", IndexingMode::Mixed, false },
+		{ "Inline comments", IndexingMode::Absolute, true }
+	};
+	for (auto &testedMode : testedModes)
+	{
+		ObjData tested;
+		bool result = WriteObjFile(testedFilename, testedMode.m_Mode, testedMode.m_InlineComments) &&
+			ParseObjFile(testedFilename, tested) &&
+			CompareObjData(expected, tested);
+		std::remove(testedFilename);
+
+		std::cout << testedMode.m_Name << ": " << (result ? "passed" : "FAILED") << std::endl;
+		passed = passed && result;
+	}
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+// Compares the SIMD math backend with the scalar implementation previously used by the Matrix4x4 and Vector3 operators.
+// Library has to be rebuilt with a different instruction set (e.g. /arch:AVX2) to measure other backends.
+
+#include <chrono>
+#include "../../CommonLibrary/CommonFiles/BatchTransforms.h"
+
+using namespace VulkanSampleFramework;
+
+namespace
+{
+	size_t const MatricesCount = 4096;
+	size_t const PointsCount = 1 << 20;
+	int const RepetitionsCount = 64;
+
+	// Scalar version of Matrix4x4 operator*
+	void MultiplyMatricesScalar(Matrix4x4 const &left, Matrix4x4 const &right, Matrix4x4 &result)
+	{
+		for (int column = 0; column < 4; ++column)
+		{
+			for (int row = 0; row < 4; ++row)
+			{
+				result[4 * column + row] =
+					left[row] * right[4 * column] +
+					left[4 + row] * right[4 * column + 1] +
+					left[8 + row] * right[4 * column + 2] +
+					left[12 + row] * right[4 * column + 3];
+			}
+		}
+	}
+
+	void TransformPointScalar(Matrix4x4 const &matrix, Vector3 const &point, Vector3 &result)
+	{
+		for (int row = 0; row < 3; ++row)
+		{
+			result[row] = matrix[row] * point[0] + matrix[4 + row] * point[1] + matrix[8 + row] * point[2] + matrix[12 + row];
+		}
+	}
+
+	template<typename Function>
+	double MeasureMilliseconds(Function function)
+	{
+		auto begin = std::chrono::high_resolution_clock::now();
+		for (int repetition = 0; repetition < RepetitionsCount; ++repetition)
+		{
+			function();
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::milli>(end - begin).count() / RepetitionsCount;
+	}
+
+	void PrintResult(char const *name, double scalarTime, double simdTime, float checksum)
+	{
+		std::cout << name << ": scalar " << scalarTime << " ms, SIMD " << simdTime << " ms, speedup " << scalarTime / simdTime
+			<< "x (checksum " << checksum << ")" << std::endl;
+	}
+}
+
+int main()
+{
+	std::cout << "SIMD math backend: " << GetSimdMathBackendName() << std::endl;
+
+	std::vector<Matrix4x4> matrices(MatricesCount);
+	std::vector<AlignedMatrix4x4> alignedMatrices(MatricesCount);
+	for (size_t i = 0; i < MatricesCount; ++i)
+	{
+		matrices[i] = PrepareRotationMatrix(static_cast<float>(i), { 0.2f, 1.0f, 0.3f }, true);
+		matrices[i][12] = static_cast<float>(i % 7);
+		LoadMatrix(matrices[i], alignedMatrices[i]);
+	}
+	Matrix4x4 projection = PreparePerspectiveProjectionMatrix(16.0f / 9.0f, 60.0f, 0.1f, 100.0f);
+	AlignedMatrix4x4 alignedProjection;
+	LoadMatrix(projection, alignedProjection);
+
+	// Matrix multiplication
+	{
+		std::vector<Matrix4x4> scalarResults(MatricesCount);
+		std::vector<AlignedMatrix4x4> simdResults(MatricesCount);
+		double scalarTime = MeasureMilliseconds([&]()
+		{
+			for (size_t i = 1; i < MatricesCount; ++i)
+			{
+				MultiplyMatricesScalar(matrices[i - 1], matrices[i], scalarResults[i]);
+			}
+		});
+		double simdTime = MeasureMilliseconds([&]()
+		{
+			for (size_t i = 1; i < MatricesCount; ++i)
+			{
+				MultiplyMatrices(alignedMatrices[i - 1], alignedMatrices[i], simdResults[i]);
+			}
+		});
+		PrintResult("Matrix * matrix", scalarTime, simdTime, simdResults[MatricesCount - 1].m_Data[5] - scalarResults[MatricesCount - 1][5]);
+	}
+
+	// Projection * view * model
+	{
+		std::vector<Matrix4x4> scalarResults(MatricesCount);
+		std::vector<AlignedMatrix4x4> simdResults(MatricesCount);
+		double scalarTime = MeasureMilliseconds([&]()
+		{
+			Matrix4x4 intermediate;
+			for (size_t i = 1; i < MatricesCount; ++i)
+			{
+				MultiplyMatricesScalar(projection, matrices[i - 1], intermediate);
+				MultiplyMatricesScalar(intermediate, matrices[i], scalarResults[i]);
+			}
+		});
+		double simdTime = MeasureMilliseconds([&]()
+		{
+			for (size_t i = 1; i < MatricesCount; ++i)
+			{
+				MultiplyMatrices(alignedProjection, alignedMatrices[i - 1], alignedMatrices[i], simdResults[i]);
+			}
+		});
+		PrintResult("Projection * view * model", scalarTime, simdTime, simdResults[MatricesCount - 1].m_Data[10] - scalarResults[MatricesCount - 1][10]);
+	}
+
+	// Point transformation
+	{
+		std::vector<Vector3> points(PointsCount);
+		std::vector<AlignedVector3> alignedPoints(PointsCount);
+		for (size_t i = 0; i < PointsCount; ++i)
+		{
+			points[i] = { static_cast<float>(i % 13), static_cast<float>(i % 17), static_cast<float>(i % 19) };
+			alignedPoints[i] = { { points[i][0], points[i][1], points[i][2], 1.0f } };
+		}
+		std::vector<Vector3> scalarResults(PointsCount);
+		std::vector<AlignedVector3> simdResults(PointsCount);
+		double scalarTime = MeasureMilliseconds([&]()
+		{
+			for (size_t i = 0; i < PointsCount; ++i)
+			{
+				TransformPointScalar(matrices[1], points[i], scalarResults[i]);
+			}
+		});
+		double simdTime = MeasureMilliseconds([&]()
+		{
+			TransformPoints(alignedMatrices[1], alignedPoints.data(), simdResults.data(), PointsCount);
+		});
+		PrintResult("Point transformation", scalarTime, simdTime, simdResults[PointsCount - 1].m_Data[1] - scalarResults[PointsCount - 1][1]);
+	}
+
+	// Point transformation of structure of arrays streams
+	{
+		std::vector<Vector3> points(PointsCount);
+		std::vector<float> x(PointsCount), y(PointsCount), z(PointsCount);
+		for (size_t i = 0; i < PointsCount; ++i)
+		{
+			points[i] = { static_cast<float>(i % 13), static_cast<float>(i % 17), static_cast<float>(i % 19) };
+			x[i] = points[i][0];
+			y[i] = points[i][1];
+			z[i] = points[i][2];
+		}
+		std::vector<Vector3> scalarResults(PointsCount);
+		std::vector<float> resultX(PointsCount), resultY(PointsCount), resultZ(PointsCount);
+		double scalarTime = MeasureMilliseconds([&]()
+		{
+			for (size_t i = 0; i < PointsCount; ++i)
+			{
+				TransformPointScalar(matrices[1], points[i], scalarResults[i]);
+			}
+		});
+		double simdTime = MeasureMilliseconds([&]()
+		{
+			TransformPointStreams(matrices[1], { x.data(), y.data(), z.data() }, { resultX.data(), resultY.data(), resultZ.data() }, PointsCount);
+		});
+		PrintResult("Point streams transformation", scalarTime, simdTime, resultY[PointsCount - 1] - scalarResults[PointsCount - 1][1]);
+	}
+
+	// World-view-projection matrices
+	{
+		std::vector<Matrix4x4> scalarResults(MatricesCount);
+		std::vector<AlignedMatrix4x4> simdResults(MatricesCount);
+		double scalarTime = MeasureMilliseconds([&]()
+		{
+			for (size_t i = 0; i < MatricesCount; ++i)
+			{
+				MultiplyMatricesScalar(projection, matrices[i], scalarResults[i]);
+			}
+		});
+		double simdTime = MeasureMilliseconds([&]()
+		{
+			PrepareWorldViewProjectionMatrices(alignedProjection, alignedMatrices.data(), simdResults.data(), MatricesCount);
+		});
+		PrintResult("World-view-projection matrices", scalarTime, simdTime, simdResults[MatricesCount - 1].m_Data[3] - scalarResults[MatricesCount - 1][3]);
+	}
+
+	// Normalization of cross products
+	{
+		std::vector<Vector3> vectors(PointsCount);
+		std::vector<AlignedVector3> alignedVectors(PointsCount);
+		for (size_t i = 0; i < PointsCount; ++i)
+		{
+			vectors[i] = { 1.0f + static_cast<float>(i % 13), 2.0f + static_cast<float>(i % 17), 3.0f + static_cast<float>(i % 19) };
+			alignedVectors[i] = { { vectors[i][0], vectors[i][1], vectors[i][2], 0.0f } };
+		}
+		std::vector<Vector3> scalarResults(PointsCount);
+		std::vector<AlignedVector3> simdResults(PointsCount);
+		double scalarTime = MeasureMilliseconds([&]()
+		{
+			for (size_t i = 1; i < PointsCount; ++i)
+			{
+				scalarResults[i] = Normalize(Cross(vectors[i - 1], vectors[i]));
+			}
+		});
+		double simdTime = MeasureMilliseconds([&]()
+		{
+			for (size_t i = 1; i < PointsCount; ++i)
+			{
+				Cross(alignedVectors[i - 1], alignedVectors[i], simdResults[i]);
+				Normalize(simdResults[i]);
+			}
+		});
+		PrintResult("Normalize(Cross())", scalarTime, simdTime, simdResults[PointsCount - 1].m_Data[2] - scalarResults[PointsCount - 1][2]);
+	}
+
+	return 0;
+}
@@ -0,0 +1,12 @@
+#version 450
+
+layout( location = 0 ) in vec2 vertTexcoord;
+
+layout( set = 1, binding = 0 ) uniform sampler2D StreamedTexture;
+
+layout( location = 0 ) out vec4 fragColor;
+
+void main()
+{
+	fragColor = texture(StreamedTexture, vertTexcoord);
+}
\ No newline at end of file
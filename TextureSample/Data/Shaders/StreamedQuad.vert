@@ -0,0 +1,21 @@
+#version 450
+
+layout( set = 0, binding = 0) uniform uniformBuffer
+{
+	mat4 modelViewMatrix;
+	mat4 projectionMatrix;
+};
+
+layout( push_constant ) uniform QuadParameters
+{
+	float distance;
+};
+
+layout( location = 0) out vec2 vertTexcoord;
+
+// Quad is generated from vertex indices, drawn as a triangle strip and stays in front of the camera
+void main()
+{
+	vertTexcoord = vec2(gl_VertexIndex & 1, gl_VertexIndex >> 1);
+	gl_Position = projectionMatrix * vec4(vertTexcoord - 0.5f, -distance, 1.0f);
+}